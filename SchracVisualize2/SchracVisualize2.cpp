@@ -17,11 +17,14 @@
 #include "SDKmesh.h"
 #include "SDKmisc.h"
 #include "orbitaldensityrand/orbitaldensityrand.h"
+#include "orbitaldensityrand/utility/uploadplanner.h"
 #include "orbitaldensityrand/utility/utility.h"
-#include <cstdint>                                  // for std::int32_t
+#include <cstddef>                                  // for std::size_t
+#include <cstdint>                                  // for std::int32_t, std::uint32_t
+#include <filesystem>                               // for std::filesystem
 #include <format>                                   // for std::format
-#include <numeric>                                  // for std::iota
 #include <optional>                                 // for std::optional
+#include <vector>                                   // for std::vector
 #include <boost/assert.hpp>                         // for boost::assert
 #include <wrl.h>					                // for Microsoft::WRL::ComPtr
 
@@ -76,6 +79,13 @@ static std::vector<SimpleVertex>::size_type constexpr PHI_VERTEXSIZE_INIT_VALUE
 */
 static std::vector<SimpleVertex>::size_type constexpr RHO_VERTEXSIZE_INIT_VALUE = 5000000;
 
+//! A global variable (constant).
+/*!
+    頂点バッファ1個（セグメント）あたりの頂点数
+    SimpleVertexでもDirect3D 11で必ず確保できる128MBに収まり、偶数なので線分の端点が別のセグメントに分かれない
+*/
+static std::size_t constexpr SEGMENTSIZE = 1 << 22;
+
 //! A global variable (constant).
 /*!
     画面サイズ（高さ）
@@ -168,25 +178,25 @@ auto nornel = OrbitalDensityRand::Normal_Nelson_type::NORMAL;
 
 //! A global variable.
 /*!
+    点群のキャッシュ（軌道の切り替えや再起動の際に、同じ点群を生成し直さずに読み込む）
 */
-Microsoft::WRL::ComPtr<ID3D11Buffer> pCBChangesEveryFrame;
+std::shared_ptr<samplecache::SampleCache> pcache;
 
 //! A global variable.
 /*!
 */
-Microsoft::WRL::ComPtr<ID3D11Buffer> pCBNeverChanges;
+Microsoft::WRL::ComPtr<ID3D11Buffer> pCBChangesEveryFrame;
 
 //! A global variable.
 /*!
-    データオブジェクト
 */
-std::shared_ptr<getdata::GetData> pgd;
+Microsoft::WRL::ComPtr<ID3D11Buffer> pCBNeverChanges;
 
 //! A global variable.
 /*!
-    インデックスバッファ
+    データオブジェクト
 */
-Microsoft::WRL::ComPtr<ID3D11Buffer> pIndexBuffer;
+std::shared_ptr<getdata::GetData> pgd;
 
 //! A global variable.
 /*!
@@ -208,9 +218,9 @@ std::unique_ptr<CDXUTTextHelper, decltype(deleter)> pTxtHelper(nullptr, deleter)
 
 //! A global variable.
 /*!
-    頂点バッファ
+    頂点バッファ（SEGMENTSIZE個の頂点ごとのセグメント）
 */
-Microsoft::WRL::ComPtr<ID3D11Buffer> pVertexBuffer;
+std::vector<Microsoft::WRL::ComPtr<ID3D11Buffer>> pVertexBuffers;
 
 //! A global variable.
 /*!
@@ -218,12 +228,30 @@ Microsoft::WRL::ComPtr<ID3D11Buffer> pVertexBuffer;
 */
 Microsoft::WRL::ComPtr<ID3D11InputLayout> pVertexLayout;
 
+//! A global variable.
+/*!
+    頂点レイアウト（PackedVertex）
+*/
+Microsoft::WRL::ComPtr<ID3D11InputLayout> pVertexLayoutPacked;
+
 //! A global variable.
 /*!
     バーテックスシェーダー
 */
 Microsoft::WRL::ComPtr<ID3D11VertexShader> pVertexShaderBox;
 
+//! A global variable.
+/*!
+    バーテックスシェーダー（PackedVertex）
+*/
+Microsoft::WRL::ComPtr<ID3D11VertexShader> pVertexShaderPacked;
+
+//! A global variable.
+/*!
+    乱数のシード（Redrawボタンを押すたびに1増やし、新しい点群を生成する）
+*/
+auto seed = 0U;
+
 //! A global variable.
 /*!
     Device settings dialog
@@ -242,6 +270,12 @@ auto startup = true;
 */
 CDXUTDialog ui;
 
+//! A global variable.
+/*!
+    頂点バッファへの転送範囲を決めるオブジェクト
+*/
+utility::UploadPlanner uploadplanner(sizeof(SimpleVertex), SEGMENTSIZE);
+
 
 //--------------------------------------------------------------------------------------
 // UI control IDs
@@ -256,6 +290,11 @@ static auto constexpr IDC_RADIOB           = 7;
 static auto constexpr IDC_OUTPUT           = 8;
 static auto constexpr IDC_SLIDER1          = 9;
 static auto constexpr IDC_SLIDER2          = 10;
+static auto constexpr IDC_CHECKPACKED      = 11;
+static auto constexpr IDC_CHECKDIRECT      = 12;
+static auto constexpr IDC_CHECKQUASI       = 13;
+static auto constexpr IDC_CHECKTEMPERING   = 14;
+static auto constexpr IDC_CHECKMALA        = 15;
 
 //--------------------------------------------------------------------------------------
 // Forward declarations 
@@ -307,6 +346,15 @@ void RenderText(double fTime);
 */
 HRESULT RenderPoint();
 
+//! A function.
+/*!
+    生成方法のチェックボックスが押されたときに、生成方法を切り替えて他の生成方法のチェックボックスを外す
+    \param nControlID 押されたチェックボックスのID
+    \param sampler チェックボックスに対応する生成方法
+    \param checked チェックボックスがチェックされたかどうか（外されたらNORMALに戻す）
+*/
+void SelectSampler(int nControlID, OrbitalDensityRand::Normal_Nelson_type sampler, bool checked);
+
 //! A function.
 /*!
     カメラの位置をセットする
@@ -335,7 +383,16 @@ void InitApp()
     ui.Init(&dialogResourceManager);
 
     ReadData();
+
+    // キャッシュのディレクトリが作れなくても、キャッシュなしで動く
+    std::error_code ec;
+    auto const cachedir = std::filesystem::temp_directory_path(ec) / "SchracVisualize2" / "cache";
+    pcache = std::make_shared<samplecache::SampleCache>(cachedir, samplecache::SampleCache::MAXBYTES_INIT_VALUE);
+
     podr.emplace(pgd);
+    podr->Cache(pcache);
+    podr->Seed(seed);
+    podr->Speculative(true);
     SetUI();
 }
 
@@ -446,6 +503,27 @@ HRESULT CALLBACK OnD3D11CreateDevice(ID3D11Device* pd3dDevice, const DXGI_SURFAC
     // Set the input layout
     pd3dImmediateContext->IASetInputLayout(pVertexLayout.Get());
 
+    // Compile the vertex shader for PackedVertex
+    V_RETURN(DXUTCompileFromFile(L"SchracVisualize2.fx", nullptr, "VS_Packed", "vs_4_0", dwShaderFlags, 0, pVSBlob.ReleaseAndGetAddressOf()));
+
+    // Create the vertex shader for PackedVertex
+    hr = pd3dDevice->CreateVertexShader(pVSBlob->GetBufferPointer(), pVSBlob->GetBufferSize(), nullptr, pVertexShaderPacked.GetAddressOf());
+    if (FAILED(hr)) {
+        pVSBlob.Reset();
+        return hr;
+    }
+
+    // Define the input layout for PackedVertex
+    D3D11_INPUT_ELEMENT_DESC layoutpacked[] =
+    {
+        "POSITION", 0, DXGI_FORMAT_R16G16B16A16_SNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0
+    };
+
+    // Create the input layout for PackedVertex
+    hr = pd3dDevice->CreateInputLayout(layoutpacked, ARRAYSIZE(layoutpacked), pVSBlob->GetBufferPointer(),
+        pVSBlob->GetBufferSize(), pVertexLayoutPacked.GetAddressOf());
+    pVSBlob.Reset();
+
     // Compile the pixel shader
     Microsoft::WRL::ComPtr<ID3DBlob> pPSBlob;
     V_RETURN(DXUTCompileFromFile(L"SchracVisualize2.fx", nullptr, "PS", "ps_4_0", dwShaderFlags, 0, pPSBlob.GetAddressOf()));
@@ -480,10 +558,12 @@ void CALLBACK OnD3D11DestroyDevice(void* pUserContext)
     DXUTGetGlobalResourceCache().OnDestroyDevice();
 
     pVertexShaderBox.Reset();
+    pVertexShaderPacked.Reset();
     pVertexLayout.Reset();
-    pVertexBuffer.Reset();
+    pVertexLayoutPacked.Reset();
+    pVertexBuffers.clear();
+    uploadplanner.Invalidate();
     pPixelShaderBox.Reset();
-    pIndexBuffer.Reset();
     pCBNeverChanges.Reset();
     pCBChangesEveryFrame.Reset();
 }
@@ -519,7 +599,10 @@ void CALLBACK OnD3D11FrameRender(ID3D11Device* pd3dDevice, ID3D11DeviceContext*
     auto const mView = camera.GetViewMatrix();
 
     // Set the per object constant data
-    auto const mWorld = camera.GetWorldMatrix();
+    // PackedVertexの座標はRmaxで割ってあるので、その分をワールド行列に含める
+    auto const packed = static_cast<bool>(podr->Packed);
+    auto const rmax = static_cast<float>(podr->Rmax);
+    auto const mWorld = packed ? XMMatrixScaling(rmax, rmax, rmax) * camera.GetWorldMatrix() : camera.GetWorldMatrix();
 
     // Update constant buffer that changes once per frame
     D3D11_MAPPED_SUBRESOURCE MappedResource;
@@ -530,17 +613,16 @@ void CALLBACK OnD3D11FrameRender(ID3D11Device* pd3dDevice, ID3D11DeviceContext*
     XMStoreFloat4x4(&pCB->mProjection, XMMatrixTranspose(mProj));
     pd3dImmediateContext->Unmap(pCBChangesEveryFrame.Get(), 0);
 
-    // Set vertex buffer
-    UINT const stride = sizeof(SimpleVertex);
-    auto const offset = 0U;
-    pd3dImmediateContext->IASetVertexBuffers(0, 1, pVertexBuffer.GetAddressOf(), &stride, &offset);
-
-    // Set index buffer
-    pd3dImmediateContext->IASetIndexBuffer(pIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+    // Set the input layout
+    pd3dImmediateContext->IASetInputLayout(packed ? pVertexLayoutPacked.Get() : pVertexLayout.Get());
 
     switch (nornel)
     {
     case OrbitalDensityRand::Normal_Nelson_type::NORMAL:
+    case OrbitalDensityRand::Normal_Nelson_type::DIRECT:
+    case OrbitalDensityRand::Normal_Nelson_type::QUASI:
+    case OrbitalDensityRand::Normal_Nelson_type::TEMPERING:
+    case OrbitalDensityRand::Normal_Nelson_type::MALA:
         // Set primitive topology
         pd3dImmediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
         break;
@@ -558,11 +640,20 @@ void CALLBACK OnD3D11FrameRender(ID3D11Device* pd3dDevice, ID3D11DeviceContext*
     //
     // Render the cube
     //
-    pd3dImmediateContext->VSSetShader(pVertexShaderBox.Get(), nullptr, 0);
+    pd3dImmediateContext->VSSetShader(packed ? pVertexShaderPacked.Get() : pVertexShaderBox.Get(), nullptr, 0);
     pd3dImmediateContext->VSSetConstantBuffers(1, 1, pCBChangesEveryFrame.GetAddressOf());
     pd3dImmediateContext->PSSetShader(pPixelShaderBox.Get(), nullptr, 0);
     pd3dImmediateContext->PSSetConstantBuffers(1, 1, pCBChangesEveryFrame.GetAddressOf());
-    pd3dImmediateContext->DrawIndexed(static_cast<UINT>(podr->Vertexsize), 0, 0);
+    // 生成済みの頂点だけを、インデックスバッファを使わずにセグメントごとに描画する（線分の場合は端点が揃った分だけ）
+    auto const uploaded = uploadplanner.Uploaded();
+    auto const drawsize = nornel == OrbitalDensityRand::Normal_Nelson_type::NELSON ? uploaded & ~static_cast<std::size_t>(1) : uploaded;
+    UINT const stride = packed ? sizeof(PackedVertex) : sizeof(SimpleVertex);
+    auto const offset = 0U;
+    uploadplanner.For_each_segment(0, drawsize, [&](std::size_t segment, std::size_t begin, std::size_t end) {
+        // Set vertex buffer
+        pd3dImmediateContext->IASetVertexBuffers(0, 1, pVertexBuffers[segment].GetAddressOf(), &stride, &offset);
+        pd3dImmediateContext->Draw(static_cast<UINT>(end - begin), static_cast<UINT>(begin));
+    });
 
     hud.OnRender(fElapsedTime);
     ui.OnRender(fElapsedTime);
@@ -641,6 +732,7 @@ void CALLBACK OnGUIEvent(UINT nEvent, int nControlID, CDXUTControl* pControl, vo
 
     case IDC_REDRAW:
         RedrawFlagTrue();
+        podr->Seed(++seed);
         Redraw();
         break;
 
@@ -648,6 +740,9 @@ void CALLBACK OnGUIEvent(UINT nEvent, int nControlID, CDXUTControl* pControl, vo
         if (ReadData()) {
             StopDraw();
             podr.emplace(pgd);
+            podr->Cache(pcache);
+            podr->Seed(seed);
+            podr->Speculative(true);
             nornel = OrbitalDensityRand::Normal_Nelson_type::NORMAL;
             podr->Vertexsize(pgd->Rho_wf_type == getdata::GetData::Rho_Wf_type::RHO ? OrbitalDensityRand::RHO_VERTEXSIZE_INIT_VALUE : OrbitalDensityRand::WF_VERTEXSIZE_INIT_VALUE);
             ::SetWindowText(DXUTGetHWND(), CreateWindowTitle().c_str());
@@ -701,6 +796,28 @@ void CALLBACK OnGUIEvent(UINT nEvent, int nControlID, CDXUTControl* pControl, vo
         Redraw();
         break;
 
+    case IDC_CHECKPACKED:
+        RedrawFlagTrue();
+        podr->Packed((dynamic_cast<CDXUTCheckBox*>(pControl))->GetChecked());
+        Redraw();
+        break;
+
+    case IDC_CHECKDIRECT:
+        SelectSampler(nControlID, OrbitalDensityRand::Normal_Nelson_type::DIRECT, (dynamic_cast<CDXUTCheckBox*>(pControl))->GetChecked());
+        break;
+
+    case IDC_CHECKQUASI:
+        SelectSampler(nControlID, OrbitalDensityRand::Normal_Nelson_type::QUASI, (dynamic_cast<CDXUTCheckBox*>(pControl))->GetChecked());
+        break;
+
+    case IDC_CHECKTEMPERING:
+        SelectSampler(nControlID, OrbitalDensityRand::Normal_Nelson_type::TEMPERING, (dynamic_cast<CDXUTCheckBox*>(pControl))->GetChecked());
+        break;
+
+    case IDC_CHECKMALA:
+        SelectSampler(nControlID, OrbitalDensityRand::Normal_Nelson_type::MALA, (dynamic_cast<CDXUTCheckBox*>(pControl))->GetChecked());
+        break;
+
     default:
         BOOST_ASSERT(!"何かがおかしい!");
         break;
@@ -732,6 +849,10 @@ std::wstring CreateWindowTitle()
     switch (nornel)
     {
     case OrbitalDensityRand::Normal_Nelson_type::NORMAL:
+    case OrbitalDensityRand::Normal_Nelson_type::DIRECT:
+    case OrbitalDensityRand::Normal_Nelson_type::QUASI:
+    case OrbitalDensityRand::Normal_Nelson_type::TEMPERING:
+    case OrbitalDensityRand::Normal_Nelson_type::MALA:
         switch (pgd->Rho_wf_type)
         {
         case getdata::GetData::Rho_Wf_type::RHO:
@@ -866,11 +987,43 @@ HRESULT RenderPoint()
         break;
     }
 
-    // Create vertex buffer
-    D3D11_SUBRESOURCE_DATA InitData;
-    ZeroMemory(&InitData, sizeof(InitData));
-    InitData.pSysMem = podr->Vertex().data();
-    V_RETURN(g_pd3dDevice->CreateBuffer(&g_bd, &InitData, pVertexBuffer.ReleaseAndGetAddressOf()));
+    // 頂点バッファは頂点数か頂点の形式が変わったときだけ作り直し、生成済みでまだ転送していない範囲だけを転送する
+    auto const packed = static_cast<bool>(podr->Packed);
+    auto const stride = packed ? sizeof(PackedVertex) : sizeof(SimpleVertex);
+    auto const data = packed ? static_cast<void const *>(podr->Packed_vertex().data()) : static_cast<void const *>(podr->Vertex().data());
+    auto const size = packed ? podr->Packed_vertex().size() : podr->Vertex().size();
+
+    uploadplanner.Stride = stride;
+    auto const plan = uploadplanner(podr->Generation, size, podr->Ready_vertexsize);
+
+    if (plan.recreate) {
+        // Create vertex buffer（頂点数だけが変わった場合は、大きさの変わらない先頭のセグメントを残す）
+        pVertexBuffers.resize(uploadplanner.Segments(size));
+        uploadplanner.For_each_segment(plan.firstsegment * SEGMENTSIZE, size, [&](std::size_t segment, std::size_t begin, std::size_t end) {
+            g_bd.ByteWidth = static_cast<UINT>(stride * (end - begin));
+            if (SUCCEEDED(hr)) {
+                hr = g_pd3dDevice->CreateBuffer(&g_bd, nullptr, pVertexBuffers[segment].ReleaseAndGetAddressOf());
+            }
+        });
+
+        if (FAILED(hr)) {
+            pVertexBuffers.clear();
+            uploadplanner.Invalidate();
+            return hr;
+        }
+    }
+
+    uploadplanner.For_each_segment(plan.begin, plan.end, [&](std::size_t segment, std::size_t begin, std::size_t end) {
+        D3D11_BOX box;
+        box.left = static_cast<UINT>(stride * begin);
+        box.right = static_cast<UINT>(stride * end);
+        box.top = 0;
+        box.bottom = 1;
+        box.front = 0;
+        box.back = 1;
+        auto const src = static_cast<char const *>(data) + stride * (segment * SEGMENTSIZE + begin);
+        DXUTGetD3D11DeviceContext()->UpdateSubresource(pVertexBuffers[segment].Get(), 0, &box, src, 0, 0);
+    });
 
     return hr;
 }
@@ -910,31 +1063,12 @@ bool ReadData()
 */
 void Redraw()
 {
+    // 頂点バッファの大きさ（ByteWidth）はRenderPointでセグメントごとに決める
     ZeroMemory(&g_bd, sizeof(g_bd));
     g_bd.Usage = D3D11_USAGE_DEFAULT;
-    g_bd.ByteWidth = static_cast<UINT>(sizeof(SimpleVertex) * podr->Vertexsize);
     g_bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
     g_bd.CPUAccessFlags = 0;
 
-    // Create index buffer
-
-    static std::vector<std::int32_t> indices;
-    indices.resize(podr->Vertexsize);
-    std::iota(indices.begin(), indices.end(), 0);
-
-    // バッファーリソース
-    D3D11_BUFFER_DESC bd;
-
-    ZeroMemory(&bd, sizeof(bd));
-    bd.Usage = D3D11_USAGE_DEFAULT;
-    bd.ByteWidth = static_cast<UINT>(sizeof(DWORD) * podr->Vertexsize);
-    bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
-    bd.CPUAccessFlags = 0;
-    bd.MiscFlags = 0;
-    D3D11_SUBRESOURCE_DATA InitData;
-    InitData.pSysMem = indices.data();
-    g_pd3dDevice->CreateBuffer(&bd, &InitData, &pIndexBuffer);
-
     SetCamera();
 }
 
@@ -975,12 +1109,26 @@ void RenderText(double fTime)
     pTxtHelper->SetForegroundColor(Colors::Yellow);
     pTxtHelper->DrawTextLine(DXUTGetFrameStats(DXUTIsVsyncEnabled()));
     pTxtHelper->DrawTextLine(DXUTGetDeviceStats());
-    if (nornel == OrbitalDensityRand::Normal_Nelson_type::NORMAL)
+    if (nornel != OrbitalDensityRand::Normal_Nelson_type::NELSON)
     {
         pTxtHelper->DrawTextLine(std::format(L"CPU threads: {:d}", CPUTHREADS).c_str());
     }
     pTxtHelper->DrawTextLine(std::format(L"Total vertices = {:d}", static_cast<std::int32_t>(podr->Vertexsize)).c_str());
+    pTxtHelper->DrawTextLine(std::format(L"Ready vertices = {:d}", static_cast<std::int32_t>(uploadplanner.Uploaded)).c_str());
+    pTxtHelper->DrawTextLine(std::format(L"Uploaded = {:.3f}(MB/frame)", static_cast<double>(uploadplanner.Frame_bytes) / (1024.0 * 1024.0)).c_str());
+    pTxtHelper->DrawTextLine(std::format(L"Vertex memory = {:.1f}(MB)", static_cast<double>(podr->Vertex_bytes) / (1024.0 * 1024.0)).c_str());
+    pTxtHelper->DrawTextLine(std::format(L"Sample cache: {:s} (hits {:d}, misses {:d})", podr->Cache_hit ? L"hit" : L"miss", static_cast<std::int32_t>(pcache->Hits), static_cast<std::int32_t>(pcache->Misses)).c_str());
+    pTxtHelper->DrawTextLine(std::format(L"Orbital pool: {:s} ({:d} orbitals, {:.1f}(MB))", podr->Pool_hit ? L"hit" : L"miss", static_cast<std::int32_t>(podr->Pool_size), static_cast<double>(podr->Pool_bytes) / (1024.0 * 1024.0)).c_str());
     pTxtHelper->DrawTextLine(std::format(L"Calculation time = {:.3f}(sec)", calctime).c_str());
+    if (nornel == OrbitalDensityRand::Normal_Nelson_type::NORMAL || nornel == OrbitalDensityRand::Normal_Nelson_type::TEMPERING ||
+        nornel == OrbitalDensityRand::Normal_Nelson_type::MALA)
+    {
+        pTxtHelper->DrawTextLine(std::format(L"Acceptance rate = {:.3f} (sigma = {:.3f})", static_cast<double>(podr->Acceptance_rate), static_cast<double>(podr->Proposal_sigma)).c_str());
+    }
+    if (nornel == OrbitalDensityRand::Normal_Nelson_type::TEMPERING)
+    {
+        pTxtHelper->DrawTextLine(std::format(L"Swap rate = {:.3f} ({:d} rungs)", static_cast<double>(podr->Swap_rate), static_cast<std::int32_t>(podr->Rungs)).c_str());
+    }
     if (nornel == OrbitalDensityRand::Normal_Nelson_type::NELSON)
     {
         pTxtHelper->DrawTextLine(std::format(L"Time step: {:.3f}(attosec)", podr->Dt).c_str());
@@ -990,6 +1138,21 @@ void RenderText(double fTime)
     pTxtHelper->End();
 }
 
+void SelectSampler(int nControlID, OrbitalDensityRand::Normal_Nelson_type sampler, bool checked)
+{
+    RedrawFlagTrue();
+    nornel = checked ? sampler : OrbitalDensityRand::Normal_Nelson_type::NORMAL;
+
+    // 生成方法は1つしか選べないので、押されたもの以外のチェックを外す
+    for (auto const id : { IDC_CHECKDIRECT, IDC_CHECKQUASI, IDC_CHECKTEMPERING, IDC_CHECKMALA }) {
+        if (id != nControlID) {
+            hud.GetCheckBox(id)->SetChecked(false);
+        }
+    }
+
+    Redraw();
+}
+
 void SetCamera()
 {
     // Initialize the view matrix
@@ -1063,7 +1226,7 @@ void SetUI()
             break;
         }
 
-        if (pgd->Rho_wf_type == getdata::GetData::Rho_Wf_type::WF && nornel == OrbitalDensityRand::Normal_Nelson_type::NORMAL)
+        if (pgd->Rho_wf_type == getdata::GetData::Rho_Wf_type::WF && nornel != OrbitalDensityRand::Normal_Nelson_type::NELSON)
         {
             // Radio buttons
             hud.AddRadioButton(IDC_RADIOA, 1, L"Normal", 35, iY += 34, 125, 22, true, L'1');
@@ -1080,7 +1243,7 @@ void SetUI()
     // 頂点数の調整
     hud.AddStatic(IDC_OUTPUT, L"Vertex size", 20, iY += 34, 125, 22);
     hud.GetStatic(IDC_OUTPUT)->SetTextColor(D3DCOLOR_ARGB(255, 255, 255, 255));
-    auto const slider1_max = nornel == OrbitalDensityRand::Normal_Nelson_type::NORMAL ? 50000000 : 10000000;
+    auto const slider1_max = nornel != OrbitalDensityRand::Normal_Nelson_type::NELSON ? 50000000 : 10000000;
     hud.AddSlider(IDC_SLIDER1, 35, iY += 24, 125, 22, 0, slider1_max, static_cast<std::int32_t>(podr->Vertexsize));
 
     if (pgd->Rho_wf_type == getdata::GetData::Rho_Wf_type::WF && nornel == OrbitalDensityRand::Normal_Nelson_type::NELSON)
@@ -1091,6 +1254,24 @@ void SetUI()
         hud.AddSlider(IDC_SLIDER2, 35, iY += 24, 125, 22, 1, slider2_max, static_cast<std::int32_t>(podr->Dt) * 100);
     }
 
+    // 頂点の形式（16ビット固定小数点数に圧縮するかどうか）
+    hud.AddCheckBox(IDC_CHECKPACKED, L"Packed vertex", 35, iY += 34, 125, 22, podr->Packed);
+
+    // マルコフ連鎖を使わずに直接生成するかどうか
+    if (nornel != OrbitalDensityRand::Normal_Nelson_type::NELSON)
+    {
+        hud.AddCheckBox(IDC_CHECKDIRECT, L"Direct sampling", 35, iY += 28, 125, 22, nornel == OrbitalDensityRand::Normal_Nelson_type::DIRECT);
+
+        // 準乱数（スクランブルしたSobol点列）で、少ない頂点数でもむらの少ない点群を生成するかどうか
+        hud.AddCheckBox(IDC_CHECKQUASI, L"Quasi-random", 35, iY += 28, 125, 22, nornel == OrbitalDensityRand::Normal_Nelson_type::QUASI);
+
+        // 交換モンテカルロ法で、節で区切られたローブの間をチェーンが移りやすくするかどうか
+        hud.AddCheckBox(IDC_CHECKTEMPERING, L"Parallel tempering", 35, iY += 28, 125, 22, nornel == OrbitalDensityRand::Normal_Nelson_type::TEMPERING);
+
+        // ∇log|ψ|を使う提案（MALA）で、ランダムウォークより相関の弱い点群を生成するかどうか
+        hud.AddCheckBox(IDC_CHECKMALA, L"Langevin (MALA)", 35, iY += 28, 125, 22, nornel == OrbitalDensityRand::Normal_Nelson_type::MALA);
+    }
+
     ui.SetCallback(OnGUIEvent);
 }
 
@@ -21,6 +21,14 @@ struct VS_INPUT
     float4 Color : COLOR;
 };
 
+//--------------------------------------------------------------------------------------
+// PackedVertex: xyz = position / Rmax (the Rmax scaling is folded into World), w = sign
+//--------------------------------------------------------------------------------------
+struct VS_PACKED_INPUT
+{
+    float4 Pos : POSITION;
+};
+
 //--------------------------------------------------------------------------------------
 struct VS_OUTPUT
 {
@@ -42,6 +50,19 @@ VS_OUTPUT VS(VS_INPUT input)
     return output;
 }
 
+//--------------------------------------------------------------------------------------
+// Vertex Shader for PackedVertex
+//--------------------------------------------------------------------------------------
+VS_OUTPUT VS_Packed(VS_PACKED_INPUT input)
+{
+    VS_OUTPUT output = (VS_OUTPUT)0;
+    output.Pos = mul(float4(input.Pos.xyz, 1), World);
+    output.Pos = mul(output.Pos, View);
+    output.Pos = mul(output.Pos, Projection);
+    output.Color = input.Pos.w >= 0 ? float4(0.8, 0.0, 0.8, 1.0) : float4(0.0, 0.8, 0.8, 1.0);
+    return output;
+}
+
 //--------------------------------------------------------------------------------------
 // Pixel Shader
 //--------------------------------------------------------------------------------------
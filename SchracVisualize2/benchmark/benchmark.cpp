@@ -0,0 +1,56 @@
+﻿/*! \file benchmark.cpp
+    \brief ベンチマークプログラムのメイン関数
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include <cstdlib>      // for EXIT_FAILURE, EXIT_SUCCESS
+#include <functional>   // for std::function
+#include <iostream>     // for std::cerr
+#include <map>          // for std::map
+#include <string>       // for std::string
+
+int main(int argc, char * argv[])
+{
+    std::map<std::string, std::function<bool()>> const benchmarks = {
+        { "cache", benchmark::Cache_benchmark },
+        { "csv", benchmark::Csv_benchmark },
+        { "diagnostics", benchmark::Diagnostics_benchmark },
+        { "direct", benchmark::Direct_benchmark },
+        { "drift", benchmark::Drift_benchmark },
+        { "gradient", benchmark::Gradient_benchmark },
+        { "grow", benchmark::Grow_benchmark },
+        { "mh", benchmark::Mh_benchmark },
+        { "packed", benchmark::Packed_benchmark },
+        { "pool", benchmark::Pool_benchmark },
+        { "quasi", benchmark::Quasi_benchmark },
+        { "radial", benchmark::Radial_benchmark },
+        { "rng", benchmark::Rng_benchmark },
+        { "scaling", benchmark::Scaling_benchmark },
+        { "sidecar", benchmark::Sidecar_benchmark },
+        { "tempering", benchmark::Tempering_benchmark },
+        { "upload", benchmark::Upload_benchmark },
+        { "ylm", benchmark::Ylm_benchmark }
+    };
+
+    if (argc != 2 || (benchmarks.find(argv[1]) == benchmarks.end() && std::string(argv[1]) != "all")) {
+        std::cerr << "Usage: " << argv[0] << " <all";
+        for (auto const & [name, func] : benchmarks) {
+            std::cerr << '|' << name;
+        }
+        std::cerr << ">\n";
+        return EXIT_FAILURE;
+    }
+
+    // 計測のついでに行う結果の確認が1つでも失敗したら、異常終了とする
+    auto passed = true;
+    for (auto const & [name, func] : benchmarks) {
+        if ((std::string(argv[1]) == "all" || name == argv[1]) && !func()) {
+            std::cerr << "benchmark " << name << ": check failed\n";
+            passed = false;
+        }
+    }
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
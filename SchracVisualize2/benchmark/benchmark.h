@@ -0,0 +1,202 @@
+﻿/*! \file benchmark.h
+    \brief ベンチマーク関数の宣言と、時間計測用の関数の実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#pragma once
+
+#include <chrono>   // for std::chrono
+#include <cstdint>  // for std::int32_t
+#include <string>   // for std::string
+#include <utility>  // for std::pair
+
+namespace getdata {
+    class GetData;
+}
+
+namespace orbitaldensityrand {
+    class OrbitalDensityRand;
+}
+
+namespace benchmark {
+    //! A global variable (constant expression).
+    /*!
+        統計的な誤差のある量を確かめるときに、標準誤差の何倍までのずれを許すか
+    */
+    static auto constexpr NSIGMA = 5.0;
+
+    //! A template function.
+    /*!
+        関数の実行時間を計測する
+        \param func 計測する関数
+        \return 実行時間（秒）
+    */
+    template <typename FUNCTYPE>
+    double Measure(FUNCTYPE && func)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    //! A function.
+    /*!
+        水素原子の動径波動関数（または電子密度）のデータファイルを一時ディレクトリに作成する
+        \param n 主量子数
+        \param l 方位量子数
+        \param rho 電子密度のファイルを作成するかどうか
+        \return 作成したデータファイルのパス
+    */
+    std::string Hydrogen_data_file(std::int32_t n, std::int32_t l, bool rho);
+
+    //! A function.
+    /*!
+        点群の〈r〉が、参照値から標準誤差のNSIGMA倍以内にあるかどうか調べる
+        標準誤差は、rの標準偏差の参照値と有効サンプルサイズから求める
+        \param odr 生成が終わった乱数生成のオブジェクト
+        \param reference rの平均と標準偏差の参照値
+        \param ess 有効サンプルサイズ
+        \return 点群の〈r〉と、参照値から標準誤差のNSIGMA倍以内にあるかどうか
+    */
+    std::pair<double, bool> Check_mean_r(orbitaldensityrand::OrbitalDensityRand const & odr, std::pair<double, double> const & reference, double ess);
+
+    //! A function.
+    /*!
+        点群が従う動径分布 r^2 φ(r)^2 での、rの平均と標準偏差を、データファイルの3次スプラインを使って数値積分で求める
+        \param gd データファイルのオブジェクト
+        \return rの平均と標準偏差
+    */
+    std::pair<double, double> Reference_r(getdata::GetData const & gd);
+
+    //! A function.
+    /*!
+        点群のキャッシュ（samplecache::SampleCache）が見つからない場合と見つかった場合の再描画時間のベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Cache_benchmark();
+
+    //! A function.
+    /*!
+        データファイルの読み込み（従来のstd::getlineとstd::stodによる方法とgetdata::ReadDataFile）のベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Csv_benchmark();
+
+    //! A function.
+    /*!
+        メトロポリス・ヘイスティングス法と直接生成法による点群生成の速度と、〈r〉および有効サンプルサイズのベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Direct_benchmark();
+
+    //! A function.
+    /*!
+        メトロポリス・ヘイスティングス法のバーンインと間引きごとの、生成時間と積分自己相関時間、ESS、R-hatのベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Diagnostics_benchmark();
+
+    //! A function.
+    /*!
+        目標の分布の勾配を使う点群生成（MALA）と、ランダムウォークのメトロポリス・ヘイスティングス法の、1秒あたりの有効サンプルサイズのベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Gradient_benchmark();
+
+    //! A function.
+    /*!
+        頂点数を増やしたとき（最初から生成し直す方法と、生成済みの頂点に足りない分だけを足す方法）のベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Grow_benchmark();
+
+    //! A function.
+    /*!
+        メトロポリス・ヘイスティングス法による点群生成（1スレッドあたりのチェーン数ごと）のベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Mh_benchmark();
+
+    //! A function.
+    /*!
+        Nelsonの確率力学のドリフト項の角度部分（数値微分による従来の方法とrealylm::RealYlm::Gradient）のベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Drift_benchmark();
+
+    //! A function.
+    /*!
+        磁気量子数ごとの点群のプールと先読みによる、軌道の切り替え時間のベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Pool_benchmark();
+
+    //! A function.
+    /*!
+        直接生成法と準乱数（スクランブルしたSobol点列）による点群の、頂点数ごとの〈r〉とビンの頻度の誤差のベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Quasi_benchmark();
+
+    //! A function.
+    /*!
+        動径関数の補間（gsl_splineとgetdata::RadialTable）の速度と精度のベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Radial_benchmark();
+
+    //! A function.
+    /*!
+        頂点の形式（SimpleVertexとPackedVertex）のメモリ使用量と誤差のベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Packed_benchmark();
+
+    //! A function.
+    /*!
+        正規乱数の生成（従来のスカラーの方法とmyrandom::MyRandSfmtのブロック生成）のベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Rng_benchmark();
+
+    //! A function.
+    /*!
+        動径関数の補間（共有のgsl_interp_accelとスレッドごとのgsl_interp_accel）のスレッド数に対するスケーリングのベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Scaling_benchmark();
+
+    //! A function.
+    /*!
+        データファイルの読み込み（テキスト形式と、3次スプラインの係数を含むバイナリ形式）のベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Sidecar_benchmark();
+
+    //! A function.
+    /*!
+        複数のローブを持つ軌道の点群生成（メトロポリス・ヘイスティングス法と交換モンテカルロ法）のローブの偏りのベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Tempering_benchmark();
+
+    //! A function.
+    /*!
+        頂点バッファへの転送量（毎フレーム全体を作り直す方法とutility::UploadPlanner）のベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Upload_benchmark();
+
+    //! A function.
+    /*!
+        実関数表示の球面調和関数（boostによる従来の方法とrealylm::RealYlm）のベンチマーク
+        \return 結果の確認がすべて成功したかどうか
+    */
+    bool Ylm_benchmark();
+}
+
+#endif  // _BENCHMARK_H_
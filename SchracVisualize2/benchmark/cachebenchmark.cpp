@@ -0,0 +1,70 @@
+﻿/*! \file cachebenchmark.cpp
+    \brief 点群のキャッシュ（samplecache::SampleCache）が見つからない場合と見つかった場合の再描画時間のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include <cstdio>       // for std::printf
+#include <cstring>      // for std::memcmp
+#include <filesystem>   // for std::filesystem
+#include <memory>       // for std::make_shared
+#include <vector>       // for std::vector
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            生成する頂点数
+        */
+        static auto constexpr NVERTEX = 5000000;
+    }
+
+    bool Cache_benchmark()
+    {
+        using namespace orbitaldensityrand;
+
+        auto const dir = std::filesystem::temp_directory_path() / "SchracVisualize2_cachebenchmark";
+        std::filesystem::remove_all(dir);
+        auto const pcache = std::make_shared<samplecache::SampleCache>(dir, samplecache::SampleCache::MAXBYTES_INIT_VALUE);
+
+        auto const pgd = std::make_shared<getdata::GetData>(Hydrogen_data_file(3, 2, true));
+        OrbitalDensityRand odr(pgd);
+        odr.Vertexsize(NVERTEX);
+        odr.Seed(1U);
+        odr.Cache(pcache);
+
+        // 1回目はキャッシュが見つからないので生成して保存する（保存の時間も含む）
+        auto const tmiss = Measure([&odr] {
+            odr(-2, OrbitalDensityRand::Normal_Nelson_type::NORMAL);
+            odr.Pth()->join();
+        });
+        auto const miss = !odr.Cache_hit;
+        std::vector<SimpleVertex> const generated(odr.Vertex().begin(), odr.Vertex().end());
+
+        // 2回目は同じパラメータなので、保存したファイルをマップするだけ
+        odr.Redraw(true);
+        auto const thit = Measure([&odr] {
+            odr(-2, OrbitalDensityRand::Normal_Nelson_type::NORMAL);
+            odr.Pth()->join();
+        });
+        auto const hit = static_cast<bool>(odr.Cache_hit);
+        auto const identical = odr.Vertex().size() == generated.size() &&
+            !std::memcmp(odr.Vertex().data(), generated.data(), sizeof(SimpleVertex) * generated.size());
+
+        std::printf("Sample cache: %d vertices of the 3d electron density (%.1f MB)\n",
+            NVERTEX, sizeof(SimpleVertex) * static_cast<double>(NVERTEX) / (1024.0 * 1024.0));
+        std::printf("  generate and store (miss: %s): %8.3f sec\n", miss ? "yes" : "NO", tmiss);
+        std::printf("  map from cache     (hit: %s) : %8.3f sec (%.0fx)\n", hit ? "yes" : "NO", thit, tmiss / thit);
+        std::printf("  mapped vertices match the generated vertices: %s\n", identical ? "yes" : "NO");
+
+        odr.Redraw(true);
+        odr.Cache(nullptr);
+        odr(-2, OrbitalDensityRand::Normal_Nelson_type::NORMAL);
+        odr.Pth()->join();
+        std::filesystem::remove_all(dir);
+
+        return miss && hit && identical;
+    }
+}
@@ -0,0 +1,162 @@
+﻿/*! \file csvbenchmark.cpp
+    \brief データファイルの読み込み（従来のstd::getlineとstd::stodによる方法とgetdata::ReadDataFile）のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/getdata/readdatafile.h"
+#include <array>                        // for std::array
+#include <cmath>                        // for std::exp, std::log
+#include <cstdint>                      // for std::int32_t
+#include <cstdio>                       // for std::printf, std::snprintf
+#include <filesystem>                   // for std::filesystem
+#include <fstream>                      // for std::ifstream, std::ofstream
+#include <stdexcept>                    // for std::invalid_argument, std::runtime_error
+#include <string>                       // for std::string
+#include <typeinfo>                     // for typeid
+#include <boost/algorithm/string.hpp>   // for boost::algorithm
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            合成するデータファイルの行数
+        */
+        static auto constexpr NROW = 1000000;
+
+        //! A function.
+        /*!
+            従来の方法（1行ずつstd::stringに読み、boost::algorithm::splitで分割してstd::stodで変換する）でデータファイルを読み込む
+            \param filename データファイル名
+            \return rのメッシュと、そのメッシュにおける値
+        */
+        getdata::ReadDataFile::mypair Legacy_read(std::string const & filename)
+        {
+            std::ifstream ifs(filename);
+            std::array<char, 1024> buf;
+            std::vector<double> r_mesh, phiorrho;
+            std::vector<std::string> tokens;
+
+            for (auto i = 0;; i++) {
+                using namespace boost::algorithm;
+
+                ifs.getline(buf.data(), buf.size());
+                std::string line(buf.data());
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+
+                split(tokens, line, is_any_of(","), token_compress_on);
+
+                if (!ifs.gcount() && !i) {
+                    throw std::runtime_error("データファイルが空です！");
+                }
+                else if (!ifs.gcount()) {
+                    return std::make_pair(r_mesh, phiorrho);
+                }
+                else if (tokens.size() != 2) {
+                    throw std::runtime_error("データファイルが異常です！");
+                }
+
+                std::size_t index1, index2;
+                r_mesh.push_back(std::stod(tokens[0], &index1));
+                phiorrho.push_back(std::stod(tokens[1], &index2));
+                if (tokens[0].size() != index1 || tokens[1].size() != index2) {
+                    throw std::runtime_error("データファイルが異常です！");
+                }
+            }
+        }
+
+        //! A function.
+        /*!
+            データファイルを書き出す
+            \param path 書き出すファイルのパス
+            \param text ファイルの中身
+        */
+        void Write_file(std::filesystem::path const & path, std::string const & text)
+        {
+            std::ofstream ofs(path, std::ios::binary);
+            ofs << text;
+        }
+
+        //! A function (template function).
+        /*!
+            関数を呼び、投げられた例外の型の名前を返す（std::runtime_errorはメッセージも含める）
+            \tparam FUNCTYPE 関数の型
+            \param func 関数
+            \return 例外の型の名前（例外が投げられなければ"none"）
+        */
+        template <typename FUNCTYPE>
+        std::string Exception_name(FUNCTYPE && func)
+        {
+            try {
+                func();
+            }
+            catch (std::runtime_error const & e) {
+                return std::string(typeid(e).name()) + ": " + e.what();
+            }
+            catch (std::exception const & e) {
+                return typeid(e).name();
+            }
+
+            return "none";
+        }
+    }
+
+    bool Csv_benchmark()
+    {
+        auto const dir = std::filesystem::temp_directory_path();
+        auto const path = dir / "rho_H_1s_csvbenchmark.csv";
+
+        // Schracと同じ書式（%.15e）で、対数メッシュの合成データを作る
+        {
+            std::ofstream ofs(path, std::ios::binary);
+            auto const dlogr = std::log(200.0 / 1.0E-5) / static_cast<double>(NROW - 1);
+            for (auto i = 0; i < NROW; i++) {
+                auto const r = 1.0E-5 * std::exp(dlogr * static_cast<double>(i));
+
+                char line[64];
+                std::snprintf(line, sizeof(line), "%.15e,%.15e\n", r, 4.0 * r * r * std::exp(-2.0 * r));
+                ofs << line;
+            }
+        }
+
+        auto const filename = path.string();
+        getdata::ReadDataFile::mypair legacy, mapped;
+        auto const tlegacy = Measure([&] { legacy = Legacy_read(filename); });
+        auto const tmapped = Measure([&] { mapped = getdata::ReadDataFile().readdatafile(filename); });
+        auto const identical = legacy == mapped;
+        auto const mb = static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0);
+
+        std::printf("Data file loading: %d rows (%.1f MB)\n", NROW, mb);
+        std::printf("  getline + split + stod       : %8.3f sec\n", tlegacy);
+        std::printf("  ReadDataFile (mmap+from_chars): %8.3f sec (%.1fx)\n", tmapped, tlegacy / tmapped);
+        std::printf("  identical values: %s\n", identical ? "yes" : "NO");
+
+        // 異常なファイルに対して、従来と同じ例外が投げられることを確認する
+        std::array<std::string, 8> const cases = {
+            "", "1.0,2.0\r\n3.0,4.0\r\n", "1.0,,2.0\n", "1.0,2.0,\n", "1.0\n", "x,2.0\n", "1.0,2.0 \n", "1.0,2.0\n\n"
+        };
+        auto const casepath = dir / "rho_H_1s_csvbenchmark_case.csv";
+        auto same = 0;
+        for (auto const & text : cases) {
+            Write_file(casepath, text);
+            auto const expected = Exception_name([&] { Legacy_read(casepath.string()); });
+            auto const actual = Exception_name([&] { getdata::ReadDataFile().readdatafile(casepath.string()); });
+            if (expected == actual) {
+                same++;
+            }
+            else {
+                std::printf("  error mismatch: legacy \"%s\", mapped \"%s\"\n", expected.c_str(), actual.c_str());
+            }
+        }
+
+        std::printf("  error reporting matches on %d/%d malformed or edge-case files\n", same, static_cast<std::int32_t>(cases.size()));
+
+        std::filesystem::remove(casepath);
+        std::filesystem::remove(path);
+
+        return identical && same == static_cast<std::int32_t>(cases.size());
+    }
+}
@@ -0,0 +1,100 @@
+﻿/*! \file diagnosticsbenchmark.cpp
+    \brief バーンインと間引きを変えたときの点群生成と連鎖の診断のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include <cstdio>                               // for std::printf
+#include <memory>                               // for std::make_shared
+#include <utility>                              // for std::pair
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            生成する頂点数
+        */
+        static auto constexpr NVERTEX = 2000000;
+
+        //! A global variable (constant expression).
+        /*!
+            収束したとみなすR-hatの上限
+        */
+        static auto constexpr RHATMAX = 1.01;
+
+        //! A global variable (constant expression).
+        /*!
+            間引きの間隔 × 間引いた後の自己相関時間が、間引かない場合の自己相関時間の何倍までなら許すか
+        */
+        static auto constexpr THINNINGSLACK = 1.5;
+
+        //! A global variable (constant expression).
+        /*!
+            独立な点の自己相関時間とみなす上限
+        */
+        static auto constexpr IATINDEPENDENT = 1.1;
+    }
+
+    bool Diagnostics_benchmark()
+    {
+        using namespace orbitaldensityrand;
+
+        std::printf("Burn-in and thinning of Metropolis-Hastings: %d vertices (3d, m = 0)\n", NVERTEX);
+        std::printf(" data  burn-in  thin  time (sec)      IAT        ESS   R-hat    ESS/s\n");
+
+        auto rhat = true;
+        auto thin = true;
+        for (auto const rho : { true, false }) {
+            auto const pgd = std::make_shared<getdata::GetData>(Hydrogen_data_file(3, 2, rho));
+
+            // 間引きの間隔をk倍にすると、自己相関時間はおよそ1/kになる
+            auto iatunthinned = 0.0;
+            for (auto const & [burnin, thinning] : { std::pair{ 0, 1 }, std::pair{ 64, 1 }, std::pair{ 256, 1 }, std::pair{ 64, 2 }, std::pair{ 64, 4 }, std::pair{ 64, 8 } }) {
+                OrbitalDensityRand odr(pgd);
+                odr.Vertexsize(NVERTEX);
+                odr.Seed(1U);
+                odr.Burnin(burnin);
+                odr.Thinning(thinning);
+
+                auto const t = Measure([&odr] {
+                    odr(0, OrbitalDensityRand::Normal_Nelson_type::NORMAL);
+                    odr.Pth()->join();
+                });
+                auto const diag = odr.Diagnose(OrbitalDensityRand::Normal_Nelson_type::NORMAL);
+
+                std::printf(" %4s  %7d  %4d  %10.3f  %7.3f  %9.0f  %6.4f  %7.2e\n",
+                    rho ? "rho" : "wf", burnin, thinning, t, diag.iat, diag.ess, diag.rhat, diag.ess / t);
+
+                rhat = rhat && diag.rhat <= RHATMAX;
+                if (thinning == 1) {
+                    iatunthinned = diag.iat;
+                }
+                else {
+                    thin = thin && static_cast<double>(thinning) * diag.iat <= THINNINGSLACK * iatunthinned;
+                }
+            }
+        }
+
+        // 比較のため、直接生成法の点群も同じ方法で診断する
+        auto const pgd = std::make_shared<getdata::GetData>(Hydrogen_data_file(3, 2, false));
+        OrbitalDensityRand odr(pgd);
+        odr.Vertexsize(NVERTEX);
+        odr.Seed(1U);
+
+        auto const t = Measure([&odr] {
+            odr(0, OrbitalDensityRand::Normal_Nelson_type::DIRECT);
+            odr.Pth()->join();
+        });
+        auto const diag = odr.Diagnose(OrbitalDensityRand::Normal_Nelson_type::DIRECT);
+
+        std::printf("   wf   direct        %10.3f  %7.3f  %9.0f  %6.4f  %7.2e\n", t, diag.iat, diag.ess, diag.rhat, diag.ess / t);
+
+        auto const independent = diag.iat <= IATINDEPENDENT && diag.rhat <= RHATMAX;
+        std::printf(" R-hat <= %.2f: %s, thinning shortens IAT: %s, direct IAT <= %.1f: %s\n",
+            RHATMAX, rhat ? "yes" : "NO", thin ? "yes" : "NO", IATINDEPENDENT, independent ? "yes" : "NO");
+
+        return rhat && thin && independent;
+    }
+}
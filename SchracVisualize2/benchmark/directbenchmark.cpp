@@ -0,0 +1,190 @@
+﻿/*! \file directbenchmark.cpp
+    \brief メトロポリス・ヘイスティングス法と直接生成法による点群生成のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include "../orbitaldensityrand/realylm/realylm.h"
+#include <cmath>                                // for std::cos, std::sin, std::sqrt
+#include <cstdio>                               // for std::printf
+#include <cstring>                              // for std::memcmp
+#include <memory>                               // for std::make_shared
+#include <tuple>                                // for std::tuple
+#include <vector>                               // for std::vector
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::two_pi
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            生成する頂点数
+        */
+        static auto constexpr NVERTEX = 5000000;
+
+        //! A global variable (constant expression).
+        /*!
+            バッチ平均法でESSを推定するときの1バッチあたりの頂点数
+        */
+        static auto constexpr BATCHSIZE = 5000;
+
+        //! A global variable (constant expression).
+        /*!
+            〈(x/r)^2〉の参照値を数値積分で求めるときの、cosθ方向の分割数（φ方向はその2倍）
+        */
+        static auto constexpr NANGULAR = 1000;
+
+        //! A global variable (constant expression).
+        /*!
+            磁気量子数（φに依存するようにm = 1のdxz軌道を使う）
+        */
+        static auto constexpr M = 1;
+
+        //! A function.
+        /*!
+            点群のrの平均、(x/r)^2の平均と、rについてバッチ平均法で推定した有効サンプルサイズ（ESS）を求める
+            \param odr 生成が終わった乱数生成のオブジェクト
+            \return rの平均、(x/r)^2の平均とESSのタプル
+        */
+        std::tuple<double, double, double> Mean_and_ess(orbitaldensityrand::OrbitalDensityRand const & odr)
+        {
+            auto const vertex = odr.Vertex();
+            auto const n = static_cast<std::int32_t>(vertex.size());
+            auto const nbatch = n / BATCHSIZE;
+
+            auto sum = 0.0, sum2 = 0.0, batchsum2 = 0.0, sumx2 = 0.0;
+            for (auto b = 0; b < nbatch; b++) {
+                auto batchsum = 0.0;
+                for (auto i = b * BATCHSIZE; i < (b + 1) * BATCHSIZE; i++) {
+                    auto const & pos = vertex[i].Pos;
+                    auto const r = std::sqrt(static_cast<double>(pos.x) * pos.x + static_cast<double>(pos.y) * pos.y + static_cast<double>(pos.z) * pos.z);
+                    batchsum += r;
+                    sum2 += r * r;
+                    sumx2 += r > 0.0 ? pos.x * pos.x / (r * r) : 0.0;
+                }
+
+                sum += batchsum;
+                batchsum2 += (batchsum / BATCHSIZE) * (batchsum / BATCHSIZE);
+            }
+
+            auto const total = static_cast<double>(nbatch) * BATCHSIZE;
+            auto const mean = sum / total;
+            auto const var = sum2 / total - mean * mean;
+            auto const batchvar = batchsum2 / nbatch - mean * mean;
+
+            // ESS = N × Var(r) / (バッチサイズ × バッチ平均の分散)
+            return { mean, sumx2 / total, total * var / (BATCHSIZE * batchvar) };
+        }
+
+        //! A function.
+        /*!
+            点群が従う角度分布 |Y_lm|^2（電子密度の場合は|Y_lm|^4）での〈(x/r)^2〉を、中点則の数値積分で求める
+            \param l 方位量子数
+            \param m 磁気量子数
+            \param rho 電子密度のデータかどうか
+            \return 〈(x/r)^2〉の参照値
+        */
+        double Reference_mean_x2(std::int32_t l, std::int32_t m, bool rho)
+        {
+            using namespace boost::math::constants;
+
+            realylm::RealYlm const ylm(l, m);
+            std::vector<double> x(2 * NANGULAR), y(2 * NANGULAR), z(2 * NANGULAR), val(2 * NANGULAR);
+
+            auto num = 0.0, den = 0.0;
+            for (auto i = 0; i < NANGULAR; i++) {
+                auto const u = -1.0 + 2.0 * (i + 0.5) / NANGULAR;
+                auto const s = std::sqrt(1.0 - u * u);
+                for (auto j = 0; j < 2 * NANGULAR; j++) {
+                    auto const phi = two_pi<double>() * (j + 0.5) / (2 * NANGULAR);
+                    x[j] = s * std::cos(phi);
+                    y[j] = s * std::sin(phi);
+                    z[j] = u;
+                }
+
+                ylm(x.data(), y.data(), z.data(), val.data(), val.size());
+                for (auto j = 0; j < 2 * NANGULAR; j++) {
+                    auto const w = rho ? val[j] * val[j] * val[j] * val[j] : val[j] * val[j];
+                    num += w * x[j] * x[j];
+                    den += w;
+                }
+            }
+
+            return num / den;
+        }
+
+        //! A function.
+        /*!
+            点群を生成し、生成が終わるまで待つ
+            \param odr 乱数生成のオブジェクト
+            \param nornel 生成の方法
+            \return 生成にかかった時間（秒）
+        */
+        double Generate(orbitaldensityrand::OrbitalDensityRand & odr, orbitaldensityrand::OrbitalDensityRand::Normal_Nelson_type nornel)
+        {
+            return Measure([&odr, nornel] {
+                odr(M, nornel);
+                odr.Pth()->join();
+            });
+        }
+    }
+
+    bool Direct_benchmark()
+    {
+        using namespace orbitaldensityrand;
+
+        std::printf("Metropolis-Hastings vs direct sampling: %d vertices (3d, m = %d)\n", NVERTEX, M);
+        std::printf(" data  method  time (sec)  Mvertices/s   <r>     ref <r>  <(x/r)^2>   ref        ESS    ESS/s\n");
+
+        auto meanr = true;
+
+        for (auto const rho : { true, false }) {
+            auto const pgd = std::make_shared<getdata::GetData>(Hydrogen_data_file(3, 2, rho));
+            auto const reference = Reference_r(*pgd);
+            auto const referencex2 = Reference_mean_x2(2, M, rho);
+
+            for (auto const nornel : { OrbitalDensityRand::Normal_Nelson_type::NORMAL, OrbitalDensityRand::Normal_Nelson_type::DIRECT }) {
+                OrbitalDensityRand odr(pgd);
+                odr.Vertexsize(NVERTEX);
+                odr.Seed(1U);
+
+                auto const t = Generate(odr, nornel);
+                auto const [mean, meanx2, ess] = Mean_and_ess(odr);
+                meanr = meanr && Check_mean_r(odr, reference, ess).second;
+
+                std::printf(" %4s  %6s  %10.3f  %11.2f  %7.4f  %7.4f  %9.5f  %7.5f  %9.0f  %7.2e\n",
+                    rho ? "rho" : "wf", nornel == OrbitalDensityRand::Normal_Nelson_type::NORMAL ? "MH" : "direct",
+                    t, NVERTEX / t * 1.0E-6, mean, reference.first, meanx2, referencex2, ess, ess / t);
+            }
+        }
+
+        // 直接生成法でも、頂点数を増やしたときとスレッド数を変えたときに同じ点群になることを確かめる
+        auto const pgd = std::make_shared<getdata::GetData>(Hydrogen_data_file(3, 2, false));
+
+        OrbitalDensityRand fresh(pgd);
+        fresh.Vertexsize(NVERTEX);
+        fresh.Seed(1U);
+        fresh.Threads(1);
+        Generate(fresh, OrbitalDensityRand::Normal_Nelson_type::DIRECT);
+
+        OrbitalDensityRand odr(pgd);
+        odr.Vertexsize(NVERTEX / 2 + 1);
+        odr.Seed(1U);
+        odr.Threads(4);
+        Generate(odr, OrbitalDensityRand::Normal_Nelson_type::DIRECT);
+        auto const prefix = !std::memcmp(odr.Vertex().data(), fresh.Vertex().data(), sizeof(SimpleVertex) * (NVERTEX / 2 + 1));
+
+        odr.Vertexsize(NVERTEX);
+        odr.Redraw(true);
+        Generate(odr, OrbitalDensityRand::Normal_Nelson_type::DIRECT);
+        auto const grown = odr.Vertex().size() == NVERTEX &&
+            !std::memcmp(odr.Vertex().data(), fresh.Vertex().data(), sizeof(SimpleVertex) * NVERTEX);
+
+        std::printf("  <r> within %.0f standard errors of the reference: %s\n", NSIGMA, meanr ? "yes" : "NO");
+        std::printf("  direct: prefix of a larger cloud: %s, append %d -> %d identical: %s (1 vs 4 threads)\n",
+            prefix ? "yes" : "NO", NVERTEX / 2 + 1, NVERTEX, grown ? "yes" : "NO");
+
+        return meanr && prefix && grown;
+    }
+}
@@ -0,0 +1,171 @@
+﻿/*! \file driftbenchmark.cpp
+    \brief Nelsonの確率力学のドリフト項（角度部分）のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include "../orbitaldensityrand/realylm/realylm.h"
+#include <algorithm>                            // for std::max, std::nth_element
+#include <array>                                // for std::array
+#include <cmath>                                // for std::acos, std::cos, std::fabs, std::sin, std::sqrt
+#include <cstdint>                              // for std::int32_t
+#include <cstdio>                               // for std::printf
+#include <vector>                               // for std::vector
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            評価する点の数
+        */
+        static auto constexpr NPOINTS = 200000;
+
+        //! A global variable (constant expression).
+        /*!
+            数値微分の刻み幅
+        */
+        static auto constexpr DH = 1.0E-7;
+
+        //! A global variable (constant expression).
+        /*!
+            数値微分との相対誤差の中央値の許容値（6点の中心差分の誤差は1.0E-9程度）
+        */
+        static auto constexpr TOLERANCE = 1.0E-7;
+
+        //! A function.
+        /*!
+            従来のFillSimpleVertexと同じ6点の中心差分で関数の数値微分を求める
+            \param x 微分する座標x
+            \param func 微分対象の関数
+            \return 微分係数
+        */
+        template <typename FUNCTYPE>
+        double Numerical_diff(double x, FUNCTYPE const & func)
+        {
+            auto const term1 = func(x + 3.0 * DH) / 60.0;
+            auto const term2 = -3.0 / 20.0 * func(x + 2.0 * DH);
+            auto const term3 = 3.0 / 4.0 * func(x + DH);
+            auto const term4 = -3.0 / 4.0 * func(x - DH);
+            auto const term5 = 3.0 / 20.0 * func(x - 2.0 * DH);
+            auto const term6 = -func(x - 3.0 * DH) / 60.0;
+
+            return (term1 + term2 + term3 + term4 + term5 + term6) / DH;
+        }
+
+        //! A function.
+        /*!
+            従来の方法（θ、φとboostの球面調和関数の数値微分）で、r = 1のときのドリフト項の角度部分∇Y/Yを求める
+            \param l 方位量子数
+            \param m 磁気量子数
+            \param x 単位ベクトルのx成分
+            \param y 単位ベクトルのy成分
+            \param z 単位ベクトルのz成分
+            \return ドリフト項の角度部分
+        */
+        std::array<double, 3> Drift_from_angles(std::int32_t l, std::int32_t m, double x, double y, double z)
+        {
+            auto phi = 0.0;
+            if (std::fabs(y) < 1.0E-15) {
+                if (x < 0.0) {
+                    phi = boost::math::constants::pi<double>();
+                }
+            }
+            else if (x * x + y * y > 0.0) {
+                auto const sign = y > 0 ? 1 : -1;
+                phi = sign * std::acos(x / std::sqrt(x * x + y * y));
+            }
+            auto const theta = std::acos(z);
+
+            auto const ylm = orbitaldensityrand::Spherical_harmonic(l, m, theta, phi);
+            auto const dylmdtheta = Numerical_diff(theta, [l, m, phi](double th) { return orbitaldensityrand::Spherical_harmonic(l, m, th, phi); });
+            auto const dylmdphi = Numerical_diff(phi, [l, m, theta](double ph) { return orbitaldensityrand::Spherical_harmonic(l, m, theta, ph); });
+
+            return {
+                std::cos(theta) * std::cos(phi) * dylmdtheta / ylm - std::sin(phi) / std::sin(theta) * dylmdphi / ylm,
+                std::cos(theta) * std::sin(phi) * dylmdtheta / ylm + std::cos(phi) / std::sin(theta) * dylmdphi / ylm,
+                -std::sin(theta) * dylmdtheta / ylm };
+        }
+
+        //! A function.
+        /*!
+            realylm::RealYlm::Gradientで、r = 1のときのドリフト項の角度部分∇Y/Yを求める
+            \param ylm 実関数表示の球面調和関数
+            \param x 単位ベクトルのx成分
+            \param y 単位ベクトルのy成分
+            \param z 単位ベクトルのz成分
+            \return ドリフト項の角度部分
+        */
+        std::array<double, 3> Drift_analytic(realylm::RealYlm const & ylm, double x, double y, double z)
+        {
+            std::array<double, 3> grad;
+            auto const ylmval = ylm.Gradient(x, y, z, grad);
+            auto const ugrad = x * grad[0] + y * grad[1] + z * grad[2];
+
+            return { (grad[0] - ugrad * x) / ylmval, (grad[1] - ugrad * y) / ylmval, (grad[2] - ugrad * z) / ylmval };
+        }
+    }
+
+    bool Drift_benchmark()
+    {
+        myrandom::MyRandSfmt mr(1U);
+
+        std::vector<double> xs(NPOINTS), ys(NPOINTS), zs(NPOINTS);
+        for (auto i = 0; i < NPOINTS; i++) {
+            auto const x = mr.normal_distribution_rand();
+            auto const y = mr.normal_distribution_rand();
+            auto const z = mr.normal_distribution_rand();
+            auto const r = std::sqrt(x * x + y * y + z * z);
+
+            xs[i] = x / r;
+            ys[i] = y / r;
+            zs[i] = z / r;
+        }
+
+        std::printf("Nelson drift (angular part): %d points per (l, m)\n", NPOINTS);
+        std::printf(" l  m  numerical (ns/call)  analytic (ns/call)  speedup  median rel. diff\n");
+
+        auto passed = true;
+        for (auto l = 1; l <= 3; l++) {
+            for (auto m = -l; m <= l; m++) {
+                std::vector<std::array<double, 3>> ref(NPOINTS), res(NPOINTS);
+
+                auto const tnum = Measure([&] {
+                    for (auto i = 0; i < NPOINTS; i++) {
+                        ref[i] = Drift_from_angles(l, m, xs[i], ys[i], zs[i]);
+                    }
+                });
+
+                realylm::RealYlm const ylm(l, m);
+                auto const tana = Measure([&] {
+                    for (auto i = 0; i < NPOINTS; i++) {
+                        res[i] = Drift_analytic(ylm, xs[i], ys[i], zs[i]);
+                    }
+                });
+
+                // 節面の近くでは数値微分が桁落ちするので、相対誤差の中央値で比較する
+                std::vector<double> reldiff(NPOINTS);
+                for (auto i = 0; i < NPOINTS; i++) {
+                    auto maxdiff = 0.0;
+                    auto maxval = 0.0;
+                    for (auto j = 0; j < 3; j++) {
+                        maxdiff = std::max(maxdiff, std::fabs(ref[i][j] - res[i][j]));
+                        maxval = std::max(maxval, std::fabs(res[i][j]));
+                    }
+                    reldiff[i] = maxdiff / std::max(maxval, 1.0);
+                }
+                std::nth_element(reldiff.begin(), reldiff.begin() + NPOINTS / 2, reldiff.end());
+
+                std::printf("%2d %2d  %19.2f  %18.2f  %6.1fx  %.3e\n",
+                    l, m, tnum / NPOINTS * 1.0E9, tana / NPOINTS * 1.0E9, tnum / tana, reldiff[NPOINTS / 2]);
+                passed = passed && reldiff[NPOINTS / 2] <= TOLERANCE;
+            }
+        }
+
+        std::printf(" median rel. diff within %.0e: %s\n", TOLERANCE, passed ? "yes" : "NO");
+
+        return passed;
+    }
+}
@@ -0,0 +1,81 @@
+﻿/*! \file gradientbenchmark.cpp
+    \brief 目標の分布の勾配を使う点群生成（MALA）と、ランダムウォークのメトロポリス・ヘイスティングス法の、1秒あたりの有効サンプルサイズのベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include <cstdio>                               // for std::printf
+#include <memory>                               // for std::make_shared
+#include <tuple>                                // for std::tuple
+#include <utility>                              // for std::pair
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            生成する頂点数
+        */
+        static auto constexpr NVERTEX = 1000000;
+
+        //! A global variable (constant expression).
+        /*!
+            収束したとみなすR-hatの上限
+        */
+        static auto constexpr RHATMAX = 1.05;
+    }
+
+    bool Gradient_benchmark()
+    {
+        using namespace orbitaldensityrand;
+        using nornel_type = OrbitalDensityRand::Normal_Nelson_type;
+
+        std::printf("ESS of r per second for gradient-based samplers: %d vertices (m = 0)\n", NVERTEX);
+        std::printf(" orbital  data  method  time (sec)  accept  step (bohr)      IAT   R-hat      ESS/s  vs mh\n");
+
+        auto passed = true;
+
+        for (auto const & [n, l] : { std::pair{ 1, 0 }, std::pair{ 2, 0 }, std::pair{ 2, 1 }, std::pair{ 3, 0 }, std::pair{ 3, 1 }, std::pair{ 3, 2 },
+                                     std::pair{ 4, 0 }, std::pair{ 4, 1 }, std::pair{ 4, 2 }, std::pair{ 4, 3 } }) {
+            for (auto const rho : { true, false }) {
+                auto const pgd = std::make_shared<getdata::GetData>(Hydrogen_data_file(n, l, rho));
+                auto const reference = Reference_r(*pgd);
+
+                // 動径方向に節のある軌道では、どの方法でも動径方向の殻の間を移りにくいので、節のない軌道（l = n - 1）だけを確かめる
+                auto const check = l == n - 1;
+
+                auto mh = 0.0;
+                for (auto const & [name, nornel] : {
+                    std::tuple{ "mh", nornel_type::NORMAL },
+                    std::tuple{ "mala", nornel_type::MALA } }) {
+                    OrbitalDensityRand odr(pgd);
+                    odr.Vertexsize(NVERTEX);
+                    odr.Seed(1U);
+
+                    auto const t = Measure([&odr, nornel = nornel] {
+                        odr(0, nornel);
+                        odr.Pth()->join();
+                    });
+                    auto const diag = odr.Diagnose(nornel);
+                    auto const esspersec = diag.ess / t;
+                    if (nornel == nornel_type::NORMAL) {
+                        mh = esspersec;
+                    }
+
+                    std::printf("      %d%c  %4s  %-6s  %10.3f  %6.3f  %11.3f  %7.3f  %6.4f  %9.2e  %5.2f\n",
+                        n, "spdf"[l], rho ? "rho" : "wf", name, t, odr.Acceptance_rate(), odr.Proposal_sigma(),
+                        diag.iat, diag.rhat, esspersec, esspersec / mh);
+
+                    if (check) {
+                        passed = passed && diag.rhat <= RHATMAX && Check_mean_r(odr, reference, diag.ess).second;
+                    }
+                }
+            }
+        }
+
+        std::printf(" R-hat <= %.2f and <r> within %.0f standard errors of the reference (l = n - 1): %s\n", RHATMAX, NSIGMA, passed ? "yes" : "NO");
+
+        return passed;
+    }
+}
@@ -0,0 +1,93 @@
+﻿/*! \file growbenchmark.cpp
+    \brief 頂点数を増やしたとき（最初から生成し直す方法と、生成済みの頂点に足りない分だけを足す方法）のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include <cstdint>      // for std::uint64_t
+#include <cstdio>       // for std::printf
+#include <cstring>      // for std::memcmp
+#include <memory>       // for std::make_shared
+#include <vector>       // for std::vector
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            最初の頂点数
+        */
+        static auto constexpr NVERTEX = 5000000;
+
+        //! A global variable (constant expression).
+        /*!
+            増やした後の頂点数
+        */
+        static auto constexpr NVERTEXGROWN = 6000000;
+
+        //! A global variable (constant expression).
+        /*!
+            減らした後の頂点数
+        */
+        static auto constexpr NVERTEXSHRUNK = 4000000;
+
+        //! A function.
+        /*!
+            頂点数を変えて再描画し、生成が終わるまで待つ
+            \param odr 乱数生成のオブジェクト
+            \param size 頂点数
+            \return 生成にかかった時間（秒）
+        */
+        double Redraw(orbitaldensityrand::OrbitalDensityRand & odr, std::vector<orbitaldensityrand::SimpleVertex>::size_type size)
+        {
+            odr.Vertexsize(size);
+            odr.Redraw(true);
+            return Measure([&odr] {
+                odr(-2, orbitaldensityrand::OrbitalDensityRand::Normal_Nelson_type::NORMAL);
+                odr.Pth()->join();
+            });
+        }
+    }
+
+    bool Grow_benchmark()
+    {
+        using namespace orbitaldensityrand;
+
+        auto const pgd = std::make_shared<getdata::GetData>(Hydrogen_data_file(3, 2, true));
+
+        // 比較のため、増やした後の頂点数の点群を最初から生成しておく
+        OrbitalDensityRand fresh(pgd);
+        fresh.Seed(1U);
+        auto const tfresh = Redraw(fresh, NVERTEXGROWN);
+
+        OrbitalDensityRand odr(pgd);
+        odr.Seed(1U);
+        Redraw(odr, NVERTEX);
+        auto const generation = static_cast<std::uint64_t>(odr.Generation);
+
+        auto const tgrow = Redraw(odr, NVERTEXGROWN);
+        auto const grown = odr.Vertex().size() == NVERTEXGROWN &&
+            !std::memcmp(odr.Vertex().data(), fresh.Vertex().data(), sizeof(SimpleVertex) * NVERTEXGROWN);
+
+        auto const tshrink = Redraw(odr, NVERTEXSHRUNK);
+        auto const shrunk = odr.Vertex().size() == NVERTEXSHRUNK && odr.Ready_vertexsize == NVERTEXSHRUNK &&
+            !std::memcmp(odr.Vertex().data(), fresh.Vertex().data(), sizeof(SimpleVertex) * NVERTEXSHRUNK);
+
+        // 減らした後に増やし直す場合は、残しておいた頂点をそのまま使う
+        auto const tregrow = Redraw(odr, NVERTEXGROWN);
+        auto const regrown = odr.Vertex().size() == NVERTEXGROWN &&
+            !std::memcmp(odr.Vertex().data(), fresh.Vertex().data(), sizeof(SimpleVertex) * NVERTEXGROWN);
+        auto const samegeneration = odr.Generation == generation;
+
+        std::printf("Vertex count change: 3d electron density, %d -> %d -> %d -> %d vertices\n", NVERTEX, NVERTEXGROWN, NVERTEXSHRUNK, NVERTEXGROWN);
+        std::printf("  regenerate %d from scratch    : %8.3f sec\n", NVERTEXGROWN, tfresh);
+        std::printf("  append %d -> %d        : %8.3f sec (%.1fx)\n", NVERTEX, NVERTEXGROWN, tgrow, tfresh / tgrow);
+        std::printf("  shrink %d -> %d        : %8.3f sec\n", NVERTEXGROWN, NVERTEXSHRUNK, tshrink);
+        std::printf("  grow back %d -> %d     : %8.3f sec\n", NVERTEXSHRUNK, NVERTEXGROWN, tregrow);
+        std::printf("  identical to a fresh cloud (append: %s, shrink: %s, grow back: %s), generation kept: %s\n",
+            grown ? "yes" : "NO", shrunk ? "yes" : "NO", regrown ? "yes" : "NO", samegeneration ? "yes" : "NO");
+
+        return grown && shrunk && regrown && samegeneration;
+    }
+}
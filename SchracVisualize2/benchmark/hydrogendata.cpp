@@ -0,0 +1,85 @@
+﻿/*! \file hydrogendata.cpp
+    \brief ベンチマーク用の水素原子のデータファイルを作成する関数の実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include <cmath>                                    // for std::exp, std::log, std::pow, std::sqrt
+#include <cstdio>                                   // for std::snprintf
+#include <filesystem>                               // for std::filesystem
+#include <fstream>                                  // for std::ofstream
+#include <stdexcept>                                // for std::invalid_argument, std::runtime_error
+#include <boost/math/special_functions/factorials.hpp>  // for boost::math::factorial
+#include <boost/math/special_functions/laguerre.hpp>    // for boost::math::laguerre
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            メッシュの点数
+        */
+        static auto constexpr MESHSIZE = 4000;
+
+        //! A global variable (constant expression).
+        /*!
+            メッシュの最小値
+        */
+        static auto constexpr RMIN = 1.0E-5;
+
+        //! A global variable (constant expression).
+        /*!
+            メッシュの最大値
+        */
+        static auto constexpr RMAX = 200.0;
+
+        //! A function.
+        /*!
+            水素原子の動径波動関数R_nl(r)を求める
+            \param n 主量子数
+            \param l 方位量子数
+            \param r rの値
+            \return 動径波動関数の値
+        */
+        double Hydrogen_radial(std::int32_t n, std::int32_t l, double r)
+        {
+            auto const rho = 2.0 * r / static_cast<double>(n);
+            auto const norm = std::sqrt(
+                std::pow(2.0 / static_cast<double>(n), 3) *
+                boost::math::factorial<double>(n - l - 1) /
+                (2.0 * static_cast<double>(n) * boost::math::factorial<double>(n + l)));
+
+            return norm * std::exp(-rho / 2.0) * std::pow(rho, l) * boost::math::laguerre(n - l - 1, 2 * l + 1, rho);
+        }
+    }
+
+    std::string Hydrogen_data_file(std::int32_t n, std::int32_t l, bool rho)
+    {
+        static char const orbitals[] = "spdfg";
+        if (n < 1 || l < 0 || l >= n || l > 4) {
+            throw std::invalid_argument("量子数の指定が異常です！");
+        }
+
+        // GetDataはファイル名から元素名と軌道を判別するので、Schracと同じ名前にする
+        char filename[32];
+        std::snprintf(filename, sizeof(filename), "%s_H_%d%c.csv", rho ? "rho" : "wf", n, orbitals[l]);
+        auto const path = (std::filesystem::temp_directory_path() / filename).string();
+
+        std::ofstream ofs(path);
+        if (!ofs) {
+            throw std::runtime_error("データファイルを作成できません！");
+        }
+
+        auto const dlogr = std::log(RMAX / RMIN) / static_cast<double>(MESHSIZE - 1);
+        for (auto i = 0; i < MESHSIZE; i++) {
+            auto const r = RMIN * std::exp(dlogr * static_cast<double>(i));
+            auto const val = Hydrogen_radial(n, l, r);
+
+            char line[64];
+            std::snprintf(line, sizeof(line), "%.15e,%.15e\n", r, rho ? val * val : val);
+            ofs << line;
+        }
+
+        return path;
+    }
+}
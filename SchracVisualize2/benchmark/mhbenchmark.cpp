@@ -0,0 +1,90 @@
+﻿/*! \file mhbenchmark.cpp
+    \brief メトロポリス・ヘイスティングス法による点群生成のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include <cmath>    // for std::fabs, std::sqrt
+#include <cstdio>   // for std::printf
+#include <memory>   // for std::make_shared
+#include <utility>  // for std::pair
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            生成する頂点数
+        */
+        static auto constexpr NVERTEX = 5000000;
+
+        //! A global variable (constant expression).
+        /*!
+            提案分布の調整を確かめるときに生成する頂点数
+        */
+        static auto constexpr NVERTEXTUNE = 1000000;
+
+        //! A global variable (constant expression).
+        /*!
+            提案分布の標準偏差を調整するときに、OrbitalDensityRandが目標とする採択率
+        */
+        static auto constexpr TARGETACCEPTANCE = 0.3;
+
+        //! A global variable (constant expression).
+        /*!
+            調整後の採択率の、目標からのずれの許容値
+        */
+        static auto constexpr ACCEPTANCETOLERANCE = 0.05;
+    }
+
+    bool Mh_benchmark()
+    {
+        using namespace orbitaldensityrand;
+
+        std::printf("Metropolis-Hastings: %d vertices (3d, m = 0)\n", NVERTEX);
+        std::printf(" data  chains  time (sec)  Mvertices/s\n");
+
+        for (auto const rho : { true, false }) {
+            auto const pgd = std::make_shared<getdata::GetData>(Hydrogen_data_file(3, 2, rho));
+
+            for (auto const chains : { 1, 4, 8, 16 }) {
+                OrbitalDensityRand odr(pgd);
+                odr.Vertexsize(NVERTEX);
+                odr.Seed(1U);
+                odr.Chains(chains);
+
+                auto const t = Measure([&odr] {
+                    odr(0, OrbitalDensityRand::Normal_Nelson_type::NORMAL);
+                    odr.Pth()->join();
+                });
+
+                std::printf(" %4s  %6d  %10.3f  %11.2f\n", rho ? "rho" : "wf", chains, t, NVERTEX / t * 1.0E-6);
+            }
+        }
+
+        // 広がりの違う軌道で、調整前の標準偏差（R2rhomaxrの平方根）と調整後の標準偏差、採択率を比べる
+        std::printf("Proposal tuning: %d vertices (wave function, m = 0)\n", NVERTEXTUNE);
+        std::printf(" orbital  initial sigma  tuned sigma  acceptance\n");
+
+        auto tuned = true;
+        for (auto const & [n, l] : { std::pair(1, 0), std::pair(2, 1), std::pair(3, 2), std::pair(4, 3), std::pair(6, 0) }) {
+            auto const pgd = std::make_shared<getdata::GetData>(Hydrogen_data_file(n, l, false));
+
+            OrbitalDensityRand odr(pgd);
+            odr.Vertexsize(NVERTEXTUNE);
+            odr.Seed(1U);
+            odr(0, OrbitalDensityRand::Normal_Nelson_type::NORMAL);
+            odr.Pth()->join();
+
+            std::printf(" %6s  %13.3f  %11.3f  %10.3f\n", pgd->Orbital().c_str(), std::sqrt(pgd->R2rhomaxr()),
+                static_cast<double>(odr.Proposal_sigma), static_cast<double>(odr.Acceptance_rate));
+
+            tuned = tuned && std::fabs(odr.Acceptance_rate() - TARGETACCEPTANCE) <= ACCEPTANCETOLERANCE;
+        }
+
+        std::printf(" acceptance within %.2f of %.2f: %s\n", ACCEPTANCETOLERANCE, TARGETACCEPTANCE, tuned ? "yes" : "NO");
+
+        return tuned;
+    }
+}
@@ -0,0 +1,98 @@
+﻿/*! \file packedbenchmark.cpp
+    \brief 頂点の形式（SimpleVertexとPackedVertex）のメモリ使用量と誤差のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include <algorithm>    // for std::max
+#include <cmath>        // for std::fabs
+#include <cstdint>      // for std::int32_t
+#include <cstdio>       // for std::printf
+#include <memory>       // for std::make_shared
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            生成する頂点数
+        */
+        static auto constexpr NVERTEX = 5000000;
+
+        //! A global variable (constant expression).
+        /*!
+            GUIのスライダーの最大の頂点数
+        */
+        static auto constexpr NVERTEXMAX = 50000000;
+
+        //! A function.
+        /*!
+            同じシードで点群を2回生成し、2回目の生成時間を返す
+            \param odr 乱数生成クラスのオブジェクト
+            \param packed 頂点を圧縮した形式で生成するかどうか
+            \return 生成時間（秒）
+        */
+        double Generate(orbitaldensityrand::OrbitalDensityRand & odr, bool packed)
+        {
+            odr.Vertexsize(NVERTEX);
+            odr.Seed(1U);
+            odr.Packed(packed);
+
+            // 1回目は頂点の確保とページフォールトを含むので計測しない
+            odr(-2, orbitaldensityrand::OrbitalDensityRand::Normal_Nelson_type::NORMAL);
+            odr.Pth()->join();
+            odr.Redraw(true);
+
+            return Measure([&odr] {
+                odr(-2, orbitaldensityrand::OrbitalDensityRand::Normal_Nelson_type::NORMAL);
+                odr.Pth()->join();
+            });
+        }
+    }
+
+    bool Packed_benchmark()
+    {
+        using namespace orbitaldensityrand;
+
+        auto const pgd = std::make_shared<getdata::GetData>(Hydrogen_data_file(3, 2, true));
+
+        OrbitalDensityRand odrfloat(pgd);
+        auto const tfloat = Generate(odrfloat, false);
+
+        OrbitalDensityRand odrpacked(pgd);
+        auto const tpacked = Generate(odrpacked, true);
+
+        // 同じシードなので同じ点群になり、違いは圧縮による誤差だけ
+        auto const scale = odrpacked.Rmax();
+        auto maxerror = 0.0;
+        auto clamped = 0;
+        auto signs = true;
+        for (auto i = 0; i < NVERTEX; i++) {
+            auto const & v = odrfloat.Vertex()[i];
+            auto const u = Unpack_vertex(odrpacked.Packed_vertex()[i], scale);
+
+            if (std::fabs(v.Pos.x) > scale || std::fabs(v.Pos.y) > scale || std::fabs(v.Pos.z) > scale) {
+                clamped++;
+            }
+            else {
+                maxerror = std::max({ maxerror, std::fabs(static_cast<double>(u.Pos.x) - v.Pos.x), std::fabs(static_cast<double>(u.Pos.y) - v.Pos.y), std::fabs(static_cast<double>(u.Pos.z) - v.Pos.z) });
+            }
+
+            signs = signs && u.Color.x == v.Color.x && u.Color.y == v.Color.y;
+        }
+
+        auto const mb = [](double bytes) { return bytes / (1024.0 * 1024.0); };
+        auto const bytesfloat = static_cast<double>(odrfloat.Vertex_bytes);
+        auto const bytespacked = static_cast<double>(odrpacked.Vertex_bytes);
+
+        std::printf("Vertex format: %d vertices of the 3d electron density, Rmax = %.3f\n", NVERTEX, scale);
+        std::printf("  format        bytes/vertex  memory (MB)  at %d (MB)  time (sec)\n", NVERTEXMAX);
+        std::printf("  SimpleVertex  %12d  %11.1f  %13.1f  %10.3f\n", static_cast<std::int32_t>(sizeof(SimpleVertex)), mb(bytesfloat), mb(bytesfloat / NVERTEX * NVERTEXMAX), tfloat);
+        std::printf("  PackedVertex  %12d  %11.1f  %13.1f  %10.3f\n", static_cast<std::int32_t>(sizeof(PackedVertex)), mb(bytespacked), mb(bytespacked / NVERTEX * NVERTEXMAX), tpacked);
+        std::printf("  max error %.3e (bound %.3e = %.2e Rmax), %d vertices outside Rmax clamped, signs identical: %s\n",
+            maxerror, Packed_error_bound(scale), Packed_error_bound(scale) / scale, clamped, signs ? "yes" : "NO");
+
+        return maxerror <= Packed_error_bound(scale) && signs;
+    }
+}
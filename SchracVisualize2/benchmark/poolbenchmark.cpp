@@ -0,0 +1,114 @@
+﻿/*! \file poolbenchmark.cpp
+    \brief 磁気量子数ごとの点群のプールと先読みによる、軌道の切り替え時間のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include <chrono>       // for std::chrono
+#include <cstdint>      // for std::int32_t
+#include <cstdio>       // for std::printf
+#include <cstring>      // for std::memcmp
+#include <memory>       // for std::make_shared
+#include <thread>       // for std::this_thread
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            生成する頂点数
+        */
+        static auto constexpr NVERTEX = 2000000;
+
+        //! A global variable (constant expression).
+        /*!
+            最初に表示する軌道の磁気量子数
+        */
+        static auto constexpr MFIRST = -2;
+
+        //! A function.
+        /*!
+            軌道を切り替え、生成が終わる（Completeになる）までの時間を返す
+            \param odr 乱数生成クラスのオブジェクト
+            \param m 磁気量子数
+            \return 切り替えにかかった時間（秒）
+        */
+        double Switch(orbitaldensityrand::OrbitalDensityRand & odr, std::int32_t m)
+        {
+            // GUIと同じく、前の生成（先読み）を止めてから再描画する
+            odr.Thread_end(true);
+            if (odr.Pth()->joinable()) {
+                odr.Pth()->join();
+            }
+            odr.Thread_end(false);
+            odr.Redraw(true);
+
+            return Measure([&odr, m] {
+                odr(m, orbitaldensityrand::OrbitalDensityRand::Normal_Nelson_type::NORMAL);
+                while (!odr.Complete) {
+                    std::this_thread::yield();
+                }
+            });
+        }
+    }
+
+    bool Pool_benchmark()
+    {
+        using namespace orbitaldensityrand;
+
+        auto const pgd = std::make_shared<getdata::GetData>(Hydrogen_data_file(3, 2, true));
+        auto const l = static_cast<std::int32_t>(pgd->L);
+
+        // 先読みしない場合は切り替えるたびに生成し直す
+        OrbitalDensityRand odrplain(pgd);
+        odrplain.Vertexsize(NVERTEX);
+        odrplain.Seed(1U);
+        odrplain(MFIRST, OrbitalDensityRand::Normal_Nelson_type::NORMAL);
+        odrplain.Pth()->join();
+
+        OrbitalDensityRand odr(pgd);
+        odr.Vertexsize(NVERTEX);
+        odr.Seed(1U);
+        odr.Speculative(true);
+
+        auto const tfirst = Measure([&odr] {
+            odr(MFIRST, OrbitalDensityRand::Normal_Nelson_type::NORMAL);
+            while (!odr.Complete) {
+                std::this_thread::yield();
+            }
+        });
+
+        // 残りのmの先読みが終わるのを待つ
+        auto const tspeculate = Measure([&odr] { odr.Pth()->join(); });
+        auto const pooled = static_cast<std::int32_t>(odr.Pool_size);
+        auto const poolmb = static_cast<double>(odr.Pool_bytes) / (1024.0 * 1024.0);
+
+        std::printf("Orbital pool: 3d electron density, %d vertices per orbital\n", NVERTEX);
+        std::printf("  first orbital (m = %d): %.3f sec, then %d siblings speculated in %.3f sec (%.1f MB pooled)\n", MFIRST, tfirst, pooled, tspeculate, poolmb);
+        std::printf("     m  regenerate (sec)  pooled (sec)  hit  identical\n");
+
+        auto passed = true;
+
+        for (auto m = -l; m <= l; m++) {
+            if (m == MFIRST) {
+                continue;
+            }
+
+            auto const tplain = Switch(odrplain, m);
+            odrplain.Pth()->join();
+
+            auto const tpool = Switch(odr, m);
+            auto const hit = static_cast<bool>(odr.Pool_hit);
+            auto const identical = !std::memcmp(odr.Vertex().data(), odrplain.Vertex().data(), sizeof(SimpleVertex) * NVERTEX);
+
+            std::printf("  %4d  %16.3f  %12.4f  %3s  %9s\n", m, tplain, tpool, hit ? "yes" : "NO", identical ? "yes" : "NO");
+            passed = passed && hit && identical;
+        }
+
+        odr.Thread_end(true);
+        odr.Pth()->join();
+
+        return passed;
+    }
+}
@@ -0,0 +1,274 @@
+﻿/*! \file quasibenchmark.cpp
+    \brief 直接生成法と準乱数（スクランブルしたSobol点列）による点群の、頂点数に対する誤差のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include "../orbitaldensityrand/realylm/realylm.h"
+#include <algorithm>                            // for std::max, std::min, std::upper_bound
+#include <array>                                // for std::array
+#include <cmath>                                // for std::abs, std::atan2, std::cos, std::exp, std::log, std::sin, std::sqrt
+#include <cstdio>                               // for std::printf
+#include <memory>                               // for std::make_shared
+#include <vector>                               // for std::vector
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::two_pi
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            磁気量子数（φに依存するようにm = 1のdxz軌道を使う）
+        */
+        static auto constexpr M = 1;
+
+        //! A global variable (constant expression).
+        /*!
+            動径方向のビンの数（各ビンの確率が等しくなるように区切る）
+        */
+        static auto constexpr NRBIN = 8;
+
+        //! A global variable (constant expression).
+        /*!
+            cosθ方向のビンの数
+        */
+        static auto constexpr NUBIN = 8;
+
+        //! A global variable (constant expression).
+        /*!
+            φ方向のビンの数
+        */
+        static auto constexpr NPHIBIN = 16;
+
+        //! A global variable (constant expression).
+        /*!
+            角度方向のビンの確率を中点則で求めるときの、1つのビンの各方向の分割数
+        */
+        static auto constexpr NSUB = 64;
+
+        //! A global variable (constant expression).
+        /*!
+            動径方向の参照値を数値積分で求めるときの分割数
+        */
+        static auto constexpr NQUADRATURE = 200000;
+
+        //! A global variable (constant expression).
+        /*!
+            頂点数ごとに誤差の二乗平均をとるシードの数
+        */
+        static auto constexpr NSEED = 8;
+
+        //! A global variable (constant expression).
+        /*!
+            速度を計測するときの頂点数
+        */
+        static auto constexpr NVERTEXTIME = 4000000;
+
+        //! A struct.
+        /*!
+            点群の誤差を測るための参照値
+        */
+        struct Reference final {
+            //! A public member variable.
+            /*!
+                角度方向の各ビンの確率（cosθ方向のビンの番号 × NPHIBIN + φ方向のビンの番号の順）
+            */
+            std::vector<double> angular;
+
+            //! A public member variable.
+            /*!
+                〈r〉の参照値
+            */
+            double meanr = 0.0;
+
+            //! A public member variable.
+            /*!
+                動径方向のビンの境界（NRBIN - 1個）
+            */
+            std::vector<double> redge;
+
+            //! A public member variable.
+            /*!
+                rの標準偏差の参照値
+            */
+            double sdr = 0.0;
+        };
+
+        //! A function.
+        /*!
+            動径分布 r^2 φ(r)^2 の確率が等しいビンの境界とrの平均と標準偏差、角度分布 |Y_lm|^2（電子密度の場合は|Y_lm|^4）の各ビンの確率を求める
+            \param gd データファイルのオブジェクト
+            \param rho 電子密度のデータかどうか
+            \return 参照値
+        */
+        Reference Make_reference(getdata::GetData const & gd, bool rho)
+        {
+            using namespace boost::math::constants;
+
+            Reference ref;
+
+            // 動径波動関数は原点付近で急に変化するので、対数メッシュで台形公式を使う
+            auto const logrmin = std::log(gd.R_meshmin());
+            auto const dlogr = (std::log(gd.R_meshmax()) - logrmin) / NQUADRATURE;
+            std::vector<double> r(NQUADRATURE + 1), cum(NQUADRATURE + 1);
+            auto num = 0.0, num2 = 0.0, den = 0.0;
+            for (auto i = 0; i <= NQUADRATURE; i++) {
+                r[i] = std::min(std::max(std::exp(logrmin + dlogr * i), gd.R_meshmin()), gd.R_meshmax());
+                auto const phi = gd(r[i]);
+                auto const w = (i == 0 || i == NQUADRATURE ? 0.5 : 1.0) * r[i] * r[i] * phi * phi * r[i];
+                num += w * r[i];
+                num2 += w * r[i] * r[i];
+                den += w;
+                cum[i] = den;
+            }
+            ref.meanr = num / den;
+            ref.sdr = std::sqrt(num2 / den - ref.meanr * ref.meanr);
+
+            for (auto b = 1; b < NRBIN; b++) {
+                auto const it = std::upper_bound(cum.begin(), cum.end(), den * static_cast<double>(b) / NRBIN);
+                ref.redge.push_back(r[it - cum.begin()]);
+            }
+
+            // 角度方向の各ビンの確率は、ビンをNSUB × NSUBに分けた中点則で求める
+            realylm::RealYlm const ylm(static_cast<std::int32_t>(gd.L), M);
+            std::vector<double> x(NPHIBIN * NSUB), y(NPHIBIN * NSUB), z(NPHIBIN * NSUB), val(NPHIBIN * NSUB);
+            ref.angular.assign(NUBIN * NPHIBIN, 0.0);
+            auto total = 0.0;
+            for (auto i = 0; i < NUBIN * NSUB; i++) {
+                auto const u = -1.0 + 2.0 * (i + 0.5) / (NUBIN * NSUB);
+                auto const s = std::sqrt(1.0 - u * u);
+                for (auto j = 0; j < NPHIBIN * NSUB; j++) {
+                    auto const phi = two_pi<double>() * (j + 0.5) / (NPHIBIN * NSUB);
+                    x[j] = s * std::cos(phi);
+                    y[j] = s * std::sin(phi);
+                    z[j] = u;
+                }
+
+                ylm(x.data(), y.data(), z.data(), val.data(), val.size());
+                for (auto j = 0; j < NPHIBIN * NSUB; j++) {
+                    auto const w = rho ? val[j] * val[j] * val[j] * val[j] : val[j] * val[j];
+                    ref.angular[(i / NSUB) * NPHIBIN + j / NSUB] += w;
+                    total += w;
+                }
+            }
+
+            for (auto & p : ref.angular) {
+                p /= total;
+            }
+
+            return ref;
+        }
+
+        //! A function.
+        /*!
+            点群の〈r〉の相対誤差と、(r, cosθ, φ)のビンの頻度の、参照値の確率に対するカイ二乗距離の平方根を求める
+            後者は独立な点なら頂点数をNとしてsqrt(ビンの数 / N)程度になり、点群の見た目のむらの大きさの目安になる
+            \param odr 生成が終わった乱数生成のオブジェクト
+            \param ref 参照値
+            \return 〈r〉の相対誤差とビンの頻度の誤差
+        */
+        std::array<double, 2> Errors(orbitaldensityrand::OrbitalDensityRand const & odr, Reference const & ref)
+        {
+            using namespace boost::math::constants;
+
+            auto const vertex = odr.Vertex();
+            auto const n = vertex.size();
+            std::vector<double> count(NRBIN * NUBIN * NPHIBIN, 0.0);
+            auto sumr = 0.0;
+            for (auto i = 0U; i < n; i++) {
+                auto const & pos = vertex[i].Pos;
+                auto const x = static_cast<double>(pos.x), y = static_cast<double>(pos.y), z = static_cast<double>(pos.z);
+                auto const r = std::sqrt(x * x + y * y + z * z);
+                sumr += r;
+
+                auto const rb = static_cast<std::int32_t>(std::upper_bound(ref.redge.begin(), ref.redge.end(), r) - ref.redge.begin());
+                auto const u = r > 0.0 ? z / r : 0.0;
+                auto const ub = std::min(static_cast<std::int32_t>((u + 1.0) * 0.5 * NUBIN), NUBIN - 1);
+                auto phi = std::atan2(y, x);
+                phi = phi < 0.0 ? phi + two_pi<double>() : phi;
+                auto const pb = std::min(static_cast<std::int32_t>(phi / two_pi<double>() * NPHIBIN), NPHIBIN - 1);
+                count[(rb * NUBIN + ub) * NPHIBIN + pb] += 1.0;
+            }
+
+            auto chi2 = 0.0;
+            for (auto rb = 0; rb < NRBIN; rb++) {
+                for (auto a = 0; a < NUBIN * NPHIBIN; a++) {
+                    auto const p = ref.angular[a] / NRBIN;
+                    if (p > 0.0) {
+                        auto const f = count[rb * NUBIN * NPHIBIN + a] / static_cast<double>(n);
+                        chi2 += (f - p) * (f - p) / p;
+                    }
+                }
+            }
+
+            return { std::abs(sumr / static_cast<double>(n) - ref.meanr) / ref.meanr, std::sqrt(chi2) };
+        }
+    }
+
+    bool Quasi_benchmark()
+    {
+        using namespace orbitaldensityrand;
+
+        std::printf("Direct sampling vs scrambled Sobol: RMS error over %d seeds (3d, m = %d, %d bins)\n", NSEED, M, NRBIN * NUBIN * NPHIBIN);
+        std::printf(" data  vertices   direct: <r> err  bin err   quasi: <r> err  bin err   bin err ratio^2\n");
+
+        auto meanr = true;
+        auto binerr = true;
+
+        for (auto const rho : { true, false }) {
+            auto const pgd = std::make_shared<getdata::GetData>(Hydrogen_data_file(3, 2, rho));
+            auto const ref = Make_reference(*pgd, rho);
+
+            for (auto const n : { 1 << 14, 1 << 16, 1 << 18, 1 << 20 }) {
+                std::array<double, 4> sum2 = {};
+                for (auto seed = 1U; seed <= NSEED; seed++) {
+                    for (auto const nornel : { OrbitalDensityRand::Normal_Nelson_type::DIRECT, OrbitalDensityRand::Normal_Nelson_type::QUASI }) {
+                        OrbitalDensityRand odr(pgd);
+                        odr.Vertexsize(n);
+                        odr.Seed(seed);
+                        odr(M, nornel);
+                        odr.Pth()->join();
+
+                        auto const [er, ebin] = Errors(odr, ref);
+                        auto const offset = nornel == OrbitalDensityRand::Normal_Nelson_type::DIRECT ? 0 : 2;
+                        sum2[offset] += er * er;
+                        sum2[offset + 1] += ebin * ebin;
+                    }
+                }
+
+                for (auto & s : sum2) {
+                    s = std::sqrt(s / NSEED);
+                }
+
+                // 〈r〉の相対誤差は、独立な点の標準誤差の上限を超えてはならず、準乱数のビンの頻度の誤差は独立な点より小さくなければならない
+                auto const bound = NSIGMA * ref.sdr / (ref.meanr * std::sqrt(static_cast<double>(n)));
+                meanr = meanr && sum2[0] <= bound && sum2[2] <= bound;
+                binerr = binerr && sum2[3] < sum2[1];
+
+                // 独立な点の誤差は頂点数の平方根に反比例するので、誤差の比の2乗は同じ誤差に必要な頂点数の比になる
+                std::printf(" %4s  %8d   %14.2e  %7.4f   %13.2e  %7.4f   %15.1f\n",
+                    rho ? "rho" : "wf", n, sum2[0], sum2[1], sum2[2], sum2[3], (sum2[1] / sum2[3]) * (sum2[1] / sum2[3]));
+            }
+        }
+
+        std::printf(" mode    time (sec)  Mvertices/s  (%d vertices, wf)\n", NVERTEXTIME);
+        auto const pgd = std::make_shared<getdata::GetData>(Hydrogen_data_file(3, 2, false));
+        for (auto const nornel : { OrbitalDensityRand::Normal_Nelson_type::DIRECT, OrbitalDensityRand::Normal_Nelson_type::QUASI }) {
+            OrbitalDensityRand odr(pgd);
+            odr.Vertexsize(NVERTEXTIME);
+            odr.Seed(1U);
+
+            auto const t = Measure([&odr, nornel] {
+                odr(M, nornel);
+                odr.Pth()->join();
+            });
+
+            std::printf(" %6s  %10.3f  %11.2f\n", nornel == OrbitalDensityRand::Normal_Nelson_type::DIRECT ? "direct" : "quasi", t, NVERTEXTIME / t * 1.0E-6);
+        }
+
+        std::printf(" <r> err within %.0f standard errors: %s, quasi bin err below direct: %s\n", NSIGMA, meanr ? "yes" : "NO", binerr ? "yes" : "NO");
+
+        return meanr && binerr;
+    }
+}
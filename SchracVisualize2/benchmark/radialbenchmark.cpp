@@ -0,0 +1,104 @@
+﻿/*! \file radialbenchmark.cpp
+    \brief 動径関数の補間（gsl_splineとgetdata::RadialTable）のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/getdata/getdata.h"
+#include "../orbitaldensityrand/myrandom/myrandsfmt.h"
+#include <algorithm>    // for std::max
+#include <cmath>        // for std::exp, std::fabs, std::log
+#include <cstdio>       // for std::printf
+#include <vector>       // for std::vector
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            評価する点の数
+        */
+        static auto constexpr NPOINTS = 4000000;
+
+        //! A global variable (constant expression).
+        /*!
+            gsl_splineの値との相対誤差の許容値（同じ3次多項式を別の形で評価しているだけなので、丸め誤差の範囲に収まる）
+        */
+        static auto constexpr TOLERANCE = 1.0E-10;
+
+        //! A function.
+        /*!
+            相対誤差の最大値を求める（分母が小さい点では絶対誤差を使う）
+            \param ref 参照値
+            \param res 比較する値
+            \return 相対誤差の最大値
+        */
+        double Max_rel_diff(std::vector<double> const & ref, std::vector<double> const & res)
+        {
+            auto maxref = 0.0;
+            for (auto const v : ref) {
+                maxref = std::max(maxref, std::fabs(v));
+            }
+
+            auto maxdiff = 0.0;
+            for (auto i = 0U; i < ref.size(); i++) {
+                maxdiff = std::max(maxdiff, std::fabs(ref[i] - res[i]) / std::max(std::fabs(ref[i]), 1.0E-8 * maxref));
+            }
+
+            return maxdiff;
+        }
+    }
+
+    bool Radial_benchmark()
+    {
+        getdata::GetData const gd(Hydrogen_data_file(3, 2, false));
+        auto const & table = gd.Radial_table();
+
+        // メッシュの範囲内で対数一様にrを選ぶ
+        myrandom::MyRandSfmt mr(1U);
+        auto const logrmin = std::log(gd.R_meshmin());
+        auto const logrmax = std::log(gd.R_meshmax());
+        std::vector<double> radii(NPOINTS);
+        for (auto && r : radii) {
+            r = std::exp(logrmin + (logrmax - logrmin) * mr.myrand());
+        }
+
+        std::vector<double> phiref(NPOINTS), dphiref(NPOINTS);
+        auto const acc = getdata::GetData::Make_accel();
+        auto const tgsl = Measure([&] {
+            for (auto i = 0; i < NPOINTS; i++) {
+                phiref[i] = gd(radii[i], acc.get());
+                dphiref[i] = gd.dphidr(radii[i], acc.get());
+            }
+        });
+
+        std::vector<double> phiscalar(NPOINTS), dphiscalar(NPOINTS);
+        auto const tscalar = Measure([&] {
+            for (auto i = 0; i < NPOINTS; i++) {
+                phiscalar[i] = table(radii[i]);
+                dphiscalar[i] = table.dphidr(radii[i]);
+            }
+        });
+
+        std::vector<double> phibatch(NPOINTS), dphibatch(NPOINTS);
+        auto const tbatch = Measure([&] {
+            table(radii.data(), phibatch.data(), dphibatch.data(), radii.size());
+        });
+
+        std::printf("Radial interpolation: %d points, log mesh: %s, AVX2: %s\n",
+            NPOINTS, table.Is_log_mesh() ? "yes" : "no", getdata::RadialTable::Use_avx2() ? "yes" : "no");
+        std::printf("                         ns/point  speedup  max rel. diff (phi)  max rel. diff (dphi/dr)\n");
+        std::printf(" gsl_spline (value+deriv)  %7.2f     1.0x\n", tgsl / NPOINTS * 1.0E9);
+        std::printf(" RadialTable (scalar)      %7.2f  %6.1fx  %19.3e  %23.3e\n",
+            tscalar / NPOINTS * 1.0E9, tgsl / tscalar, Max_rel_diff(phiref, phiscalar), Max_rel_diff(dphiref, dphiscalar));
+        std::printf(" RadialTable (batch)       %7.2f  %6.1fx  %19.3e  %23.3e\n",
+            tbatch / NPOINTS * 1.0E9, tgsl / tbatch, Max_rel_diff(phiref, phibatch), Max_rel_diff(dphiref, dphibatch));
+
+        auto const passed =
+            Max_rel_diff(phiref, phiscalar) <= TOLERANCE && Max_rel_diff(dphiref, dphiscalar) <= TOLERANCE &&
+            Max_rel_diff(phiref, phibatch) <= TOLERANCE && Max_rel_diff(dphiref, dphibatch) <= TOLERANCE;
+        std::printf(" max rel. diff within %.0e: %s\n", TOLERANCE, passed ? "yes" : "NO");
+
+        return passed;
+    }
+}
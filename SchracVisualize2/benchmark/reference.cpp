@@ -0,0 +1,57 @@
+﻿/*! \file reference.cpp
+    \brief ベンチマークで点群の〈r〉を確かめるための関数の実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include <algorithm>    // for std::max, std::min
+#include <cmath>        // for std::exp, std::fabs, std::log, std::sqrt
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            〈r〉の参照値を数値積分で求めるときの分割数
+        */
+        static auto constexpr NQUADRATURE = 200000;
+    }
+
+    std::pair<double, bool> Check_mean_r(orbitaldensityrand::OrbitalDensityRand const & odr, std::pair<double, double> const & reference, double ess)
+    {
+        auto const vertex = odr.Vertex();
+        auto const n = vertex.size();
+
+        auto sum = 0.0;
+        for (auto i = 0U; i < n; i++) {
+            auto const & pos = vertex[i].Pos;
+            sum += std::sqrt(static_cast<double>(pos.x) * pos.x + static_cast<double>(pos.y) * pos.y + static_cast<double>(pos.z) * pos.z);
+        }
+
+        auto const mean = sum / static_cast<double>(n);
+        auto const [meanr, sdr] = reference;
+
+        return { mean, std::fabs(mean - meanr) <= NSIGMA * sdr / std::sqrt(ess) };
+    }
+
+    std::pair<double, double> Reference_r(getdata::GetData const & gd)
+    {
+        // 動径波動関数は原点付近で急に変化するので、対数メッシュで台形公式を使う
+        auto const logrmin = std::log(gd.R_meshmin());
+        auto const dlogr = (std::log(gd.R_meshmax()) - logrmin) / NQUADRATURE;
+
+        auto num = 0.0, num2 = 0.0, den = 0.0;
+        for (auto i = 0; i <= NQUADRATURE; i++) {
+            auto const r = std::min(std::max(std::exp(logrmin + dlogr * i), gd.R_meshmin()), gd.R_meshmax());
+            auto const phi = gd(r);
+            auto const w = (i == 0 || i == NQUADRATURE ? 0.5 : 1.0) * r * r * phi * phi * r;
+            num += w * r;
+            num2 += w * r * r;
+            den += w;
+        }
+
+        auto const mean = num / den;
+        return { mean, std::sqrt(num2 / den - mean * mean) };
+    }
+}
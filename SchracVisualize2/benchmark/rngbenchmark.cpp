@@ -0,0 +1,145 @@
+﻿/*! \file rngbenchmark.cpp
+    \brief 正規乱数の生成のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/myrandom/myrandsfmt.h"
+#include <cmath>                                // for std::cos, std::fabs, std::log, std::sin, std::sqrt
+#include <cstdint>                              // for std::uint32_t
+#include <cstdio>                               // for std::printf
+#include <optional>                             // for std::optional
+#include <vector>                               // for std::vector
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::two_pi
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            生成する正規乱数の個数
+        */
+        static auto constexpr NVARIATES = 20000000;
+
+        //! A class.
+        /*!
+            従来のMyRandSfmtと同じく、sfmt_genrand_real1を2回呼んでBox-Muller法で正規乱数を作り、2個目をstd::optionalに取っておくクラス
+        */
+        class ScalarNormal final {
+        public:
+            //! A constructor.
+            /*!
+                唯一のコンストラクタ
+                \param seed 乱数のシード
+            */
+            explicit ScalarNormal(std::uint32_t seed)
+            {
+                sfmt_init_gen_rand(&sfmt_, seed);
+            }
+
+            //! A public member function.
+            /*!
+                平均0、分散1の正規乱数を生成する
+                \return 平均0、分散1の正規乱数
+            */
+            double operator()()
+            {
+                using namespace boost::math::constants;
+
+                if (next_.has_value()) {
+                    auto const res = *next_;
+                    next_ = std::nullopt;
+                    return res;
+                }
+
+                auto const r1 = sfmt_genrand_real1(&sfmt_);
+                auto const r2 = sfmt_genrand_real1(&sfmt_);
+
+                auto const rad = std::sqrt(-2.0 * std::log(r1));
+                next_ = rad * std::sin(two_pi<double>() * r2);
+
+                return rad * std::cos(two_pi<double>() * r2);
+            }
+
+        private:
+            //! A private member variable.
+            /*!
+                生成された乱数
+            */
+            std::optional<double> next_;
+
+            //! A private member variable.
+            /*!
+                乱数エンジン
+            */
+            sfmt_t sfmt_;
+        };
+
+        //! A function.
+        /*!
+            平均と分散を表示し、標準正規分布の平均と分散に一致するか調べる
+            \param name 名前
+            \param t 実行時間（秒）
+            \param x 正規乱数
+            \return 平均と分散が、それぞれの標準誤差（1/√Nと√(2/N)）のNSIGMA倍以内で0と1に一致するかどうか
+        */
+        bool Print(char const * name, double t, std::vector<double> const & x)
+        {
+            auto sum = 0.0;
+            auto sum2 = 0.0;
+            for (auto const v : x) {
+                sum += v;
+                sum2 += v * v;
+            }
+
+            auto const n = static_cast<double>(x.size());
+            auto const mean = sum / n;
+            auto const var = sum2 / n - mean * mean;
+            std::printf(" %-28s  %8.2f  %8.1f  %+.5f  %.5f\n",
+                name, t / NVARIATES * 1.0E9, NVARIATES / t * 1.0E-6, mean, var);
+
+            return std::fabs(mean) <= NSIGMA / std::sqrt(n) && std::fabs(var - 1.0) <= NSIGMA * std::sqrt(2.0 / n);
+        }
+    }
+
+    bool Rng_benchmark()
+    {
+        std::vector<double> x(NVARIATES);
+        auto passed = true;
+
+        std::printf("Normal variates: %d\n", NVARIATES);
+        std::printf(" method                        ns/var.   M var./s  mean      variance\n");
+
+        {
+            ScalarNormal sn(1U);
+            auto const t = Measure([&] {
+                for (auto && v : x) {
+                    v = sn();
+                }
+            });
+            passed = Print("scalar (genrand + optional)", t, x) && passed;
+        }
+
+        {
+            myrandom::MyRandSfmt mr(1U);
+            auto const t = Measure([&] {
+                for (auto && v : x) {
+                    v = mr.normal_distribution_rand();
+                }
+            });
+            passed = Print("MyRandSfmt (scalar API)", t, x) && passed;
+        }
+
+        {
+            myrandom::MyRandSfmt mr(1U);
+            auto const t = Measure([&] {
+                mr.normal_distribution_rand(x.data(), x.size());
+            });
+            passed = Print("MyRandSfmt (bulk API)", t, x) && passed;
+        }
+
+        std::printf(" mean and variance within %.0f sigma of N(0, 1): %s\n", NSIGMA, passed ? "yes" : "NO");
+
+        return passed;
+    }
+}
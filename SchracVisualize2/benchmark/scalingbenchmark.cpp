@@ -0,0 +1,134 @@
+﻿/*! \file scalingbenchmark.cpp
+    \brief 動径関数の補間のスレッド数に対するスケーリングのベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/getdata/getdata.h"
+#include "../orbitaldensityrand/myrandom/myrandsfmt.h"
+#include <algorithm>    // for std::clamp, std::max
+#include <cmath>        // for std::fabs
+#include <cstdint>      // for std::int32_t
+#include <cstdio>       // for std::printf
+#include <thread>       // for std::thread
+#include <vector>       // for std::vector
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            1スレッドあたりの評価回数
+        */
+        static auto constexpr NEVAL = 4000000;
+
+        //! A function.
+        /*!
+            メトロポリス・ヘイスティングス法と同じように少しずつ動くrの列を作る
+            \param gd 動径関数のデータ
+            \param seed 乱数のシード
+            \return rの列
+        */
+        std::vector<double> Make_radii(getdata::GetData const & gd, std::uint32_t seed)
+        {
+            myrandom::MyRandSfmt mr(seed);
+
+            std::vector<double> radii(NEVAL);
+            auto r = gd.R2rhomaxr();
+            for (auto && ri : radii) {
+                r = std::clamp(std::fabs(mr.normal_distribution_rand(r, 1.0)), gd.R_meshmin(), gd.R_meshmax());
+                ri = r;
+            }
+
+            return radii;
+        }
+
+        //! A function.
+        /*!
+            threads本のスレッドで動径関数とその微分を評価し、スループットを求める
+            \param threads スレッド数
+            \param eval 1スレッド分の評価を行う関数
+            \return スループット（百万回/秒）
+        */
+        template <typename FUNCTYPE>
+        double Throughput(std::int32_t threads, FUNCTYPE const & eval)
+        {
+            auto const t = Measure([&] {
+                std::vector<std::thread> thvec;
+                for (auto i = 0; i < threads; i++) {
+                    thvec.emplace_back([&eval, i] { eval(i); });
+                }
+                for (auto && th : thvec) {
+                    th.join();
+                }
+            });
+
+            return static_cast<double>(threads) * NEVAL / t * 1.0E-6;
+        }
+    }
+
+    bool Scaling_benchmark()
+    {
+        getdata::GetData const gd(Hydrogen_data_file(2, 1, false));
+
+        auto const maxthreads = std::max(static_cast<std::int32_t>(std::thread::hardware_concurrency()), 1);
+
+        std::vector<std::vector<double>> radii;
+        for (auto i = 0; i < maxthreads; i++) {
+            radii.push_back(Make_radii(gd, static_cast<std::uint32_t>(i + 1)));
+        }
+
+        // スレッドごとのgsl_interp_accelと、gsl_interp_accelなし（二分探索）の結果がビット単位で一致するか確認する
+        auto identical = true;
+        {
+            auto const acc = getdata::GetData::Make_accel();
+            for (auto const r : radii[0]) {
+                identical = identical && gd(r, acc.get()) == gd(r) && gd.dphidr(r, acc.get()) == gd.dphidr(r);
+            }
+        }
+
+        std::printf("Radial interpolation: %d evaluations per thread, bit-identical: %s\n", NEVAL, identical ? "yes" : "NO");
+        std::printf(" threads  shared accel (M/s)  per-thread accel (M/s)  efficiency\n");
+
+        // 従来の実装と同じく、全スレッドで1つのgsl_interp_accelを共有する（データ競合がある）
+        auto const shared = getdata::GetData::Make_accel();
+        auto const eval_shared = [&](std::int32_t i) {
+            auto sum = 0.0;
+            for (auto const r : radii[i]) {
+                sum += gd(r, shared.get()) + gd.dphidr(r, shared.get());
+            }
+            volatile auto sink = sum;
+            static_cast<void>(sink);
+        };
+
+        auto const eval_local = [&](std::int32_t i) {
+            auto const acc = getdata::GetData::Make_accel();
+            auto sum = 0.0;
+            for (auto const r : radii[i]) {
+                sum += gd(r, acc.get()) + gd.dphidr(r, acc.get());
+            }
+            volatile auto sink = sum;
+            static_cast<void>(sink);
+        };
+
+        // 1, 2, 4, ...と論理コア数
+        std::vector<std::int32_t> threadslist;
+        for (auto threads = 1; threads < maxthreads; threads *= 2) {
+            threadslist.push_back(threads);
+        }
+        threadslist.push_back(maxthreads);
+
+        auto base = 0.0;
+        for (auto const threads : threadslist) {
+            auto const tshared = Throughput(threads, eval_shared);
+            auto const tlocal = Throughput(threads, eval_local);
+            if (threads == 1) {
+                base = tlocal;
+            }
+
+            std::printf("%8d  %18.1f  %22.1f  %9.0f%%\n", threads, tshared, tlocal, tlocal / (base * threads) * 100.0);
+        }
+
+        return identical;
+    }
+}
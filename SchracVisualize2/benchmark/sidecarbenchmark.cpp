@@ -0,0 +1,111 @@
+﻿/*! \file sidecarbenchmark.cpp
+    \brief データファイルの読み込み（テキスト形式と、3次スプラインの係数を含むバイナリ形式）のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/getdata/getdata.h"
+#include <chrono>       // for std::chrono
+#include <cmath>        // for std::exp, std::log
+#include <cstdint>      // for std::int32_t
+#include <cstdio>       // for std::printf, std::snprintf
+#include <filesystem>   // for std::filesystem
+#include <fstream>      // for std::ofstream
+#include <memory>       // for std::unique_ptr
+#include <vector>       // for std::vector
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            合成するデータファイルの行数
+        */
+        static auto constexpr NROW = 1000000;
+
+        //! A global variable (constant expression).
+        /*!
+            補間結果を比較する点の数
+        */
+        static auto constexpr NPOINT = 100000;
+
+        //! A function.
+        /*!
+            rのメッシュの最小値と最大値の間に、比較に使う点を作る
+            \param gd データ
+            \return 比較に使う点
+        */
+        std::vector<double> Make_points(getdata::GetData const & gd)
+        {
+            std::vector<double> r(NPOINT);
+            auto const rmin = static_cast<double>(gd.R_meshmin);
+            auto const rmax = static_cast<double>(gd.R_meshmax);
+            for (auto i = 0; i < NPOINT; i++) {
+                r[i] = rmin + (rmax - rmin) * (static_cast<double>(i) + 0.5) / static_cast<double>(NPOINT);
+            }
+
+            return r;
+        }
+    }
+
+    bool Sidecar_benchmark()
+    {
+        // ファイル名から軌道を判別するので、専用のディレクトリに作る
+        auto const dir = std::filesystem::temp_directory_path() / "SchracVisualize2_sidecarbenchmark";
+        std::filesystem::create_directories(dir);
+        auto const path = dir / "rho_H_1s.csv";
+
+        // Schracと同じ書式（%.15e）で、対数メッシュの合成データを作る
+        {
+            std::ofstream ofs(path, std::ios::binary);
+            auto const dlogr = std::log(200.0 / 1.0E-5) / static_cast<double>(NROW - 1);
+            for (auto i = 0; i < NROW; i++) {
+                auto const r = 1.0E-5 * std::exp(dlogr * static_cast<double>(i));
+
+                char line[64];
+                std::snprintf(line, sizeof(line), "%.15e,%.15e\n", r, 4.0 * r * r * std::exp(-2.0 * r));
+                ofs << line;
+            }
+        }
+
+        auto const filename = path.string();
+        auto const binarypath = getdata::GetData::Binary_path(filename);
+        std::filesystem::remove(binarypath);
+
+        std::unique_ptr<getdata::GetData> csv, binary;
+        auto const tcsv = Measure([&] { csv = std::make_unique<getdata::GetData>(filename); });
+        auto const twrite = Measure([&] { csv->Write_binary(binarypath); });
+        auto const tbinary = Measure([&] { binary = std::make_unique<getdata::GetData>(filename); });
+
+        // 係数表と（遅延して作られる）gsl_splineの値が、テキスト形式から読み込んだ場合と一致するか確認する
+        auto const r = Make_points(*csv);
+        std::vector<double> phicsv(NPOINT), phibinary(NPOINT);
+        static_cast<getdata::RadialTable const &>(csv->Radial_table)(r.data(), phicsv.data(), r.size());
+        static_cast<getdata::RadialTable const &>(binary->Radial_table)(r.data(), phibinary.data(), r.size());
+
+        auto identical = phicsv == phibinary &&
+            csv->Phimax == binary->Phimax &&
+            csv->R2rhomaxr == binary->R2rhomaxr &&
+            csv->Hash == binary->Hash;
+        for (auto i = 0; i < NPOINT && identical; i++) {
+            identical = (*csv)(r[i]) == (*binary)(r[i]) && csv->dphidr(r[i]) == binary->dphidr(r[i]);
+        }
+
+        // 元のデータファイルの方が新しければ、バイナリ形式は使われないことを確認する
+        std::filesystem::last_write_time(path, std::filesystem::last_write_time(binarypath) + std::chrono::seconds(1));
+        getdata::GetData const stale(filename);
+
+        auto const mb = static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0);
+        auto const mbbinary = static_cast<double>(std::filesystem::file_size(binarypath)) / (1024.0 * 1024.0);
+
+        std::printf("Radial data loading: %d mesh points (csv %.1f MB, sv2r %.1f MB)\n", NROW, mb, mbbinary);
+        std::printf("  csv (parse + spline + table): %8.3f sec\n", tcsv);
+        std::printf("  sv2r (mmap)                 : %8.3f sec (%.1fx), written in %.3f sec\n", tbinary, tcsv / tbinary, twrite);
+        std::printf("  loaded from sv2r: %s, identical values: %s, newer csv falls back to parsing: %s\n",
+            binary->From_binary ? "yes" : "NO", identical ? "yes" : "NO", stale.From_binary ? "NO" : "yes");
+
+        std::filesystem::remove_all(dir);
+
+        return binary->From_binary && identical && !stale.From_binary;
+    }
+}
@@ -0,0 +1,82 @@
+﻿/*! \file temperingbenchmark.cpp
+    \brief 複数のローブを持つ軌道の点群生成（メトロポリス・ヘイスティングス法と交換モンテカルロ法）のローブの偏りのベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include <cstdio>                               // for std::printf
+#include <memory>                               // for std::make_shared
+#include <tuple>                                // for std::tuple
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            生成する頂点数
+        */
+        static auto constexpr NVERTEX = 2000000;
+    }
+
+    bool Tempering_benchmark()
+    {
+        using namespace orbitaldensityrand;
+        using nornel_type = OrbitalDensityRand::Normal_Nelson_type;
+
+        std::printf("Lobe balance of multi-lobe orbitals: %d vertices, one window per chunk\n", NVERTEX);
+        std::printf(" orbital   m  data  method        time (sec)  accept    swap  lobes      TV  excess      ESS/s\n");
+
+        auto meanr = true;
+        auto balanced = true;
+
+        // 節の多い軌道ほど、メトロポリス・ヘイスティングス法のチェーンはローブの間を移りにくい
+        for (auto const & [n, l, m] : { std::tuple{ 3, 2, 0 }, std::tuple{ 4, 3, 0 }, std::tuple{ 4, 3, 2 } }) {
+            for (auto const rho : { true, false }) {
+                auto const pgd = std::make_shared<getdata::GetData>(Hydrogen_data_file(n, l, rho));
+                auto const reference = Reference_r(*pgd);
+
+                // 交換モンテカルロ法は、ローブの偏りをメトロポリス・ヘイスティングス法より小さくしなければならない
+                auto mhexcess = 0.0;
+
+                for (auto const & [name, nornel, rungs] : {
+                    std::tuple{ "mh", nornel_type::NORMAL, 0 },
+                    std::tuple{ "tempering 4", nornel_type::TEMPERING, 4 },
+                    std::tuple{ "tempering 8", nornel_type::TEMPERING, 8 },
+                    std::tuple{ "tempering 16", nornel_type::TEMPERING, 16 },
+                    std::tuple{ "direct", nornel_type::DIRECT, 0 } }) {
+                    OrbitalDensityRand odr(pgd);
+                    odr.Vertexsize(NVERTEX);
+                    odr.Seed(1U);
+                    if (rungs) {
+                        odr.Rungs(rungs);
+                    }
+
+                    auto const t = Measure([&odr, m = m, nornel = nornel] {
+                        odr(m, nornel);
+                        odr.Pth()->join();
+                    });
+                    auto const diag = odr.Diagnose(nornel);
+                    auto const balance = odr.Lobe_balance(m);
+
+                    std::printf("      %d%c  %2d  %4s  %-12s  %10.3f  %6.3f  %6.3f  %5zu  %6.4f  %6.2f  %9.2e\n",
+                        n, "spdf"[l], m, rho ? "rho" : "wf", name, t, odr.Acceptance_rate(), odr.Swap_rate(),
+                        balance.lobes, balance.tv, balance.excess, diag.ess / t);
+
+                    meanr = meanr && Check_mean_r(odr, reference, diag.ess).second;
+                    if (nornel == nornel_type::NORMAL) {
+                        mhexcess = balance.excess;
+                    }
+                    else if (nornel == nornel_type::TEMPERING) {
+                        balanced = balanced && balance.excess < mhexcess;
+                    }
+                }
+            }
+        }
+
+        std::printf(" <r> within %.0f standard errors of the reference: %s, tempering lobe excess below mh: %s\n",
+            NSIGMA, meanr ? "yes" : "NO", balanced ? "yes" : "NO");
+
+        return meanr && balanced;
+    }
+}
@@ -0,0 +1,110 @@
+﻿/*! \file uploadbenchmark.cpp
+    \brief 頂点バッファへの転送量（毎フレーム全体を作り直す方法とutility::UploadPlanner）のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include "../orbitaldensityrand/utility/uploadplanner.h"
+#include "../test/mockdevice.h"
+#include <algorithm>    // for std::max
+#include <chrono>       // for std::chrono
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int32_t
+#include <cstdio>       // for std::printf
+#include <cstring>      // for std::memcmp
+#include <memory>       // for std::make_shared
+#include <thread>       // for std::this_thread
+#include <vector>       // for std::vector
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            生成する頂点数
+        */
+        static auto constexpr NVERTEX = 5000000;
+
+        //! A global variable (constant expression).
+        /*!
+            生成が終わった後に描画するフレーム数
+        */
+        static auto constexpr IDLEFRAMES = 60;
+
+        //! A global variable (constant expression).
+        /*!
+            1フレームの時間（ミリ秒）
+        */
+        static auto constexpr FRAMEMS = 16;
+
+        //! A global variable (constant expression).
+        /*!
+            頂点バッファ1個（セグメント）あたりの頂点数（複数のセグメントに分かれるようにGUIより小さくする）
+        */
+        static std::size_t constexpr SEGMENTSIZE = 1 << 20;
+    }
+
+    bool Upload_benchmark()
+    {
+        using namespace orbitaldensityrand;
+
+        OrbitalDensityRand odr(std::make_shared<getdata::GetData>(Hydrogen_data_file(3, 2, true)));
+        odr.Vertexsize(NVERTEX);
+
+        test::MockDevice device(sizeof(SimpleVertex), SEGMENTSIZE);
+        utility::UploadPlanner planner(sizeof(SimpleVertex), SEGMENTSIZE);
+
+        auto frames = 0;
+        std::size_t maxbytes = 0;
+
+        // GUIのRenderPointと同じく、毎フレーム生成を進めて転送計画を実行する
+        auto const frame = [&] {
+            odr(-2, OrbitalDensityRand::Normal_Nelson_type::NORMAL);
+
+            auto const & vertex = odr.Vertex();
+            device.Upload(planner, odr.Generation, vertex.data(), vertex.size(), odr.Ready_vertexsize);
+
+            frames++;
+            maxbytes = std::max(maxbytes, static_cast<std::size_t>(planner.Frame_bytes));
+        };
+
+        auto const t = Measure([&] {
+            do {
+                frame();
+                std::this_thread::sleep_for(std::chrono::milliseconds(FRAMEMS));
+            } while (!odr.Complete);
+
+            // 生成が終わった後の最後の転送
+            frame();
+        });
+
+        auto const genframes = frames;
+        auto const genbytes = static_cast<std::size_t>(planner.Total_bytes);
+
+        for (auto i = 0; i < IDLEFRAMES; i++) {
+            frame();
+        }
+
+        auto const idlebytes = planner.Total_bytes - genbytes;
+        auto const fullbytes = static_cast<double>(sizeof(SimpleVertex)) * NVERTEX * frames;
+        // セグメントをつなげると生成した頂点と一致するか確認する
+        auto identical = device.buffers.size() == planner.Segments(NVERTEX);
+        std::size_t offset = 0;
+        for (auto const & buffer : device.buffers) {
+            identical = identical && offset + buffer.size() <= sizeof(SimpleVertex) * NVERTEX &&
+                !std::memcmp(buffer.data(), reinterpret_cast<unsigned char const *>(odr.Vertex().data()) + offset, buffer.size());
+            offset += buffer.size();
+        }
+        identical = identical && offset == sizeof(SimpleVertex) * NVERTEX;
+
+        std::printf("Vertex upload: %d vertices (%.1f MB) in %d segments, generated in %.3f sec over %d frames, then %d idle frames\n",
+            NVERTEX, sizeof(SimpleVertex) * static_cast<double>(NVERTEX) / (1024.0 * 1024.0), static_cast<std::int32_t>(device.buffers.size()), t, genframes, IDLEFRAMES);
+        std::printf("  CreateBuffer every frame: %10.1f MB\n", fullbytes / (1024.0 * 1024.0));
+        std::printf("  UploadPlanner           : %10.1f MB (max %.1f MB/frame, %.1f MB while idle)\n",
+            static_cast<double>(planner.Total_bytes) / (1024.0 * 1024.0), static_cast<double>(maxbytes) / (1024.0 * 1024.0), static_cast<double>(idlebytes) / (1024.0 * 1024.0));
+        std::printf("  segments match the generated vertices: %s\n", identical ? "yes" : "NO");
+
+        return identical;
+    }
+}
@@ -0,0 +1,110 @@
+﻿/*! \file ylmbenchmark.cpp
+    \brief 実関数表示の球面調和関数のベンチマークの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include "../orbitaldensityrand/realylm/realylm.h"
+#include <algorithm>                            // for std::max
+#include <cmath>                                // for std::acos, std::fabs, std::sqrt
+#include <cstdint>                              // for std::int32_t
+#include <cstdio>                               // for std::printf
+#include <vector>                               // for std::vector
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+
+namespace benchmark {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            評価する点の数
+        */
+        static auto constexpr NPOINTS = 1000000;
+
+        //! A global variable (constant expression).
+        /*!
+            boostの値との差の許容値（acosでθ、φを求める従来の方法の丸め誤差は1.0E-10程度）
+        */
+        static auto constexpr TOLERANCE = 1.0E-9;
+
+        //! A function.
+        /*!
+            FillSimpleVertexの従来の方法（acosでθ、φを求めてからboostで評価する）で球面調和関数を求める
+            \param l 方位量子数
+            \param m 磁気量子数
+            \param x 単位ベクトルのx成分
+            \param y 単位ベクトルのy成分
+            \param z 単位ベクトルのz成分
+            \return 実関数表示の球面調和関数
+        */
+        double Ylm_from_angles(std::int32_t l, std::int32_t m, double x, double y, double z)
+        {
+            auto phi = 0.0;
+            if (std::fabs(y) < 1.0E-15) {
+                if (x < 0.0) {
+                    phi = boost::math::constants::pi<double>();
+                }
+            }
+            else if (x * x + y * y > 0.0) {
+                auto const sign = y > 0 ? 1 : -1;
+                phi = sign * std::acos(x / std::sqrt(x * x + y * y));
+            }
+
+            return orbitaldensityrand::Spherical_harmonic(l, m, std::acos(z), phi);
+        }
+    }
+
+    bool Ylm_benchmark()
+    {
+        myrandom::MyRandSfmt mr(1U);
+
+        std::vector<double> xs(NPOINTS), ys(NPOINTS), zs(NPOINTS);
+        for (auto i = 0; i < NPOINTS; i++) {
+            auto const x = mr.normal_distribution_rand();
+            auto const y = mr.normal_distribution_rand();
+            auto const z = mr.normal_distribution_rand();
+            auto const r = std::sqrt(x * x + y * y + z * z);
+
+            xs[i] = x / r;
+            ys[i] = y / r;
+            zs[i] = z / r;
+        }
+
+        std::printf("Ylm: %d points per (l, m)\n", NPOINTS);
+        std::printf(" l  m   boost (ns/call)  RealYlm (ns/call)  speedup  max |diff|\n");
+
+        auto passed = true;
+        for (auto l = 0; l <= 4; l++) {
+            for (auto m = -l; m <= l; m++) {
+                std::vector<double> ref(NPOINTS), res(NPOINTS);
+
+                auto const tboost = Measure([&] {
+                    for (auto i = 0; i < NPOINTS; i++) {
+                        ref[i] = Ylm_from_angles(l, m, xs[i], ys[i], zs[i]);
+                    }
+                });
+
+                realylm::RealYlm const ylm(l, m);
+                auto const treal = Measure([&] {
+                    for (auto i = 0; i < NPOINTS; i++) {
+                        res[i] = ylm(xs[i], ys[i], zs[i]);
+                    }
+                });
+
+                auto maxdiff = 0.0;
+                for (auto i = 0; i < NPOINTS; i++) {
+                    maxdiff = std::max(maxdiff, std::fabs(ref[i] - res[i]));
+                }
+
+                std::printf("%2d %2d  %15.2f  %17.2f  %6.1fx  %.3e\n",
+                    l, m, tboost / NPOINTS * 1.0E9, treal / NPOINTS * 1.0E9, tboost / treal, maxdiff);
+                passed = passed && maxdiff <= TOLERANCE;
+            }
+        }
+
+        std::printf(" max |diff| within %.0e: %s\n", TOLERANCE, passed ? "yes" : "NO");
+
+        return passed;
+    }
+}
@@ -0,0 +1,507 @@
+﻿/*! \file orbitaldensitycli.cpp
+    \brief OrbitalDensityRandを使って、ウィンドウなしで点群を生成するコマンドラインプログラム
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include <chrono>                       // for std::chrono
+#include <cstddef>                      // for std::size_t
+#include <cstdint>                      // for std::int32_t, std::uint32_t, std::uintmax_t
+#include <cstdlib>                      // for EXIT_FAILURE, EXIT_SUCCESS
+#include <exception>                    // for std::exception
+#include <filesystem>                   // for std::filesystem::path
+#include <fstream>                      // for std::ofstream
+#include <iostream>                     // for std::cerr, std::cout
+#include <map>                          // for std::map
+#include <memory>                       // for std::make_shared, std::shared_ptr
+#include <optional>                     // for std::optional
+#include <stdexcept>                    // for std::invalid_argument, std::logic_error, std::runtime_error
+#include <string>                       // for std::string, std::stod, std::stoi, std::stoul, std::stoull
+#include <boost/algorithm/string.hpp>   // for boost::algorithm::ends_with, boost::algorithm::to_upper_copy
+
+namespace {
+    using namespace orbitaldensityrand;
+
+    //! A struct.
+    /*!
+        コマンドライン引数を格納する構造体
+    */
+    struct Options {
+        //! A public member variable.
+        /*!
+            点群のキャッシュのディレクトリ（空の場合はキャッシュを使わない）
+        */
+        std::string cachedir;
+
+        //! A public member variable.
+        /*!
+            バイナリ形式に変換するデータファイル名（空の場合は変換しない）
+        */
+        std::string convertfile;
+
+        //! A public member variable.
+        /*!
+            Schracの出力したデータファイル名
+        */
+        std::string filename;
+
+        //! A public member variable.
+        /*!
+            磁気量子数
+        */
+        std::int32_t m = 0;
+
+        //! A public member variable.
+        /*!
+            生成する頂点数（std::nulloptの場合はOrbitalDensityRandの初期値）
+        */
+        std::optional<std::vector<SimpleVertex>::size_type> n;
+
+        //! A public member variable.
+        /*!
+            Nelsonの確率力学を使うかどうか
+        */
+        OrbitalDensityRand::Normal_Nelson_type nornel = OrbitalDensityRand::Normal_Nelson_type::NORMAL;
+
+        //! A public member variable.
+        /*!
+            頂点を圧縮した形式（PackedVertex）で生成するかどうか
+        */
+        bool packed = false;
+
+        //! A public member variable.
+        /*!
+            乱数のシード
+        */
+        std::optional<std::uint32_t> seed;
+
+        //! A public member variable.
+        /*!
+            スレッド数
+        */
+        std::optional<std::int32_t> threads;
+
+        //! A public member variable.
+        /*!
+            1スレッドあたりのマルコフ連鎖の数
+        */
+        std::optional<std::int32_t> chains;
+
+        //! A public member variable.
+        /*!
+            交換モンテカルロ法の梯子の段数
+        */
+        std::optional<std::int32_t> rungs;
+
+        //! A public member variable.
+        /*!
+            バーンインのステップ数
+        */
+        std::optional<std::int32_t> burnin;
+
+        //! A public member variable.
+        /*!
+            間引きの間隔
+        */
+        std::optional<std::int32_t> thinning;
+
+        //! A public member variable.
+        /*!
+            生成した点群の自己相関時間、ESSとR-hatを表示するかどうか
+        */
+        bool diagnose = false;
+
+        //! A public member variable.
+        /*!
+            時間刻み（アト秒）
+        */
+        std::optional<double> dt;
+
+        //! A public member variable.
+        /*!
+            出力ファイル名
+        */
+        std::string outfile;
+    };
+
+    //! A function.
+    /*!
+        使い方を表示する
+        \param progname プログラム名
+    */
+    void Print_usage(char const * progname)
+    {
+        std::cerr << "Usage: " << progname << " --file <wf_H_2p.csv> --out <points.csv|points.bin> [options]\n"
+                  << "       " << progname << " --convert <wf_H_2p.csv>\n"
+                  << "  --m <m>             magnetic quantum number (default: 0)\n"
+                  << "  --n <count>         number of samples (default: same as the GUI)\n"
+                  << "  --mode NORMAL|NELSON|DIRECT|QUASI|TEMPERING|MALA\n"
+                  << "                      sampling mode (default: NORMAL, DIRECT draws independent samples,\n"
+                  << "                      QUASI maps a scrambled Sobol sequence,\n"
+                  << "                      TEMPERING swaps states along a ladder of tempered chains,\n"
+                  << "                      MALA moves along the gradient of log |psi|^2)\n"
+                  << "  --seed <seed>       random seed (default: std::random_device)\n"
+                  << "  --threads <count>   worker threads (default: hardware concurrency)\n"
+                  << "  --chains 1|4|8|16   Markov chains per thread for NORMAL and MALA (default: 8)\n"
+                  << "  --rungs 4|8|16      tempered chains per ladder for TEMPERING (default: 8)\n"
+                  << "  --burnin <steps>    steps each chain discards before it starts writing for Markov chain modes (default: 64)\n"
+                  << "  --thin <n>          write every n-th step of each chain for Markov chain modes (default: 1)\n"
+                  << "  --diagnose YES|NO   print the autocorrelation time, ESS, R-hat of r and the lobe balance (default: NO)\n"
+                  << "  --dt <attosec>      time step for NELSON (default: 0.1)\n"
+                  << "  --vertex FLOAT|PACKED\n"
+                  << "                      in-memory vertex format (default: FLOAT)\n"
+                  << "  --cache <dir>       reuse clouds stored in <dir> (needs --seed)\n"
+                  << "  --convert <file>    write the binary radial data (*.sv2r) next to <file> and exit\n"
+                  << "Output format is CSV (x,y,z,sign) for *.csv and raw SimpleVertex (or PackedVertex) records otherwise.\n";
+    }
+
+    //! A function.
+    /*!
+        コマンドライン引数を一つ解析する
+        \param opt 解析結果を格納する構造体
+        \param key 引数の名前（先頭の"--"を除く）
+        \param value 引数の値
+        \return 解析に成功したかどうか
+        \exception std::invalid_argument 数値に変換できなかった場合
+        \exception std::out_of_range 数値が範囲外の場合
+    */
+    bool Parse_option(Options & opt, std::string const & key, std::string const & value)
+    {
+        if (key == "cache") {
+            opt.cachedir = value;
+        }
+        else if (key == "convert") {
+            opt.convertfile = value;
+        }
+        else if (key == "file") {
+            opt.filename = value;
+        }
+        else if (key == "m") {
+            opt.m = std::stoi(value);
+        }
+        else if (key == "n") {
+            opt.n = static_cast<std::vector<SimpleVertex>::size_type>(std::stoull(value));
+        }
+        else if (key == "mode") {
+            auto const mode = boost::algorithm::to_upper_copy(value);
+            if (mode == "NORMAL") {
+                opt.nornel = OrbitalDensityRand::Normal_Nelson_type::NORMAL;
+            }
+            else if (mode == "NELSON") {
+                opt.nornel = OrbitalDensityRand::Normal_Nelson_type::NELSON;
+            }
+            else if (mode == "DIRECT") {
+                opt.nornel = OrbitalDensityRand::Normal_Nelson_type::DIRECT;
+            }
+            else if (mode == "QUASI") {
+                opt.nornel = OrbitalDensityRand::Normal_Nelson_type::QUASI;
+            }
+            else if (mode == "TEMPERING") {
+                opt.nornel = OrbitalDensityRand::Normal_Nelson_type::TEMPERING;
+            }
+            else if (mode == "MALA") {
+                opt.nornel = OrbitalDensityRand::Normal_Nelson_type::MALA;
+            }
+            else {
+                return false;
+            }
+        }
+        else if (key == "seed") {
+            opt.seed = static_cast<std::uint32_t>(std::stoul(value));
+        }
+        else if (key == "threads") {
+            opt.threads = std::stoi(value);
+        }
+        else if (key == "chains") {
+            opt.chains = std::stoi(value);
+        }
+        else if (key == "rungs") {
+            opt.rungs = std::stoi(value);
+        }
+        else if (key == "burnin") {
+            opt.burnin = std::stoi(value);
+            if (*opt.burnin < 0) {
+                return false;
+            }
+        }
+        else if (key == "thin") {
+            opt.thinning = std::stoi(value);
+            if (*opt.thinning < 1) {
+                return false;
+            }
+        }
+        else if (key == "diagnose") {
+            auto const diagnose = boost::algorithm::to_upper_copy(value);
+            if (diagnose == "YES") {
+                opt.diagnose = true;
+            }
+            else if (diagnose == "NO") {
+                opt.diagnose = false;
+            }
+            else {
+                return false;
+            }
+        }
+        else if (key == "dt") {
+            opt.dt = std::stod(value);
+        }
+        else if (key == "vertex") {
+            auto const vertex = boost::algorithm::to_upper_copy(value);
+            if (vertex == "FLOAT") {
+                opt.packed = false;
+            }
+            else if (vertex == "PACKED") {
+                opt.packed = true;
+            }
+            else {
+                return false;
+            }
+        }
+        else if (key == "out") {
+            opt.outfile = value;
+        }
+        else {
+            return false;
+        }
+
+        return true;
+    }
+
+    //! A function.
+    /*!
+        コマンドライン引数を解析する
+        \param argc コマンドライン引数の数
+        \param argv コマンドライン引数
+        \return 解析結果（失敗した場合はstd::nullopt）
+        \exception std::invalid_argument 引数の値が数値に変換できないか、範囲外の場合
+    */
+    std::optional<Options> Parse_options(int argc, char * argv[])
+    {
+        std::map<std::string, std::string> args;
+        for (auto i = 1; i < argc; i += 2) {
+            std::string const key(argv[i]);
+            if (key.rfind("--", 0) != 0 || i + 1 >= argc) {
+                return std::nullopt;
+            }
+
+            args[key.substr(2)] = argv[i + 1];
+        }
+
+        Options opt;
+        for (auto const & [key, value] : args) {
+            try {
+                if (!Parse_option(opt, key, value)) {
+                    return std::nullopt;
+                }
+            }
+            catch (std::logic_error const &) {
+                // std::stoiなどが投げるstd::invalid_argumentとstd::out_of_rangeは、どの引数が悪いのかを添えて投げ直す
+                throw std::invalid_argument("--" + key + " の値が異常です: " + value);
+            }
+        }
+
+        // 変換するだけなら、他の引数はいらない
+        if (!opt.convertfile.empty()) {
+            return std::make_optional(opt);
+        }
+
+        if (opt.filename.empty() || opt.outfile.empty()) {
+            return std::nullopt;
+        }
+
+        return std::make_optional(opt);
+    }
+
+    //! A function.
+    /*!
+        データファイルを読み込む
+        \param filename データファイル名
+        \return 読み込んだデータ
+        \exception std::runtime_error データファイルが読めないか、数値として解析できない場合
+    */
+    std::shared_ptr<getdata::GetData> Load_data(std::string const & filename)
+    {
+        try {
+            return std::make_shared<getdata::GetData>(filename);
+        }
+        catch (std::logic_error const &) {
+            // 数値の解析に失敗したときに投げられるstd::invalid_argumentとstd::out_of_rangeだけがcsvファイルの異常
+            throw std::runtime_error("csvファイルが異常です！");
+        }
+    }
+
+    //! A function.
+    /*!
+        頂点をCSV形式（x,y,z,波動関数の符号）で書き出す
+        \param ofs 出力ストリーム
+        \param vertex 頂点
+        \param size 書き出す頂点数
+    */
+    void Write_csv(std::ofstream & ofs, VertexView<SimpleVertex> const & vertex, std::size_t size)
+    {
+        for (auto i = 0U; i < size; i++) {
+            auto const & v = vertex[i];
+            ofs << v.Pos.x << ',' << v.Pos.y << ',' << v.Pos.z << ',' << (v.Color.y > 0.0f ? -1 : 1) << '\n';
+        }
+    }
+
+    //! A function.
+    /*!
+        圧縮した頂点を元に戻して、CSV形式（x,y,z,波動関数の符号）で書き出す
+        \param ofs 出力ストリーム
+        \param vertex 圧縮した頂点
+        \param size 書き出す頂点数
+        \param scale 座標の最大値（Rmax）
+    */
+    void Write_csv(std::ofstream & ofs, VertexView<PackedVertex> const & vertex, std::size_t size, double scale)
+    {
+        for (auto i = 0U; i < size; i++) {
+            auto const v = Unpack_vertex(vertex[i], scale);
+            ofs << v.Pos.x << ',' << v.Pos.y << ',' << v.Pos.z << ',' << (vertex[i].w < 0 ? -1 : 1) << '\n';
+        }
+    }
+
+    //! A function (template function).
+    /*!
+        頂点をSimpleVertex（またはPackedVertex）のバイナリのまま書き出す
+        \tparam T 頂点の型
+        \param ofs 出力ストリーム
+        \param vertex 頂点
+        \param size 書き出す頂点数
+    */
+    template <typename T>
+    void Write_binary(std::ofstream & ofs, VertexView<T> const & vertex, std::size_t size)
+    {
+        ofs.write(reinterpret_cast<char const *>(vertex.data()), static_cast<std::streamsize>(sizeof(T) * size));
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    try {
+        std::optional<Options> opt;
+        try {
+            opt = Parse_options(argc, argv);
+        }
+        catch (std::exception const & e) {
+            std::cerr << e.what() << '\n';
+        }
+
+        if (!opt) {
+            Print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        if (!opt->convertfile.empty()) {
+            auto const pgd = Load_data(opt->convertfile);
+            auto const path = getdata::GetData::Binary_path(opt->convertfile);
+            pgd->Write_binary(path);
+            std::cerr << "Wrote " << path << '\n';
+            return EXIT_SUCCESS;
+        }
+
+        auto const pgd = Load_data(opt->filename);
+        if (static_cast<std::uint32_t>(opt->m < 0 ? -opt->m : opt->m) > pgd->L) {
+            std::cerr << "|m| must not exceed l = " << pgd->L << '\n';
+            return EXIT_FAILURE;
+        }
+
+        OrbitalDensityRand odr(pgd);
+        if (opt->n) {
+            odr.Vertexsize(*opt->n);
+        }
+        if (opt->threads) {
+            odr.Threads(*opt->threads);
+        }
+        if (opt->chains) {
+            odr.Chains(*opt->chains);
+        }
+        if (opt->rungs) {
+            odr.Rungs(*opt->rungs);
+        }
+        if (opt->burnin) {
+            odr.Burnin(*opt->burnin);
+        }
+        if (opt->thinning) {
+            odr.Thinning(*opt->thinning);
+        }
+        if (opt->dt) {
+            odr.Dt(*opt->dt);
+        }
+        odr.Seed(opt->seed);
+        odr.Packed(opt->packed);
+        if (!opt->cachedir.empty()) {
+            odr.Cache(std::make_shared<samplecache::SampleCache>(std::filesystem::path(opt->cachedir), samplecache::SampleCache::MAXBYTES_INIT_VALUE));
+        }
+
+        auto const start = std::chrono::steady_clock::now();
+
+        odr(opt->m, opt->nornel);
+        odr.Pth()->join();
+
+        auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::ofstream ofs(opt->outfile, std::ios::binary);
+        if (!ofs) {
+            throw std::runtime_error("出力ファイルが開けません！");
+        }
+
+        auto const csv = boost::algorithm::ends_with(opt->outfile, ".csv");
+        if (opt->packed) {
+            csv ? Write_csv(ofs, odr.Packed_vertex(), odr.Vertexsize, odr.Rmax) : Write_binary(ofs, odr.Packed_vertex(), odr.Vertexsize);
+        }
+        else {
+            csv ? Write_csv(ofs, odr.Vertex(), odr.Vertexsize) : Write_binary(ofs, odr.Vertex(), odr.Vertexsize);
+        }
+
+        std::cout << pgd->Atomname() << ' ' << pgd->Orbital() << " (m = " << opt->m << "): "
+                  << odr.Vertexsize() << " vertices in " << elapsed << " sec" << std::endl;
+
+        if (!opt->cachedir.empty()) {
+            std::cout << "cache: " << (odr.Cache_hit ? "hit" : "miss") << std::endl;
+        }
+
+        std::cout << "vertex memory: " << static_cast<double>(odr.Vertex_bytes) / (1024.0 * 1024.0) << " MB";
+        if (opt->packed) {
+            std::cout << " (packed, error bound " << Packed_error_bound(odr.Rmax) << " bohr)";
+        }
+        std::cout << std::endl;
+
+        auto const tempering = opt->nornel == OrbitalDensityRand::Normal_Nelson_type::TEMPERING;
+        auto const gradient = opt->nornel == OrbitalDensityRand::Normal_Nelson_type::MALA;
+        if ((opt->nornel == OrbitalDensityRand::Normal_Nelson_type::NORMAL || tempering || gradient) && !odr.Cache_hit) {
+            std::cout << "acceptance rate: " << odr.Acceptance_rate() << " (" << (gradient ? "step size " : "proposal sigma ") << odr.Proposal_sigma() << " bohr)" << std::endl;
+        }
+        if (tempering && !odr.Cache_hit) {
+            std::cout << "swap rate: " << odr.Swap_rate() << " (" << odr.Rungs() << " rungs)" << std::endl;
+        }
+
+        if (opt->diagnose) {
+            auto const diag = odr.Diagnose(opt->nornel);
+            std::cout << "diagnostics of r: IAT " << diag.iat << ", ESS " << diag.ess
+                      << " (" << diag.ess / static_cast<double>(diag.chains * diag.length) << " per vertex), R-hat " << diag.rhat
+                      << " over " << diag.chains << " chains x " << diag.length << std::endl;
+
+            auto const balance = odr.Lobe_balance(opt->m);
+            if (balance.windows) {
+                std::cout << "lobe balance: TV " << balance.tv << " (" << balance.excess << "x independent) over "
+                          << balance.lobes << " lobes x " << balance.windows << " windows" << std::endl;
+            }
+        }
+
+        if (!odr.Chunk_counts().empty()) {
+            std::cout << "chunks per thread:";
+            for (auto const count : odr.Chunk_counts()) {
+                std::cout << ' ' << count;
+            }
+            std::cout << std::endl;
+        }
+    }
+    catch (std::exception const & e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,119 @@
+﻿/*! \file cloudpool.cpp
+    \brief 完成した点群を磁気量子数ごとに残し、他のmの点群を先読みするプールクラスの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "cloudpool.h"
+#include <algorithm>    // for std::min_element
+#include <utility>      // for std::move
+
+namespace cloudpool {
+    // #region コンストラクタ
+
+    CloudPool::CloudPool()
+        :   Budget([this] {
+                std::lock_guard<std::mutex> lock(mtx_);
+                return budget_; }, [this](auto budget) {
+                std::lock_guard<std::mutex> lock(mtx_);
+                return budget_ = budget; }),
+            Bytes([this] {
+                std::lock_guard<std::mutex> lock(mtx_);
+                return Total(); }, nullptr),
+            Size([this] {
+                std::lock_guard<std::mutex> lock(mtx_);
+                return static_cast<std::int32_t>(pool_.size()); }, nullptr)
+    {
+    }
+
+    // #endregion コンストラクタ
+
+    // #region publicメンバ関数
+
+    void CloudPool::Clear()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        pool_.clear();
+    }
+
+    void CloudPool::Insert(std::int32_t m, PoolEntry && entry)
+    {
+        auto const bytes = entry.Bytes();
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (bytes > budget_) {
+            return;
+        }
+
+        // 最後に使ったのが古い点群から追い出す
+        while (!pool_.empty() && Total() + bytes > budget_) {
+            pool_.erase(std::min_element(pool_.begin(), pool_.end(), [](auto const & a, auto const & b) {
+                return a.second.lastused < b.second.lastused; }));
+        }
+
+        entry.lastused = ++clock_;
+        pool_[m] = std::move(entry);
+    }
+
+    void CloudPool::Speculate(std::int32_t m, std::int32_t l, std::size_t bytes, std::atomic<bool> const & thread_end, fill_func const & fill)
+    {
+        for (auto d = 1; d <= 2 * l; d++) {
+            for (auto const mm : { m - d, m + d }) {
+                if (mm < -l || mm > l) {
+                    continue;
+                }
+
+                if (thread_end) {
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mtx_);
+                    if (pool_.count(mm)) {
+                        continue;
+                    }
+
+                    if (Total() + bytes > budget_) {
+                        return;
+                    }
+                }
+
+                // 生成中はロックしないので、描画スレッドはその間もプールの大きさを読める
+                PoolEntry entry;
+                if (!fill(mm, entry)) {
+                    return;
+                }
+
+                Insert(mm, std::move(entry));
+            }
+        }
+    }
+
+    std::optional<PoolEntry> CloudPool::Take(std::int32_t m)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto const it = pool_.find(m);
+        if (it == pool_.end()) {
+            return std::nullopt;
+        }
+
+        auto entry = std::move(it->second);
+        pool_.erase(it);
+        return entry;
+    }
+
+    // #endregion publicメンバ関数
+
+    // #region privateメンバ関数
+
+    std::size_t CloudPool::Total() const
+    {
+        std::size_t total = 0;
+        for (auto const & [m, entry] : pool_) {
+            total += entry.Bytes();
+        }
+
+        return total;
+    }
+
+    // #endregion privateメンバ関数
+}
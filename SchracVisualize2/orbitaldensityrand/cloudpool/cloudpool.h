@@ -0,0 +1,228 @@
+﻿/*! \file cloudpool.h
+    \brief 完成した点群を磁気量子数ごとに残し、他のmの点群を先読みするプールクラスの宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _CLOUDPOOL_H_
+#define _CLOUDPOOL_H_
+
+#pragma once
+
+#include "../samplecache/samplecache.h"
+#include "../utility/property.h"
+#include "../vertex.h"
+#include <atomic>       // for std::atomic
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int32_t, std::uint32_t, std::uint64_t
+#include <functional>   // for std::function
+#include <map>          // for std::map
+#include <mutex>        // for std::mutex
+#include <optional>     // for std::optional
+#include <vector>       // for std::vector
+
+namespace cloudpool {
+    //! A struct.
+    /*!
+        プールに残した完成した点群
+    */
+    struct PoolEntry final {
+        //! A public member function.
+        /*!
+            点群の格納に使っているバイト数を返す
+            \return 点群の格納に使っているバイト数
+        */
+        std::size_t Bytes() const
+        {
+            return vertex.capacity() * sizeof(orbitaldensityrand::SimpleVertex) + packedvertex.capacity() * sizeof(orbitaldensityrand::PackedVertex) +
+                (pregion ? pregion->get_size() : 0);
+        }
+
+        //! A public member variable.
+        /*!
+            最後に使った順番
+        */
+        std::uint64_t lastused = 0;
+
+        //! A public member variable.
+        /*!
+            圧縮した頂点
+        */
+        std::vector<orbitaldensityrand::PackedVertex> packedvertex;
+
+        //! A public member variable.
+        /*!
+            キャッシュから読み込んだ頂点の配列をマップした領域
+        */
+        samplecache::SampleCache::region_ptr pregion;
+
+        //! A public member variable.
+        /*!
+            点群の生成に使った乱数のシード
+        */
+        std::uint32_t seed = 0;
+
+        //! A public member variable.
+        /*!
+            頂点
+        */
+        std::vector<orbitaldensityrand::SimpleVertex> vertex;
+    };
+
+    //! A class.
+    /*!
+        m以外の設定が同じ完成した点群を、磁気量子数ごとに合計のバイト数の上限まで残すプールクラス
+        上限を超えたら最後に使ったのが古い点群から追い出し、表示中の点群の生成が終わった後は、他のmの点群を先読みして入れる
+        先読みのスレッドと描画スレッドの両方から使うので、全てのメンバ関数とプロパティは中でロックする
+    */
+    class CloudPool final {
+        // #region 型エイリアス
+
+    public:
+        using fill_func = std::function<bool(std::int32_t, PoolEntry &)>;
+
+        // #endregion 型エイリアス
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+        */
+        CloudPool();
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~CloudPool() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            プールの点群を全て捨てる
+        */
+        void Clear();
+
+        //! A public member function.
+        /*!
+            点群をプールに入れる（上限を超える分は最後に使ったのが古い点群から追い出す）
+            \param m 磁気量子数
+            \param entry プールに入れる点群
+        */
+        void Insert(std::int32_t m, PoolEntry && entry);
+
+        //! A public member function.
+        /*!
+            表示中のmに近いものから順に、プールにない他のmの点群をfillで作って入れる
+            先読みのためにプールの点群を追い出すことはしないので、上限に達したら止める
+            \param m 表示中の点群の磁気量子数
+            \param l 方位量子数
+            \param bytes 1つの点群のバイト数
+            \param thread_end スレッドを強制終了するかどうか
+            \param fill 磁気量子数mmの点群を作る関数（途中で止めた場合はfalseを返す）
+        */
+        void Speculate(std::int32_t m, std::int32_t l, std::size_t bytes, std::atomic<bool> const & thread_end, fill_func const & fill);
+
+        //! A public member function.
+        /*!
+            磁気量子数mの点群をプールから取り出す
+            \param m 磁気量子数
+            \return 取り出した点群（なければstd::nullopt）
+        */
+        std::optional<PoolEntry> Take(std::int32_t m);
+
+    private:
+        //! A private member function (const).
+        /*!
+            プールの点群の合計のバイト数を求める（mtx_をロックして呼ぶ）
+            \return プールの点群の合計のバイト数
+        */
+        std::size_t Total() const;
+
+        // #endregion メンバ関数
+
+        // #region プロパティ
+
+    public:
+        //! A property.
+        /*!
+            プールに残す点群の合計のバイト数の上限へのプロパティ
+        */
+        utility::Property<std::size_t> Budget;
+
+        //! A property.
+        /*!
+            プールの点群の合計のバイト数へのプロパティ
+        */
+        utility::Property<std::size_t> const Bytes;
+
+        //! A property.
+        /*!
+            プールの点群の数へのプロパティ
+        */
+        utility::Property<std::int32_t> const Size;
+
+        // #endregion プロパティ
+
+        // #region メンバ変数
+
+        //! A public static member variable (constant expression).
+        /*!
+            プールに残す点群の合計のバイト数の上限の初期値（1GiB）
+        */
+        static std::size_t constexpr BUDGET_INIT_VALUE = std::size_t(1) << 30;
+
+    private:
+        //! A private member variable.
+        /*!
+            プールに残す点群の合計のバイト数の上限
+        */
+        std::size_t budget_ = BUDGET_INIT_VALUE;
+
+        //! A private member variable.
+        /*!
+            プールの点群を使った順番を数えるカウンタ
+        */
+        std::uint64_t clock_ = 0;
+
+        //! A private member variable.
+        /*!
+            プールを保護するミューテックス
+        */
+        mutable std::mutex mtx_;
+
+        //! A private member variable.
+        /*!
+            磁気量子数ごとの完成した点群
+        */
+        std::map<std::int32_t, PoolEntry> pool_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A public copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        CloudPool(CloudPool const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        CloudPool & operator=(CloudPool const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _CLOUDPOOL_H_
@@ -0,0 +1,99 @@
+﻿/*! \file chaindiagnostics.cpp
+    \brief マルコフ連鎖の収束を診断する（積分自己相関時間、有効サンプルサイズ、Gelman-RubinのR-hat）関数の実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "chaindiagnostics.h"
+#include <cmath>        // for std::sqrt
+#include <limits>       // for std::numeric_limits
+#include <stdexcept>    // for std::invalid_argument
+
+namespace diagnostics {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            Sokalの自動窓で、窓の幅を積分自己相関時間の何倍まで広げるか
+        */
+        static auto constexpr SOKALWINDOW = 5.0;
+    }
+
+    ChainDiagnostics Diagnose(std::vector<double> const & samples, std::size_t chains)
+    {
+        if (!chains || samples.size() / chains < 2) {
+            throw std::invalid_argument("連鎖が短すぎます！");
+        }
+
+        ChainDiagnostics result;
+        result.chains = chains;
+        result.length = samples.size() / chains;
+        auto const n = result.length;
+
+        // 連鎖ごとの平均と、連鎖内の分散
+        std::vector<double> mean(chains);
+        auto grandmean = 0.0, within = 0.0;
+        for (std::size_t j = 0; j < chains; j++) {
+            auto const x = samples.data() + j * n;
+            auto sum = 0.0;
+            for (std::size_t i = 0; i < n; i++) {
+                sum += x[i];
+            }
+            mean[j] = sum / static_cast<double>(n);
+
+            auto sum2 = 0.0;
+            for (std::size_t i = 0; i < n; i++) {
+                sum2 += (x[i] - mean[j]) * (x[i] - mean[j]);
+            }
+
+            grandmean += mean[j];
+            within += sum2 / static_cast<double>(n - 1);
+        }
+        grandmean /= static_cast<double>(chains);
+        within /= static_cast<double>(chains);
+
+        // R-hat = √(V / W)、V = (n - 1) / n W + B / n（B / nは連鎖の平均の分散）
+        if (chains > 1) {
+            auto between = 0.0;
+            for (auto const m : mean) {
+                between += (m - grandmean) * (m - grandmean);
+            }
+            between /= static_cast<double>(chains - 1);
+
+            auto const v = static_cast<double>(n - 1) / static_cast<double>(n) * within + between;
+            result.rhat = within > 0.0 ? std::sqrt(v / within) : 1.0;
+        }
+        else {
+            result.rhat = std::numeric_limits<double>::quiet_NaN();
+        }
+
+        // 自己相関 ρ(t) = Σ(x_i - m)(x_{i+t} - m) / Σ(x_i - m)^2 を、ラグ0から窓の条件を満たすまで求める
+        auto c0 = 0.0;
+        for (std::size_t j = 0; j < chains; j++) {
+            auto const x = samples.data() + j * n;
+            for (std::size_t i = 0; i < n; i++) {
+                c0 += (x[i] - mean[j]) * (x[i] - mean[j]);
+            }
+        }
+
+        auto iat = 1.0;
+        if (c0 > 0.0) {
+            for (std::size_t t = 1; t < n / 2 && static_cast<double>(t) < SOKALWINDOW * iat; t++) {
+                auto ct = 0.0;
+                for (std::size_t j = 0; j < chains; j++) {
+                    auto const x = samples.data() + j * n;
+                    for (std::size_t i = 0; i + t < n; i++) {
+                        ct += (x[i] - mean[j]) * (x[i + t] - mean[j]);
+                    }
+                }
+
+                iat += 2.0 * ct / c0;
+            }
+        }
+
+        // 反相関で1を下回った場合も、有効サンプルサイズはサンプル数を超えないものとする
+        result.iat = iat > 1.0 ? iat : 1.0;
+        result.ess = static_cast<double>(chains * n) / result.iat;
+
+        return result;
+    }
+}
@@ -0,0 +1,63 @@
+﻿/*! \file chaindiagnostics.h
+    \brief マルコフ連鎖の収束を診断する（積分自己相関時間、有効サンプルサイズ、Gelman-RubinのR-hat）関数の宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _CHAINDIAGNOSTICS_H_
+#define _CHAINDIAGNOSTICS_H_
+
+#pragma once
+
+#include <cstddef>  // for std::size_t
+#include <vector>   // for std::vector
+
+namespace diagnostics {
+    //! A struct.
+    /*!
+        マルコフ連鎖の収束の診断結果
+    */
+    struct ChainDiagnostics final {
+        //! A public member variable.
+        /*!
+            連鎖の本数
+        */
+        std::size_t chains = 0;
+
+        //! A public member variable.
+        /*!
+            有効サンプルサイズ（全ての連鎖の合計）
+        */
+        double ess = 0.0;
+
+        //! A public member variable.
+        /*!
+            積分自己相関時間（1なら連続するサンプルが無相関）
+        */
+        double iat = 0.0;
+
+        //! A public member variable.
+        /*!
+            1本あたりのサンプル数
+        */
+        std::size_t length = 0;
+
+        //! A public member variable.
+        /*!
+            Gelman-RubinのR-hat（1に近いほど連鎖どうしが同じ分布に収束している、連鎖が1本ならNaN）
+        */
+        double rhat = 0.0;
+    };
+
+    //! A function.
+    /*!
+        同じ長さの連鎖を並べたサンプルから、積分自己相関時間、有効サンプルサイズとR-hatを求める
+        積分自己相関時間は、全ての連鎖で平均した自己相関をSokalの自動窓（窓の幅がIATのSOKALWINDOW倍を超えるまで）で足し合わせて求める
+        \param samples サンプル（連鎖ごとに連続して並べる、samples.size() / chainsを超える端数は使わない）
+        \param chains 連鎖の本数
+        \return 診断結果
+    */
+    ChainDiagnostics Diagnose(std::vector<double> const & samples, std::size_t chains);
+}
+
+#endif  // _CHAINDIAGNOSTICS_H_
@@ -0,0 +1,128 @@
+﻿/*! \file lobebalance.cpp
+    \brief 点群の各ローブ（節面で区切られた領域）への点の偏りを測るクラスと関数の実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "lobebalance.h"
+#include "../realylm/realylm.h"
+#include <algorithm>                            // for std::fill, std::max, std::upper_bound
+#include <cmath>                                // for std::abs, std::atan2, std::cos, std::floor, std::sin, std::sqrt
+#include <stdexcept>                            // for std::invalid_argument
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::half_pi, boost::math::constants::pi, boost::math::constants::two_pi
+
+namespace diagnostics {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            cosθ方向の節を二分法で求めるときの反復回数
+        */
+        static auto constexpr BISECTION = 60;
+    }
+
+    // #region コンストラクタ
+
+    LobePartition::LobePartition(std::int32_t l, std::int32_t m, std::vector<double> const & radialnodes)
+        : m_(m), phisectors_(m ? 2 * std::abs(m) : 1), radialnodes_(radialnodes)
+    {
+        using namespace boost::math::constants;
+
+        // φ方向の因子cos(mφ)（m < 0ならsin(|m|φ)）が1になる子午線上で、cosθの関数として符号が変わる点を探す
+        realylm::RealYlm const ylm(l, m);
+        auto const phi0 = m < 0 ? half_pi<double>() / static_cast<double>(-m) : 0.0;
+        auto const f = [&ylm, phi0](double u) {
+            auto const s = std::sqrt(std::max(1.0 - u * u, 0.0));
+            return ylm(s * std::cos(phi0), s * std::sin(phi0), u);
+        };
+
+        // 極（cosθ = ±1）の点は、m ≠ 0なら常に節なので除く
+        auto const grid = [](std::int32_t i) { return -1.0 + 2.0 * static_cast<double>(i) / static_cast<double>(NGRID); };
+        auto prev = f(grid(1));
+        for (auto i = 2; i < NGRID; i++) {
+            // 格子点がちょうど節に乗った場合は、次の格子点との間で符号の変化を見る
+            auto const cur = f(grid(i));
+            if (cur != 0.0 && prev != 0.0 && (prev < 0.0) != (cur < 0.0)) {
+                auto lo = grid(i - 1), hi = grid(i);
+                for (auto k = 0; k < BISECTION; k++) {
+                    auto const mid = 0.5 * (lo + hi);
+                    ((f(mid) < 0.0) == (prev < 0.0) ? lo : hi) = mid;
+                }
+                thetanodes_.push_back(0.5 * (lo + hi));
+            }
+
+            prev = cur != 0.0 ? cur : prev;
+        }
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    std::uint32_t LobePartition::operator()(double x, double y, double z) const
+    {
+        using namespace boost::math::constants;
+
+        auto const r = std::sqrt(x * x + y * y + z * z);
+        auto const shell = static_cast<std::size_t>(std::upper_bound(radialnodes_.begin(), radialnodes_.end(), r) - radialnodes_.begin());
+        auto const cone = static_cast<std::size_t>(std::upper_bound(thetanodes_.begin(), thetanodes_.end(), r > 0.0 ? z / r : 0.0) - thetanodes_.begin());
+
+        // cos(mφ)の節はφ = (π/2 + kπ) / m、sin(|m|φ)の節はφ = kπ / |m|
+        std::size_t sector = 0;
+        if (m_) {
+            auto const width = pi<double>() / static_cast<double>(std::abs(m_));
+            auto const offset = m_ > 0 ? 0.5 * width : 0.0;
+            auto const phi = std::atan2(y, x) + two_pi<double>() + offset;
+            sector = static_cast<std::size_t>(std::floor(phi / width)) % static_cast<std::size_t>(phisectors_);
+        }
+
+        return static_cast<std::uint32_t>((shell * (thetanodes_.size() + 1) + cone) * static_cast<std::size_t>(phisectors_) + sector);
+    }
+
+    // #endregion メンバ関数
+
+    LobeBalance Balance(std::vector<std::uint32_t> const & label, std::size_t lobes, std::size_t window)
+    {
+        using namespace boost::math::constants;
+
+        if (!window || label.size() / window < 1) {
+            throw std::invalid_argument("点の数が窓の長さより少なすぎます！");
+        }
+
+        LobeBalance result;
+        result.lobes = lobes;
+        result.windows = label.size() / window;
+        auto const n = result.windows * window;
+
+        std::vector<double> total(lobes, 0.0);
+        for (std::size_t i = 0; i < n; i++) {
+            total[label[i]] += 1.0;
+        }
+        for (auto & q : total) {
+            q /= static_cast<double>(n);
+        }
+
+        std::vector<double> count(lobes);
+        for (std::size_t w = 0; w < result.windows; w++) {
+            std::fill(count.begin(), count.end(), 0.0);
+            for (auto i = w * window; i < (w + 1) * window; i++) {
+                count[label[i]] += 1.0;
+            }
+
+            auto tv = 0.0;
+            for (std::size_t k = 0; k < lobes; k++) {
+                tv += std::abs(count[k] / static_cast<double>(window) - total[k]);
+            }
+            result.tv += 0.5 * tv;
+        }
+        result.tv /= static_cast<double>(result.windows);
+
+        // 独立な点なら、各ローブの頻度は標準偏差sqrt(q(1 - q) / window)の正規分布で近似でき、|偏差|の期待値はその√(2/π)倍
+        auto expected = 0.0;
+        for (auto const q : total) {
+            expected += 0.5 * std::sqrt(2.0 * q * (1.0 - q) / (pi<double>() * static_cast<double>(window)));
+        }
+        result.excess = expected > 0.0 ? result.tv / expected : 1.0;
+
+        return result;
+    }
+}
@@ -0,0 +1,170 @@
+﻿/*! \file lobebalance.h
+    \brief 点群の各ローブ（節面で区切られた領域）への点の偏りを測るクラスと関数の宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _LOBEBALANCE_H_
+#define _LOBEBALANCE_H_
+
+#pragma once
+
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::int32_t, std::uint32_t
+#include <vector>   // for std::vector
+
+namespace diagnostics {
+    //! A struct.
+    /*!
+        点群の連続する窓ごとの、ローブへの点の偏りの測定結果
+    */
+    struct LobeBalance final {
+        //! A public member variable.
+        /*!
+            tvを、独立な点で期待される値で割ったもの（1なら独立な点と同程度の偏り、大きいほど窓ごとに偏っている）
+        */
+        double excess = 0.0;
+
+        //! A public member variable.
+        /*!
+            ローブの数
+        */
+        std::size_t lobes = 0;
+
+        //! A public member variable.
+        /*!
+            窓ごとのローブの頻度と、点群全体のローブの頻度の全変動距離の平均
+        */
+        double tv = 0.0;
+
+        //! A public member variable.
+        /*!
+            窓の数
+        */
+        std::size_t windows = 0;
+    };
+
+    //! A class.
+    /*!
+        動径方向の節（球面）と、実関数表示の球面調和関数の節（円錐面と、φ一定の平面）で空間をローブに分けるクラス
+    */
+    class LobePartition final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ（cosθ方向の節を数値的に求める）
+            \param l 方位量子数
+            \param m 磁気量子数
+            \param radialnodes 動径方向の節のr（昇順）
+        */
+        LobePartition(std::int32_t l, std::int32_t m, std::vector<double> const & radialnodes);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~LobePartition() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            点を含むローブの番号を求める
+            \param x 点のx座標
+            \param y 点のy座標
+            \param z 点のz座標
+            \return ローブの番号（0以上size()未満）
+        */
+        std::uint32_t operator()(double x, double y, double z) const;
+
+        //!  A public member function (const).
+        /*!
+            ローブの数を返す
+            \return ローブの数
+        */
+        std::size_t size() const
+        {
+            return (radialnodes_.size() + 1) * (thetanodes_.size() + 1) * static_cast<std::size_t>(phisectors_);
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A private member variable (constant expression).
+        /*!
+            cosθ方向の節を探すときの、[-1, 1]の分割数
+        */
+        static std::int32_t constexpr NGRID = 4096;
+
+        //! A private member variable.
+        /*!
+            磁気量子数
+        */
+        std::int32_t const m_;
+
+        //! A private member variable.
+        /*!
+            φ方向の領域の数（m = 0なら1、それ以外は2|m|）
+        */
+        std::int32_t const phisectors_;
+
+        //! A private member variable.
+        /*!
+            動径方向の節のr（昇順）
+        */
+        std::vector<double> const radialnodes_;
+
+        //! A private member variable.
+        /*!
+            cosθ方向の節のcosθ（昇順）
+        */
+        std::vector<double> thetanodes_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A public constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        LobePartition() = delete;
+
+        //! A public copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        LobePartition(LobePartition const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        LobePartition & operator=(LobePartition const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    //! A function.
+    /*!
+        点のローブの番号の列を長さwindowの連続する窓に分け、各窓のローブの頻度が点群全体の頻度からどれだけ偏っているかを求める
+        1つの窓を1本の連鎖（1つのスレッド）が生成した場合、連鎖がローブの間を行き来しにくいほど偏りが大きくなる
+        \param label 点のローブの番号（windowを超える端数は使わない）
+        \param lobes ローブの数
+        \param window 窓の長さ
+        \return 測定結果
+    */
+    LobeBalance Balance(std::vector<std::uint32_t> const & label, std::size_t lobes, std::size_t window);
+}
+
+#endif  // _LOBEBALANCE_H_
@@ -0,0 +1,55 @@
+﻿/*! \file aliastable.cpp
+    \brief 離散分布からO(1)で添字を生成するWalkerのエイリアス法の表のクラスの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "aliastable.h"
+#include <numeric>      // for std::accumulate
+#include <stdexcept>    // for std::runtime_error
+
+namespace directsampler {
+    // #region コンストラクタ
+
+    AliasTable::AliasTable(std::vector<double> const & weight)
+        : column_(weight.size())
+    {
+        auto const n = weight.size();
+        auto const total = std::accumulate(weight.begin(), weight.end(), 0.0);
+        if (!n || !(total > 0.0)) {
+            throw std::runtime_error("重みの合計が0です！");
+        }
+
+        // 平均が1になるように正規化し、1未満の列と1以上の列に分ける
+        std::vector<std::uint32_t> small, large;
+        for (auto i = 0U; i < n; i++) {
+            column_[i].prob = weight[i] * static_cast<double>(n) / total;
+            column_[i].alias = i;
+            (column_[i].prob < 1.0 ? small : large).push_back(i);
+        }
+
+        // 1未満の列の不足分を1以上の列から埋める（Voseの方法）
+        while (!small.empty() && !large.empty()) {
+            auto const s = small.back();
+            small.pop_back();
+            auto const g = large.back();
+
+            column_[s].alias = g;
+            column_[g].prob -= 1.0 - column_[s].prob;
+            if (column_[g].prob < 1.0) {
+                large.pop_back();
+                small.push_back(g);
+            }
+        }
+
+        // 丸め誤差で残った列は確率1とする
+        for (auto const i : large) {
+            column_[i].prob = 1.0;
+        }
+        for (auto const i : small) {
+            column_[i].prob = 1.0;
+        }
+    }
+
+    // #endregion コンストラクタ
+}
@@ -0,0 +1,137 @@
+﻿/*! \file aliastable.h
+    \brief 離散分布からO(1)で添字を生成するWalkerのエイリアス法の表のクラスの宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _ALIASTABLE_H_
+#define _ALIASTABLE_H_
+
+#pragma once
+
+#include <algorithm>    // for std::min
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t
+#include <vector>       // for std::vector
+
+namespace directsampler {
+    //! A class.
+    /*!
+        離散分布からO(1)で添字を生成するWalkerのエイリアス法の表のクラス
+        表はVoseの方法で作る
+    */
+    class AliasTable final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param weight 各添字の重み（正規化していなくてよい、負であってはならない）
+        */
+        explicit AliasTable(std::vector<double> const & weight);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~AliasTable() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            [0, 1]の一様乱数1つから、重みに比例する確率で添字を求める
+            一様乱数の整数部分で列を選び、小数部分で列の添字とエイリアスのどちらかを選ぶ
+            \param u [0, 1]の一様乱数
+            \return 添字
+        */
+        std::size_t operator()(double u) const;
+
+        //!  A public member function (const).
+        /*!
+            表の大きさを返す
+            \return 表の大きさ
+        */
+        std::size_t size() const
+        {
+            return column_.size();
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A struct.
+        /*!
+            表の1列（1回の参照でキャッシュラインを1本しか読まないように、確率とエイリアスを並べて持つ）
+        */
+        struct Column {
+            //! A public member variable.
+            /*!
+                エイリアスではなくその列の添字を選ぶ確率
+            */
+            double prob;
+
+            //! A public member variable.
+            /*!
+                エイリアスの添字
+            */
+            std::uint32_t alias;
+        };
+
+        //!  A private member variable.
+        /*!
+            表の各列
+        */
+        std::vector<Column> column_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A public constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        AliasTable() = delete;
+
+        //! A public copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        AliasTable(AliasTable const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        AliasTable & operator=(AliasTable const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    // #region メンバ関数
+
+    inline std::size_t AliasTable::operator()(double u) const
+    {
+        auto const n = column_.size();
+        auto const t = u * static_cast<double>(n);
+
+        // u = 1のときは最後の列に丸める
+        auto const i = std::min(static_cast<std::size_t>(t), n - 1);
+        auto const & column = column_[i];
+        return t - static_cast<double>(i) < column.prob ? i : column.alias;
+    }
+
+    // #endregion メンバ関数
+}
+
+#endif  // _ALIASTABLE_H_
@@ -0,0 +1,150 @@
+﻿/*! \file angularcdf.cpp
+    \brief (cosθ, φ)の格子の累積分布関数の逆関数で、2つの一様な座標を角度方向の確率密度に従う単位ベクトルに写すクラスの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "angularcdf.h"
+#include "cellutility.h"
+#include <algorithm>                            // for std::max, std::min, std::upper_bound
+#include <cmath>                                // for std::sqrt
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::two_pi
+
+namespace directsampler {
+    // #region コンストラクタ
+
+    AngularCdf::AngularCdf(std::int32_t l, std::int32_t m, bool rho)
+        : cumphi_(static_cast<std::size_t>(NCOSTHETA + 1) * (NPHI + 1)),
+          cumtheta_(NCOSTHETA + 1),
+          density_(static_cast<std::size_t>(NCOSTHETA + 1) * (NPHI + 1)),
+          guide_(static_cast<std::size_t>(NCOSTHETA + 1) * NPHI),
+          marginal_(NCOSTHETA + 1),
+          ylm_(l, m)
+    {
+        using namespace boost::math::constants;
+
+        auto const hphi = two_pi<double>() / static_cast<double>(NPHI);
+        Make_phi_table(NPHI, cosphi_, sinphi_);
+
+        // 各格子点（cosθ = ±1の極を含む）で確率密度を求め、φ方向に台形公式で累積する
+        std::vector<double> x(NPHI), y(NPHI), z(NPHI), val(NPHI);
+        for (auto i = 0; i <= NCOSTHETA; i++) {
+            auto const u = -1.0 + 2.0 * static_cast<double>(i) / static_cast<double>(NCOSTHETA);
+            auto const s = std::sqrt(std::max(1.0 - u * u, 0.0));
+            for (auto j = 0; j < NPHI; j++) {
+                x[j] = s * cosphi_[j];
+                y[j] = s * sinphi_[j];
+                z[j] = u;
+            }
+
+            ylm_(x.data(), y.data(), z.data(), val.data(), NPHI);
+
+            auto const row = static_cast<std::size_t>(i) * (NPHI + 1);
+            for (auto j = 0; j < NPHI; j++) {
+                density_[row + j] = Weight(val[j], rho);
+            }
+            density_[row + NPHI] = density_[row];
+
+            cumphi_[row] = 0.0;
+            for (auto j = 1; j <= NPHI; j++) {
+                cumphi_[row + j] = cumphi_[row + j - 1] + 0.5 * hphi * (density_[row + j - 1] + density_[row + j]);
+            }
+
+            marginal_[i] = cumphi_[row + NPHI];
+
+            auto const guide = guide_.data() + static_cast<std::size_t>(i) * NPHI;
+            for (auto g = 0, j = 0; g < NPHI; g++) {
+                auto const threshold = marginal_[i] * static_cast<double>(g) / static_cast<double>(NPHI);
+                while (j < NPHI - 1 && cumphi_[row + j + 1] <= threshold) {
+                    j++;
+                }
+                guide[g] = static_cast<std::uint16_t>(j);
+            }
+        }
+
+        // 周辺分布も台形公式で累積し、全体が1になるよう正規化する（格子点の間の双1次補間の積分と一致する）
+        auto const htheta = 2.0 / static_cast<double>(NCOSTHETA);
+        cumtheta_[0] = 0.0;
+        for (auto i = 1; i <= NCOSTHETA; i++) {
+            cumtheta_[i] = cumtheta_[i - 1] + 0.5 * htheta * (marginal_[i - 1] + marginal_[i]);
+        }
+
+        auto const total = cumtheta_.back();
+        invtotal_ = 1.0 / total;
+        for (auto i = 0; i <= NCOSTHETA; i++) {
+            cumtheta_[i] /= total;
+            marginal_[i] /= total;
+        }
+        cumtheta_.back() = 1.0;
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    void AngularCdf::operator()(double const * u0, double const * u1, double * x, double * y, double * z, double * ylm, std::size_t n) const
+    {
+        using namespace boost::math::constants;
+
+        auto const htheta = 2.0 / static_cast<double>(NCOSTHETA);
+        auto const hphi = two_pi<double>() / static_cast<double>(NPHI);
+
+        for (auto k = 0U; k < n; k++) {
+            // cosθの周辺分布から、u0を含む区間[u_i, u_{i+1})と区間内の位置を求める
+            auto const it = std::upper_bound(cumtheta_.begin() + 1, cumtheta_.end() - 1, u0[k]);
+            auto const i = static_cast<std::int32_t>(it - cumtheta_.begin()) - 1;
+            auto const t = Invert_linear(u0[k] - cumtheta_[i], marginal_[i], marginal_[i + 1], htheta);
+            auto const w = std::min(t / htheta, 1.0);
+            auto const u = std::min(-1.0 + htheta * static_cast<double>(i) + t, 1.0);
+
+            // cosθを与えたときのφの条件付き分布は、両隣の格子点の行をwで混ぜたもの
+            auto const row0 = cumphi_.data() + static_cast<std::size_t>(i) * (NPHI + 1);
+            auto const row1 = row0 + (NPHI + 1);
+            auto const cum = [row0, row1, w](std::int32_t j) { return (1.0 - w) * row0[j] + w * row1[j]; };
+            auto const target = u1[k] * cum(NPHI);
+
+            // 混ぜた正規化した累積分布関数は両隣の行のものの間にあるので、両隣の行の案内表の小さい方から探し始めればよい
+            // （確率の質量が0の行は、混ぜた分布に寄与しないので除く）
+            auto const g = std::min(static_cast<std::int32_t>(u1[k] * static_cast<double>(NPHI)), NPHI - 1);
+            auto const guide0 = static_cast<std::int32_t>(guide_[static_cast<std::size_t>(i) * NPHI + g]);
+            auto const guide1 = static_cast<std::int32_t>(guide_[static_cast<std::size_t>(i + 1) * NPHI + g]);
+            auto lo = row0[NPHI] > 0.0 && row1[NPHI] > 0.0 ? std::min(guide0, guide1) : (row0[NPHI] > 0.0 ? guide0 : guide1);
+            while (lo < NPHI - 1 && cum(lo + 1) <= target) {
+                lo++;
+            }
+
+            auto const d0 = density_.data() + static_cast<std::size_t>(i) * (NPHI + 1);
+            auto const d1 = d0 + (NPHI + 1);
+            auto const dl = (1.0 - w) * d0[lo] + w * d1[lo];
+            auto const dr = (1.0 - w) * d0[lo + 1] + w * d1[lo + 1];
+            auto const d = Invert_linear(target - cum(lo), dl, dr, hphi);
+
+            auto const [cosphi, sinphi] = Rotate_phi(cosphi_[lo], sinphi_[lo], d);
+            auto const s = std::sqrt(std::max(1.0 - u * u, 0.0));
+            x[k] = s * cosphi;
+            y[k] = s * sinphi;
+            z[k] = u;
+        }
+
+        ylm_(x, y, z, ylm, n);
+    }
+
+    double AngularCdf::Density(double u, double phi) const
+    {
+        using namespace boost::math::constants;
+
+        auto const ut = (u + 1.0) / 2.0 * static_cast<double>(NCOSTHETA);
+        auto const i = std::min(std::max(static_cast<std::int32_t>(ut), 0), NCOSTHETA - 1);
+        auto const w = ut - static_cast<double>(i);
+
+        auto const pt = phi / two_pi<double>() * static_cast<double>(NPHI);
+        auto const j = std::min(std::max(static_cast<std::int32_t>(pt), 0), NPHI - 1);
+        auto const v = pt - static_cast<double>(j);
+
+        auto const d0 = density_.data() + static_cast<std::size_t>(i) * (NPHI + 1);
+        auto const d1 = d0 + (NPHI + 1);
+        return invtotal_ * ((1.0 - w) * ((1.0 - v) * d0[j] + v * d0[j + 1]) + w * ((1.0 - v) * d1[j] + v * d1[j + 1]));
+    }
+
+    // #endregion メンバ関数
+}
@@ -0,0 +1,176 @@
+﻿/*! \file angularcdf.h
+    \brief (cosθ, φ)の格子の累積分布関数の逆関数で、2つの一様な座標を角度方向の確率密度に従う単位ベクトルに写すクラスの宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _ANGULARCDF_H_
+#define _ANGULARCDF_H_
+
+#pragma once
+
+#include "../realylm/realylm.h"
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::int32_t, std::uint16_t
+#include <vector>   // for std::vector
+
+namespace directsampler {
+    //! A class.
+    /*!
+        (cosθ, φ)の格子の累積分布関数の逆関数で、2つの一様な座標を、角度方向の確率密度|Y_lm|^2（電子密度の場合は|Y_lm|^4）に
+        従う単位ベクトルに写すクラス
+        格子点の間では確率密度を双1次式で補間し、cosθの周辺分布と、cosθを与えたときのφの条件付き分布を順に厳密に逆算する
+        棄却法を使わず、写像が連続で単調なので、準乱数の点列の一様さがそのまま単位ベクトルに引き継がれる
+        写す先が従うのは補間した確率密度（Density()）で、真の確率密度とは補間の分だけずれる
+        （l <= 4では、16 × 32のビンで測った全変動距離が2.0E-3以下。最大はl = 4, m = 0の電子密度で、test/angularcdftest.cppで確かめる）
+    */
+    class AngularCdf final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ（格子点での確率密度と累積分布関数の表を作る）
+            \param l 方位量子数
+            \param m 磁気量子数
+            \param rho 電子密度のデータかどうか（trueなら|Y_lm|^4、falseなら|Y_lm|^2に従う）
+        */
+        AngularCdf(std::int32_t l, std::int32_t m, bool rho);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~AngularCdf() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            n組の[0, 1]の座標を単位ベクトルに写し、そこでの実関数表示の球面調和関数の値を求める
+            \param u0 cosθを決める座標の配列
+            \param u1 φを決める座標の配列
+            \param x 単位ベクトルのx成分を格納する配列
+            \param y 単位ベクトルのy成分を格納する配列
+            \param z 単位ベクトルのz成分を格納する配列
+            \param ylm 実関数表示の球面調和関数の値を格納する配列
+            \param n 配列の要素数
+        */
+        void operator()(double const * u0, double const * u1, double * x, double * y, double * z, double * ylm, std::size_t n) const;
+
+        //!  A public member function (const).
+        /*!
+            operator()の写す先が従う確率密度（格子点の値を双1次式で補間し、cosθとφについて積分すると1になるよう正規化したもの）を返す
+            \param u cosθ（[-1, 1]）
+            \param phi φ（[0, 2π)）
+            \return 補間した確率密度
+        */
+        double Density(double u, double phi) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A public static member variable (constant expression).
+        /*!
+            格子のcosθ方向の区間の数
+        */
+        static std::int32_t constexpr NCOSTHETA = 256;
+
+        //! A public static member variable (constant expression).
+        /*!
+            格子のφ方向の区間の数
+        */
+        static std::int32_t constexpr NPHI = 512;
+
+        static_assert(NPHI <= 65536, "φ方向の区間の番号はstd::uint16_tに収まる必要があります");
+
+    private:
+
+        //! A private member variable.
+        /*!
+            φ方向の各区間の左端でのcosφ
+        */
+        std::vector<double> cosphi_;
+
+        //! A private member variable.
+        /*!
+            cosθの各格子点での、φ方向の各格子点までの確率密度の積分（格子点の番号 × (NPHI + 1) + φ方向の格子点の番号の順）
+        */
+        std::vector<double> cumphi_;
+
+        //! A private member variable.
+        /*!
+            cosθの各格子点までの周辺分布の累積分布関数（最後の点で1になるよう正規化する）
+        */
+        std::vector<double> cumtheta_;
+
+        //! A private member variable.
+        /*!
+            各格子点での確率密度（cumphi_と同じ順、φ = 2πの点はφ = 0の点と同じ値）
+        */
+        std::vector<double> density_;
+
+        //! A private member variable.
+        /*!
+            cosθの各格子点で、φ方向の正規化した累積分布関数の値をNPHI等分したときの、各値を含む区間の番号（区間の探索の案内表）
+        */
+        std::vector<std::uint16_t> guide_;
+
+        //! A private member variable.
+        /*!
+            density_を正規化する係数（周辺分布の正規化に使った全体の積分の逆数）
+        */
+        double invtotal_ = 0.0;
+
+        //! A private member variable.
+        /*!
+            cosθの各格子点での周辺分布の確率密度（cumtheta_と同じく正規化する）
+        */
+        std::vector<double> marginal_;
+
+        //! A private member variable.
+        /*!
+            φ方向の各区間の左端でのsinφ
+        */
+        std::vector<double> sinphi_;
+
+        //! A private member variable.
+        /*!
+            実関数表示の球面調和関数
+        */
+        realylm::RealYlm const ylm_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A public constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        AngularCdf() = delete;
+
+        //! A public copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        AngularCdf(AngularCdf const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        AngularCdf & operator=(AngularCdf const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _ANGULARCDF_H_
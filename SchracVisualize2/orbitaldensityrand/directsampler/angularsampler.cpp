@@ -0,0 +1,157 @@
+﻿/*! \file angularsampler.cpp
+    \brief 角度方向の確率密度|Y_lm|^2（電子密度の場合は|Y_lm|^4）に従う単位ベクトルを生成するクラスの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "angularsampler.h"
+#include "cellutility.h"
+#include <algorithm>                            // for std::max, std::min
+#include <array>                                // for std::array
+#include <cmath>                                // for std::acos, std::cos, std::fabs, std::hypot, std::sin, std::sqrt
+#include <boost/assert.hpp>                     // for BOOST_ASSERT
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi, boost::math::constants::two_pi
+
+namespace directsampler {
+    // #region コンストラクタ
+
+    AngularSampler::AngularSampler(std::int32_t l, std::int32_t m, bool rho)
+        : acceptance_(0.0), bound_(Cell_bounds(l, m, rho)), cell_(bound_), rho_(rho), ylm_(l, m)
+    {
+        using namespace boost::math::constants;
+
+        Make_phi_table(NPHI, cosphi_, sinphi_);
+
+        // セルの中心での確率密度の和と上限の和の比を採択率の見積もりとする
+        std::vector<double> x(NPHI), y(NPHI), z(NPHI), val(NPHI);
+        auto weight = 0.0, bound = 0.0;
+        for (auto i = 0; i < NCOSTHETA; i++) {
+            auto const u = -1.0 + 2.0 * (static_cast<double>(i) + 0.5) / static_cast<double>(NCOSTHETA);
+            auto const s = std::sqrt(std::max(1.0 - u * u, 0.0));
+            for (auto j = 0; j < NPHI; j++) {
+                auto const phi = two_pi<double>() * (static_cast<double>(j) + 0.5) / static_cast<double>(NPHI);
+                x[j] = s * std::cos(phi);
+                y[j] = s * std::sin(phi);
+                z[j] = u;
+                bound += bound_[i * NPHI + j];
+            }
+
+            ylm_(x.data(), y.data(), z.data(), val.data(), val.size());
+            for (auto const v : val) {
+                weight += Weight(v, rho_);
+            }
+        }
+
+        acceptance_ = weight / bound;
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    void AngularSampler::operator()(myrandom::MyRandSfmt & mr, double * x, double * y, double * z, double * ylm, std::size_t n) const
+    {
+        using namespace boost::math::constants;
+
+        std::array<double, 4 * BLOCKSIZE> rnd;
+        std::array<double, BLOCKSIZE> cx, cy, cz, cylm, cbound;
+
+        std::size_t count = 0;
+        while (count < n) {
+            // セルを上限に比例する確率で選び、セル内で一様な点（cosθとφが一様）をまとめて提案する
+            mr.myrand(rnd.data(), rnd.size());
+            for (auto k = 0U; k < BLOCKSIZE; k++) {
+                auto const c = cell_(rnd[k]);
+                auto const i = static_cast<std::int32_t>(c / NPHI);
+                auto const j = static_cast<std::int32_t>(c % NPHI);
+
+                auto const u = std::min(-1.0 + 2.0 * (static_cast<double>(i) + rnd[BLOCKSIZE + k]) / static_cast<double>(NCOSTHETA), 1.0);
+                auto const s = std::sqrt(std::max(1.0 - u * u, 0.0));
+
+                auto const [cosphi, sinphi] = Rotate_phi(cosphi_[j], sinphi_[j], two_pi<double>() * rnd[2 * BLOCKSIZE + k] / static_cast<double>(NPHI));
+                cx[k] = s * cosphi;
+                cy[k] = s * sinphi;
+                cz[k] = u;
+                cbound[k] = bound_[c];
+            }
+
+            ylm_(cx.data(), cy.data(), cz.data(), cylm.data(), BLOCKSIZE);
+
+            // 確率密度とセルの上限の比で採択する
+            for (auto k = 0U; k < BLOCKSIZE && count < n; k++) {
+                auto const weight = Weight(cylm[k], rho_);
+                BOOST_ASSERT(weight <= cbound[k]);
+
+                if (rnd[3 * BLOCKSIZE + k] * cbound[k] < weight) {
+                    x[count] = cx[k];
+                    y[count] = cy[k];
+                    z[count] = cz[k];
+                    ylm[count] = cylm[k];
+                    count++;
+                }
+            }
+        }
+    }
+
+    std::vector<double> AngularSampler::Cell_bounds(std::int32_t l, std::int32_t m, bool rho)
+    {
+        using namespace boost::math::constants;
+
+        realylm::RealYlm const ylm(l, m);
+
+        // セルの角、辺の中点と中心を含む、半分の刻みの格子点（両端を含む）で、|Y_lm|と球面上の勾配の大きさを求める
+        auto constexpr nu = 2 * NCOSTHETA + 1;
+        auto constexpr nphi = 2 * NPHI + 1;
+        std::vector<double> val(static_cast<std::size_t>(nu) * nphi), slope(static_cast<std::size_t>(nu) * nphi);
+        for (auto i = 0; i < nu; i++) {
+            auto const u = Grid_u(i);
+            auto const s = std::sqrt(std::max(1.0 - u * u, 0.0));
+            for (auto j = 0; j < nphi; j++) {
+                auto const phi = two_pi<double>() * static_cast<double>(j) / static_cast<double>(2 * NPHI);
+                auto const x = s * std::cos(phi);
+                auto const y = s * std::sin(phi);
+
+                // 球面上の勾配は、多項式とみなしたときの勾配から動径方向の成分を除いたもの
+                std::array<double, 3> grad;
+                auto const v = ylm.Gradient(x, y, u, grad);
+                auto const radial = x * grad[0] + y * grad[1] + u * grad[2];
+                auto const k = static_cast<std::size_t>(i) * nphi + j;
+                val[k] = std::fabs(v);
+                slope[k] = std::hypot(grad[0] - radial * x, grad[1] - radial * y, grad[2] - radial * u);
+            }
+        }
+
+        // 正規直交な実関数表示の球面調和関数では、Σ_m |Hess Y_lm|^2 = (2l + 1)λ(λ - 1) / 4π（λ = l(l + 1)）が
+        // 球面上のどこでも成り立つので、ヘッセ行列の大きさはどこでもこの平方根以下である
+        auto const lambda = static_cast<double>(l * (l + 1));
+        auto const hessian = std::sqrt(static_cast<double>(2 * l + 1) * lambda * (lambda - 1.0) / (4.0 * pi<double>()));
+
+        // セル内の点から、同じ小セル（格子点で4分割したもの）の最も近い角までの距離は、緯線に沿って高々sinθ_max × π / (2NPHI)、
+        // 経線に沿って高々小セルのθ方向の幅の半分なので、その和d以下である。角cから測地線に沿って距離d以内の点では、
+        // |Y_lm| <= |Y_lm(c)| + |∇Y_lm(c)|d + Hd^2 / 2が成り立つので、3×3の点でのこの値の最大値がセル内の|Y_lm|の上限になる
+        std::vector<double> bound(static_cast<std::size_t>(NCOSTHETA) * NPHI);
+        for (auto i = 0; i < NCOSTHETA; i++) {
+            auto const u0 = Grid_u(2 * i), u1 = Grid_u(2 * i + 1), u2 = Grid_u(2 * i + 2);
+            auto const dtheta = std::max(std::acos(u0) - std::acos(u1), std::acos(u1) - std::acos(u2));
+            auto const umin = u0 <= 0.0 && u2 >= 0.0 ? 0.0 : std::min(std::fabs(u0), std::fabs(u2));
+            auto const sinmax = std::sqrt(std::max(1.0 - umin * umin, 0.0));
+            auto const distance = 0.5 * dtheta + sinmax * pi<double>() / static_cast<double>(2 * NPHI);
+
+            for (auto j = 0; j < NPHI; j++) {
+                auto ymax = 0.0;
+                for (auto di = 0; di <= 2; di++) {
+                    for (auto dj = 0; dj <= 2; dj++) {
+                        auto const k = static_cast<std::size_t>(2 * i + di) * nphi + 2 * j + dj;
+                        ymax = std::max(ymax, val[k] + slope[k] * distance);
+                    }
+                }
+
+                bound[i * NPHI + j] = Weight(ymax + 0.5 * hessian * distance * distance, rho);
+            }
+        }
+
+        return bound;
+    }
+
+    // #endregion メンバ関数
+}
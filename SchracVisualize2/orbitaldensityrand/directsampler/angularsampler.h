@@ -0,0 +1,189 @@
+﻿/*! \file angularsampler.h
+    \brief 角度方向の確率密度|Y_lm|^2（電子密度の場合は|Y_lm|^4）に従う単位ベクトルを生成するクラスの宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _ANGULARSAMPLER_H_
+#define _ANGULARSAMPLER_H_
+
+#pragma once
+
+#include "aliastable.h"
+#include "../myrandom/myrandsfmt.h"
+#include "../realylm/realylm.h"
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::int32_t
+#include <vector>   // for std::vector
+
+namespace directsampler {
+    //! A class.
+    /*!
+        角度方向の確率密度|Y_lm|^2（電子密度の場合は|Y_lm|^4）に従う単位ベクトルを生成するクラス
+        (cosθ, φ)の格子の各セルでの確率密度の上限に比例する確率でセルをエイリアス法で選び、セル内で一様な点を
+        提案して、確率密度と上限の比で採択する（棄却法）。上限は真の確率密度に近いので、ほとんどの提案が採択される
+    */
+    class AngularSampler final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ（各セルでの確率密度の上限と、エイリアス法の表を作る）
+            \param l 方位量子数
+            \param m 磁気量子数
+            \param rho 電子密度のデータかどうか（trueなら|Y_lm|^4、falseなら|Y_lm|^2に従う）
+        */
+        AngularSampler(std::int32_t l, std::int32_t m, bool rho);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~AngularSampler() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            提案が採択される確率の見積もり（セルの中心での確率密度の和と、上限の和の比）を返す
+            \return 採択率の見積もり
+        */
+        double Acceptance() const
+        {
+            return acceptance_;
+        }
+
+        //!  A public member function (const).
+        /*!
+            n個の単位ベクトルと、そこでの実関数表示の球面調和関数の値を生成する
+            nが同じなら、乱数の消費量は生成したベクトルによらず、mrの状態だけで決まる
+            \param mr 乱数生成器
+            \param x 単位ベクトルのx成分を格納する配列
+            \param y 単位ベクトルのy成分を格納する配列
+            \param z 単位ベクトルのz成分を格納する配列
+            \param ylm 実関数表示の球面調和関数の値を格納する配列
+            \param n 配列の要素数
+        */
+        void operator()(myrandom::MyRandSfmt & mr, double * x, double * y, double * z, double * ylm, std::size_t n) const;
+
+    private:
+        //!  A private static member function.
+        /*!
+            (cosθ, φ)の格子の各セルでの確率密度の上限を求める
+            上限は格子点での|Y_lm|と勾配、ヘッセ行列の大きさの上界から求めるので、セル内のどの点でも確率密度を下回らない
+            \param l 方位量子数
+            \param m 磁気量子数
+            \param rho 電子密度のデータかどうか
+            \return 各セルでの確率密度の上限（cosθ方向のセルの番号 × NPHI + φ方向のセルの番号の順）
+        */
+        static std::vector<double> Cell_bounds(std::int32_t l, std::int32_t m, bool rho);
+
+        //!  A private static member function.
+        /*!
+            半分の刻みの格子のcosθ方向のi番目の点を求める
+            \param i 格子点の番号（0から2 × NCOSTHETAまで）
+            \return cosθ
+        */
+        static double Grid_u(std::int32_t i)
+        {
+            return -1.0 + static_cast<double>(i) / static_cast<double>(NCOSTHETA);
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable (constant expression).
+        /*!
+            1回にまとめて提案する単位ベクトルの数
+        */
+        static std::size_t constexpr BLOCKSIZE = 64;
+
+        //! A private member variable (constant expression).
+        /*!
+            格子のcosθ方向のセルの数
+        */
+        static std::int32_t constexpr NCOSTHETA = 128;
+
+        //! A private member variable (constant expression).
+        /*!
+            格子のφ方向のセルの数
+        */
+        static std::int32_t constexpr NPHI = 256;
+
+        //! A private member variable.
+        /*!
+            採択率の見積もり
+        */
+        double acceptance_;
+
+        //! A private member variable.
+        /*!
+            各セルでの確率密度の上限
+        */
+        std::vector<double> bound_;
+
+        //! A private member variable.
+        /*!
+            セルを上限に比例する確率で選ぶエイリアス法の表
+        */
+        AliasTable const cell_;
+
+        //! A private member variable.
+        /*!
+            φ方向の各セルの左端でのcosφ（セル内のφは、ここからの小さな回転で求める）
+        */
+        std::vector<double> cosphi_;
+
+        //! A private member variable.
+        /*!
+            電子密度のデータかどうか
+        */
+        bool const rho_;
+
+        //! A private member variable.
+        /*!
+            φ方向の各セルの左端でのsinφ
+        */
+        std::vector<double> sinphi_;
+
+        //! A private member variable.
+        /*!
+            実関数表示の球面調和関数
+        */
+        realylm::RealYlm const ylm_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A public constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        AngularSampler() = delete;
+
+        //! A public copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        AngularSampler(AngularSampler const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        AngularSampler & operator=(AngularSampler const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _ANGULARSAMPLER_H_
@@ -0,0 +1,90 @@
+﻿/*! \file cellutility.h
+    \brief 直接生成法のクラスが共有する、格子の区間やセルの中の点を求める関数の実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _CELLUTILITY_H_
+#define _CELLUTILITY_H_
+
+#pragma once
+
+#include <algorithm>                            // for std::max, std::min
+#include <cmath>                                // for std::cos, std::sin, std::sqrt
+#include <cstdint>                              // for std::int32_t
+#include <utility>                              // for std::pair
+#include <vector>                               // for std::vector
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::two_pi
+
+namespace directsampler {
+    //! A function.
+    /*!
+        確率密度を1次式とみなした区間で、区間の左端からの確率の質量massに対応する位置を求める
+        \param mass 区間の左端からの確率の質量
+        \param d0 区間の左端での確率密度
+        \param d1 区間の右端での確率密度
+        \param h 区間の幅
+        \return 区間の左端からの距離（[0, h]）
+    */
+    inline double Invert_linear(double mass, double d0, double d1, double h)
+    {
+        // 区間内の確率密度d(t) = d0 + (d1 - d0)t/hを積分した2次式を、桁落ちしない形で解く
+        mass = std::max(mass, 0.0);
+        auto const denom = d0 + std::sqrt(std::max(d0 * d0 + 2.0 * (d1 - d0) * mass / h, 0.0));
+        auto const t = denom > 0.0 ? 2.0 * mass / denom : 0.0;
+        return std::min(t, h);
+    }
+
+    //! A function.
+    /*!
+        φ方向の格子の各区間の左端でのcosφとsinφの表を作る
+        \param nphi φ方向の区間の数
+        \param cosphi cosφを格納する配列（nphi個）
+        \param sinphi sinφを格納する配列（nphi個）
+    */
+    inline void Make_phi_table(std::int32_t nphi, std::vector<double> & cosphi, std::vector<double> & sinphi)
+    {
+        using namespace boost::math::constants;
+
+        cosphi.resize(nphi);
+        sinphi.resize(nphi);
+        for (auto j = 0; j < nphi; j++) {
+            auto const phi = two_pi<double>() * static_cast<double>(j) / static_cast<double>(nphi);
+            cosphi[j] = std::cos(phi);
+            sinphi[j] = std::sin(phi);
+        }
+    }
+
+    //! A function.
+    /*!
+        φ方向の区間の左端（cosφ0, sinφ0）から角dだけ回した点の(cosφ, sinφ)を求める
+        dは区間の幅（2π / 256）以下であること
+        \param cosphi0 区間の左端でのcosφ
+        \param sinphi0 区間の左端でのsinφ
+        \param d 区間の左端からの回転角
+        \return 回した点でのcosφとsinφ
+    */
+    inline std::pair<double, double> Rotate_phi(double cosphi0, double sinphi0, double d)
+    {
+        // 小さな回転角のcosとsinはテイラー展開で十分な精度になる（d <= 2π / 256で打ち切り誤差は1.0E-20程度）
+        auto const d2 = d * d;
+        auto const sind = d * (1.0 - d2 / 6.0 * (1.0 - d2 / 20.0 * (1.0 - d2 / 42.0)));
+        auto const cosd = 1.0 - d2 / 2.0 * (1.0 - d2 / 12.0 * (1.0 - d2 / 30.0 * (1.0 - d2 / 56.0)));
+        return { cosphi0 * cosd - sinphi0 * sind, sinphi0 * cosd + cosphi0 * sind };
+    }
+
+    //! A function.
+    /*!
+        実関数表示の球面調和関数の値から、角度方向の確率密度（正規化していない）を求める
+        \param ylm 実関数表示の球面調和関数の値
+        \param rho 電子密度のデータかどうか（trueなら|Y_lm|^4、falseなら|Y_lm|^2）
+        \return 確率密度
+    */
+    inline double Weight(double ylm, bool rho)
+    {
+        auto const y2 = ylm * ylm;
+        return rho ? y2 * y2 : y2;
+    }
+}
+
+#endif  // _CELLUTILITY_H_
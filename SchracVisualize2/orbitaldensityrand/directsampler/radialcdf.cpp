@@ -0,0 +1,79 @@
+﻿/*! \file radialcdf.cpp
+    \brief 動径方向の確率密度r^2φ(r)^2の累積分布関数の表から、逆関数法でrを生成するクラスの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "radialcdf.h"
+#include <stdexcept>    // for std::runtime_error
+
+namespace directsampler {
+    // #region コンストラクタ
+
+    RadialCdf::RadialCdf(getdata::RadialTable const & table)
+    {
+        auto const & r_mesh = table.R_mesh();
+        auto const meshcells = static_cast<std::int32_t>(r_mesh.size()) - 1;
+
+        // メッシュの各区間をsub等分した点を表の点にする
+        auto const sub = std::max((MINCELLS + meshcells - 1) / meshcells, 1);
+        r_.reserve(static_cast<std::size_t>(meshcells) * sub + 1);
+        for (auto i = 0; i < meshcells; i++) {
+            auto const h = r_mesh[i + 1] - r_mesh[i];
+            for (auto j = 0; j < sub; j++) {
+                r_.push_back(r_mesh[i] + h * static_cast<double>(j) / static_cast<double>(sub));
+            }
+        }
+        r_.push_back(r_mesh.back());
+
+        auto const size = r_.size();
+        density_.resize(size);
+        table(r_.data(), density_.data(), size);
+        for (auto i = 0U; i < size; i++) {
+            density_[i] *= density_[i] * r_[i] * r_[i];
+        }
+
+        // 台形公式で累積し、全体が1になるよう正規化する
+        cdf_.resize(size);
+        cdf_[0] = 0.0;
+        for (auto i = 1U; i < size; i++) {
+            cdf_[i] = cdf_[i - 1] + 0.5 * (density_[i - 1] + density_[i]) * (r_[i] - r_[i - 1]);
+        }
+
+        auto const total = cdf_.back();
+        if (!(total > 0.0)) {
+            throw std::runtime_error("動径関数が恒等的に0です！");
+        }
+
+        for (auto i = 0U; i < size; i++) {
+            cdf_[i] /= total;
+            density_[i] /= total;
+        }
+
+        // 案内表のk番目には、累積分布関数の値k / guide_.size()を含む区間の番号を入れる
+        auto const cells = size - 1;
+        guide_.resize(cells);
+        std::size_t i = 0;
+        for (auto k = 0U; k < cells; k++) {
+            auto const u = static_cast<double>(k) / static_cast<double>(cells);
+            while (i < cells - 1 && cdf_[i + 1] <= u) {
+                i++;
+            }
+
+            guide_[k] = static_cast<std::uint32_t>(i);
+        }
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    void RadialCdf::operator()(double const * u, double * r, std::size_t n) const
+    {
+        for (auto i = 0U; i < n; i++) {
+            r[i] = (*this)(u[i]);
+        }
+    }
+
+    // #endregion メンバ関数
+}
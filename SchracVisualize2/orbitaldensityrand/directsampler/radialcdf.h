@@ -0,0 +1,144 @@
+﻿/*! \file radialcdf.h
+    \brief 動径方向の確率密度r^2φ(r)^2の累積分布関数の表から、逆関数法でrを生成するクラスの宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _RADIALCDF_H_
+#define _RADIALCDF_H_
+
+#pragma once
+
+#include "cellutility.h"
+#include "../getdata/radialtable.h"
+#include <algorithm>    // for std::min
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int32_t, std::uint32_t
+#include <vector>       // for std::vector
+
+namespace directsampler {
+    //! A class.
+    /*!
+        動径方向の確率密度r^2φ(r)^2の累積分布関数の表から、逆関数法でrを生成するクラス
+        rのメッシュの各区間を細分した点で確率密度を求め、点の間では確率密度を1次式とみなして累積分布関数を厳密に逆算する
+    */
+    class RadialCdf final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param table 動径関数の3次スプラインの係数表
+        */
+        explicit RadialCdf(getdata::RadialTable const & table);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~RadialCdf() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            [0, 1]の一様乱数から、確率密度r^2φ(r)^2に従うrを求める
+            \param u [0, 1]の一様乱数
+            \return rの値
+        */
+        double operator()(double u) const;
+
+        //!  A public member function (const).
+        /*!
+            n個の[0, 1]の一様乱数から、確率密度r^2φ(r)^2に従うrをまとめて求める
+            \param u [0, 1]の一様乱数の配列
+            \param r rの値を格納する配列
+            \param n 配列の要素数
+        */
+        void operator()(double const * u, double * r, std::size_t n) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A private member variable (constant expression).
+        /*!
+            表の区間の数の下限（rのメッシュの区間がこれより少なければ、各区間を細分する）
+        */
+        static std::int32_t constexpr MINCELLS = 65536;
+
+        //! A private member variable.
+        /*!
+            表の各点までの累積分布関数の値（最後の点で1になるよう正規化する）
+        */
+        std::vector<double> cdf_;
+
+        //! A private member variable.
+        /*!
+            表の各点における確率密度（cdf_と同じく正規化する）
+        */
+        std::vector<double> density_;
+
+        //! A private member variable.
+        /*!
+            累積分布関数の値をguide_.size()等分したときの、各値を含む区間の番号（区間の探索を定数時間にする案内表）
+        */
+        std::vector<std::uint32_t> guide_;
+
+        //! A private member variable.
+        /*!
+            表の点のr
+        */
+        std::vector<double> r_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A public constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        RadialCdf() = delete;
+
+        //! A public copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        RadialCdf(RadialCdf const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        RadialCdf & operator=(RadialCdf const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    // #region メンバ関数
+
+    inline double RadialCdf::operator()(double u) const
+    {
+        // 案内表から探索を始め、uを含む区間[r_i, r_{i+1})を求める
+        auto const cells = r_.size() - 1;
+        auto i = static_cast<std::size_t>(guide_[std::min(static_cast<std::size_t>(u * static_cast<double>(guide_.size())), guide_.size() - 1)]);
+        while (i < cells - 1 && cdf_[i + 1] <= u) {
+            i++;
+        }
+
+        return r_[i] + Invert_linear(u - cdf_[i], density_[i], density_[i + 1], r_[i + 1] - r_[i]);
+    }
+
+    // #endregion メンバ関数
+}
+
+#endif  // _RADIALCDF_H_
@@ -1,39 +1,155 @@
-/*! \file getdata.h
-    \brief r̃bVƁÃbVɂdqx^NX̎
+﻿/*! \file getdata.h
+    \brief rのメッシュと、そのメッシュにおける電子密度を与えるクラスの実装
 
-    Copyright  2015-2019 @dc1394 All Rights Reserved.
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
     This software is released under the BSD 2-Clause License.
 */
 
 #include "getdata.h"
 #include "readdatafile.h"
-#include <iterator>                     // for std::distance
-#include <stdexcept>                    // for std::runtime_error
-#include <boost/algorithm/string.hpp>   // for boost::algorithm
-#include <boost/assert.hpp>             // for BOOST_ASSERT
-#include <boost/range/algorithm.hpp>    // for boost::max_element
+#include "../utility/fnv1a.h"
+#include <algorithm>                                // for std::min
+#include <cstring>                                  // for std::memcmp, std::memcpy
+#include <filesystem>                               // for std::filesystem
+#include <fstream>                                  // for std::ofstream
+#include <iterator>                                 // for std::distance
+#include <stdexcept>                                // for std::runtime_error
+#include <system_error>                             // for std::error_code
+#include <boost/algorithm/string.hpp>               // for boost::algorithm
+#include <boost/assert.hpp>                         // for BOOST_ASSERT
+#include <boost/interprocess/file_mapping.hpp>      // for boost::interprocess::file_mapping
+#include <boost/interprocess/mapped_region.hpp>     // for boost::interprocess::mapped_region
+#include <boost/range/algorithm.hpp>                // for boost::max_element
 
 namespace getdata {
-    // #region RXgN^
+    namespace {
+        //! A struct.
+        /*!
+            バイナリ形式のデータファイルのヘッダ
+            ヘッダの後ろに、rのメッシュ、関数の値（各size個）と、3次スプラインの0次から3次の係数（各size - 1個）のdoubleの配列が続く
+        */
+        struct BinaryHeader final {
+            //! A public member variable.
+            /*!
+                ファイルの種類を表す文字列
+            */
+            char magic[8];
+
+            //! A public member variable.
+            /*!
+                形式の版
+            */
+            std::uint32_t version;
+
+            //! A public member variable.
+            /*!
+                解く方程式のタイプ
+            */
+            std::uint32_t rho_wf_type;
+
+            //! A public member variable.
+            /*!
+                主量子数
+            */
+            std::int32_t n;
+
+            //! A public member variable.
+            /*!
+                方位量子数
+            */
+            std::uint32_t l;
+
+            //! A public member variable.
+            /*!
+                rのメッシュの点数
+            */
+            std::uint64_t size;
+
+            //! A public member variable.
+            /*!
+                波動関数の最大値
+            */
+            double phimax;
+
+            //! A public member variable.
+            /*!
+                波動関数が最大値を取るときのr
+            */
+            double r2rhomaxr;
+
+            //! A public member variable.
+            /*!
+                元素名（末尾は0で埋める）
+            */
+            char atomname[16];
+
+            //! A public member variable.
+            /*!
+                軌道（末尾は0で埋める）
+            */
+            char orbital[8];
+        };
+
+        static_assert(sizeof(BinaryHeader) == 72, "BinaryHeaderの大きさが異常です");
+
+        //! A global variable (constant expression).
+        /*!
+            バイナリ形式のデータファイルの種類を表す文字列
+        */
+        static char const BINARYMAGIC[8] = { 'S', 'V', '2', 'R', 'A', 'D', 'L', '\0' };
+
+        //! A function.
+        /*!
+            文字列を固定長の配列に書き込む（入りきらなければ例外を投げる）
+            \param dst 書き込む先の配列
+            \param size 配列の大きさ
+            \param src 文字列
+        */
+        void Copy_name(char * dst, std::size_t size, std::string const & src)
+        {
+            if (src.size() >= size) {
+                throw std::runtime_error("バイナリ形式のデータファイルに書き込めない名前です！");
+            }
+
+            std::memcpy(dst, src.data(), src.size());
+        }
+
+        //! A function.
+        /*!
+            固定長の配列から、0で終わる文字列を取り出す
+            \param src 配列
+            \param size 配列の大きさ
+            \return 文字列
+        */
+        std::string Read_name(char const * src, std::size_t size)
+        {
+            auto const end = std::find(src, src + size, '\0');
+            return std::string(src, end);
+        }
+    }
+
+    // #region コンストラクタ
 
     GetData::GetData(std::string const & filename) :
         Atomname([this] { return std::cref(atomname_); }, nullptr),
+        From_binary([this] { return frombinary_; }, nullptr),
+        Hash([this] { return hash_; }, nullptr),
         Phimax([this] { return phimax_; }, nullptr),
         L([this] { return l_; }, nullptr),
         N([this] { return n_; }, nullptr),
         Orbital([this] { return orbital_; }, nullptr),
+        Radial_table([this] { return std::cref(*pradialtable_); }, nullptr),
         R2rhomaxr([this] { return r2rhomaxr_; }, nullptr),
         Rho_wf_type([this] { return rho_wf_type_; }, nullptr),
         R_meshmax([this] { return r_meshmax_; }, nullptr),
         R_meshmin([this] { return r_meshmin_; }, nullptr),
-        acc_(gsl_interp_accel_alloc(), gsl_interp_accel_free),
         spline_(nullptr, gsl_spline_free)
     {
         using namespace boost::algorithm;
 
-        // g[N
+        // トークン分割
         std::vector<std::string> tokenstmp, tokens;
-        split(tokenstmp, filename, is_any_of("\\"), token_compress_on);
+        split(tokenstmp, filename, is_any_of("\\/"), token_compress_on);
         split(tokens, tokenstmp.back(), is_any_of("_"), token_compress_on);
 
         if (tokens[0].find("rho") != std::string::npos) {
@@ -43,7 +159,7 @@ namespace getdata {
             rho_wf_type_ = GetData::Rho_Wf_type::WF;
         }
         else {
-            throw std::runtime_error("t@CُłI");
+            throw std::runtime_error("ファイル名が異常です！");
         }
 
         if (tokens[1] == "H") {
@@ -53,7 +169,7 @@ namespace getdata {
             atomname_ = "Helium";
         }
         else {
-            throw std::runtime_error("t@CُłI");
+            throw std::runtime_error("ファイル名が異常です！");
         }
 
         orbital_ = tokens[2][0];
@@ -86,10 +202,139 @@ namespace getdata {
             break;
 
         default:
-            throw std::runtime_error("t@CُłI");
+            throw std::runtime_error("ファイル名が異常です！");
             break;
         }
 
+        // 新しいバイナリ形式のデータファイルがあれば、テキストの解析と3次スプラインの計算を省く
+        frombinary_ = Load_binary(Binary_path(filename), filename);
+        if (!frombinary_) {
+            Load_csv(filename);
+        }
+
+        r_meshmax_ = r_mesh_.back();
+        r_meshmin_ = r_mesh_[0];
+
+        // 読み込んだデータの中身のハッシュ値（点群のキャッシュのキーに使う、どちらの形式から読み込んでも同じ値になる）
+        hash_ = utility::Fnv1a(rho_wf_type_);
+        hash_ = utility::Fnv1a(n_, hash_);
+        hash_ = utility::Fnv1a(l_, hash_);
+        hash_ = utility::Fnv1a(r_mesh_.data(), sizeof(double) * r_mesh_.size(), hash_);
+        hash_ = utility::Fnv1a(phi_.data(), sizeof(double) * phi_.size(), hash_);
+    }
+
+    // #endregion コンストラクタ
+
+    // #region publicメンバ関数
+
+    std::string GetData::Binary_path(std::string const & filename)
+    {
+        return std::filesystem::path(filename).replace_extension(BINARY_EXTENSION).string();
+    }
+
+    void GetData::Write_binary(std::string const & path) const
+    {
+        BinaryHeader header{};
+        std::memcpy(header.magic, BINARYMAGIC, sizeof(BINARYMAGIC));
+        header.version = BINARY_VERSION;
+        header.rho_wf_type = static_cast<std::uint32_t>(rho_wf_type_);
+        header.n = n_;
+        header.l = l_;
+        header.size = r_mesh_.size();
+        header.phimax = phimax_;
+        header.r2rhomaxr = r2rhomaxr_;
+        Copy_name(header.atomname, sizeof(header.atomname), atomname_);
+        Copy_name(header.orbital, sizeof(header.orbital), orbital_);
+
+        std::ofstream ofs(path, std::ios::binary);
+        auto const write = [&ofs](std::vector<double> const & v) {
+            ofs.write(reinterpret_cast<char const *>(v.data()), static_cast<std::streamsize>(sizeof(double) * v.size()));
+        };
+
+        ofs.write(reinterpret_cast<char const *>(&header), sizeof(BinaryHeader));
+        write(r_mesh_);
+        write(phi_);
+        write(pradialtable_->A());
+        write(pradialtable_->B());
+        write(pradialtable_->C());
+        write(pradialtable_->D());
+
+        if (!ofs) {
+            throw std::runtime_error("バイナリ形式のデータファイルを作成できません！");
+        }
+    }
+
+    // #endregion publicメンバ関数
+
+    // #region privateメンバ関数
+
+    void GetData::Init_spline() const
+    {
+        spline_.reset(gsl_spline_alloc(gsl_interp_cspline, r_mesh_.size()));
+        gsl_spline_init(spline_.get(), r_mesh_.data(), phi_.data(), r_mesh_.size());
+    }
+
+    bool GetData::Load_binary(std::string const & path, std::string const & filename)
+    {
+        using namespace boost::interprocess;
+
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec)) {
+            return false;
+        }
+
+        // 元のデータファイルの方が新しければ、書き出した後に更新されたので使わない
+        auto const binarytime = std::filesystem::last_write_time(path, ec);
+        auto const csvtime = std::filesystem::last_write_time(filename, ec);
+        if (!ec && csvtime > binarytime) {
+            return false;
+        }
+
+        try {
+            // ファイル全体を1度だけマップし、ヘッダを確かめてから配列を取り出す
+            file_mapping const fm(path.c_str(), read_only);
+            mapped_region const region(fm, read_only);
+
+            auto const base = static_cast<char const *>(region.get_address());
+            if (region.get_size() < sizeof(BinaryHeader)) {
+                return false;
+            }
+
+            BinaryHeader header;
+            std::memcpy(&header, base, sizeof(BinaryHeader));
+
+            auto const size = static_cast<std::size_t>(header.size);
+            if (std::memcmp(header.magic, BINARYMAGIC, sizeof(BINARYMAGIC)) || header.version != BINARY_VERSION || size < 2 ||
+                region.get_size() != sizeof(BinaryHeader) + sizeof(double) * (2 * size + 4 * (size - 1))) {
+                return false;
+            }
+
+            // ファイル名から判別した内容と食い違うファイルは使わない
+            if (header.rho_wf_type != static_cast<std::uint32_t>(rho_wf_type_) || header.n != n_ || header.l != l_ ||
+                Read_name(header.atomname, sizeof(header.atomname)) != atomname_ || Read_name(header.orbital, sizeof(header.orbital)) != orbital_) {
+                return false;
+            }
+
+            auto const data = reinterpret_cast<double const *>(base + sizeof(BinaryHeader));
+            r_mesh_.assign(data, data + size);
+            phi_.assign(data + size, data + 2 * size);
+
+            auto const coefficients = data + 2 * size;
+            pradialtable_ = std::make_unique<RadialTable const>(
+                r_mesh_, coefficients, coefficients + (size - 1), coefficients + 2 * (size - 1), coefficients + 3 * (size - 1));
+
+            phimax_ = header.phimax;
+            r2rhomaxr_ = header.r2rhomaxr;
+        }
+        catch (interprocess_exception const &) {
+            return false;
+        }
+
+        return true;
+    }
+
+    void GetData::Load_csv(std::string const & filename)
+    {
         auto const restuple = ReadDataFile().readdatafile(filename);
         r_mesh_.assign(std::get<0>(restuple).begin(), std::get<0>(restuple).end());
         phi_.assign(std::get<1>(restuple).begin(), std::get<1>(restuple).end());
@@ -98,14 +343,9 @@ namespace getdata {
 
         phimax_ = *boost::max_element(phi_);
 
-        r_meshmax_ = r_mesh_.back();
-        r_meshmin_ = r_mesh_[0];
-
-        spline_.reset();
-        spline_ = std::unique_ptr<gsl_spline, decltype(&gsl_spline_free)>(
-            gsl_spline_alloc(gsl_interp_cspline, r_mesh_.size()), gsl_spline_free);
+        Init_spline();
 
-        gsl_spline_init(spline_.get(), r_mesh_.data(), phi_.data(), r_mesh_.size());
+        pradialtable_ = std::make_unique<RadialTable const>(r_mesh_, spline_.get());
 
         std::vector<double> temp(phi_);
 
@@ -118,6 +358,5 @@ namespace getdata {
         r2rhomaxr_ = r_mesh_[std::distance(temp.begin(), boost::max_element(temp))];
     }
 
-    // #endregion RXgN^
-
+    // #endregion privateメンバ関数
 }
@@ -10,11 +10,14 @@
 
 #pragma once
 
+#include "radialtable.h"
 #include "../utility/property.h"
-#include <cstdint>          // for std::int32_t, std::uint32_t
+#include <cstdint>          // for std::int32_t, std::uint32_t, std::uint64_t
 #include <memory>           // for std::unique_ptr
+#include <mutex>            // for std::call_once, std::once_flag
 #include <string>           // for std::string
-#include <gsl/gsl_spline.h> // for gsl_interp_accel, gsl_interp_accel_free, gsl_spline, gsl_spline_free
+#include <vector>           // for std::vector
+#include <gsl/gsl_spline.h> // for gsl_interp_accel, gsl_interp_accel_alloc, gsl_interp_accel_free, gsl_spline, gsl_spline_free
 
 namespace getdata {
     using namespace utility;
@@ -40,11 +43,22 @@ namespace getdata {
 
         // #endregion 列挙型
 
+        // #region 型エイリアス
+
+        //! A typedef.
+        /*!
+            gsl_interp_accelへのスマートポインタの型
+        */
+        using accel_ptr = std::unique_ptr<gsl_interp_accel, decltype(&gsl_interp_accel_free)>;
+
+        // #endregion 型エイリアス
+
         // #region コンストラクタ・デストラクタ
 
         //! A constructor.
         /*!
             唯一のコンストラクタ
+            同じ名前で拡張子が.sv2rのバイナリ形式のデータファイルがあり、元のファイルより新しければそちらを読み込む
             \param filename rのメッシュと、そのメッシュにおける電子密度が記録されたデータファイル名
         */
         GetData(std::string const & filename);
@@ -61,7 +75,7 @@ namespace getdata {
 
         //!  A public member function (const).
         /*!
-            関数の値を返す
+            関数の値を返す（区間の探索には二分探索を使う）
             \param r rの値
             \return 関数の値
         */
@@ -69,22 +83,107 @@ namespace getdata {
 
         //!  A public member function (const).
         /*!
-            関数の微分の値を返す
+            呼び出し側が所有するgsl_interp_accelを使って関数の値を返す
+            accはスレッドごとに別のものを使うこと
+            \param r rの値
+            \param acc 区間の探索に使うgsl_interp_accel
+            \return 関数の値
+        */
+        double operator()(double r, gsl_interp_accel * acc) const;
+
+        //!  A public member function (const).
+        /*!
+            関数の微分の値を返す（区間の探索には二分探索を使う）
             \param r rの値
             \return 関数の微分の値
         */
         double dphidr(double r) const;
 
+        //!  A public member function (const).
+        /*!
+            呼び出し側が所有するgsl_interp_accelを使って関数の微分の値を返す
+            accはスレッドごとに別のものを使うこと
+            \param r rの値
+            \param acc 区間の探索に使うgsl_interp_accel
+            \return 関数の微分の値
+        */
+        double dphidr(double r, gsl_interp_accel * acc) const;
+
+        //!  A public static member function.
+        /*!
+            データファイル名から、対応するバイナリ形式のデータファイル名を求める
+            \param filename データファイル名
+            \return バイナリ形式のデータファイル名
+        */
+        static std::string Binary_path(std::string const & filename);
+
+        //!  A public static member function.
+        /*!
+            operator()とdphidrに渡すgsl_interp_accelを確保する
+            \return gsl_interp_accelへのスマートポインタ
+        */
+        static accel_ptr Make_accel();
+
+        //!  A public member function (const).
+        /*!
+            読み込んだデータを、3次スプラインの係数とともにバイナリ形式のデータファイルに書き出す
+            \param path 書き出すファイル名
+        */
+        void Write_binary(std::string const & path) const;
+
+    private:
+        //!  A private member function (const).
+        /*!
+            r_mesh_とphi_から3次スプラインを作る
+        */
+        void Init_spline() const;
+
+        //!  A private member function.
+        /*!
+            バイナリ形式のデータファイルを読み込む
+            \param path バイナリ形式のデータファイル名
+            \param filename 元のデータファイル名（こちらの方が新しければ読み込まない）
+            \return 読み込めたかどうか（ファイルがない、古い、内容が異常な場合はfalse）
+        */
+        bool Load_binary(std::string const & path, std::string const & filename);
+
+        //!  A private member function.
+        /*!
+            テキスト形式（csv）のデータファイルを読み込み、3次スプラインと係数表を作る
+            \param filename データファイル名
+        */
+        void Load_csv(std::string const & filename);
+
+        //!  A private member function (const).
+        /*!
+            3次スプラインを返す（バイナリ形式のデータファイルから読み込んだ場合は、初めて呼ばれたときに作る）
+            \return 3次スプライン
+        */
+        gsl_spline const * Spline() const;
+
         // #endregion メンバ関数
 
         // #region プロパティ
 
+    public:
         //! A property.
         /*!
             元素名
         */
         Property<std::string const&> Atomname;
 
+        //! A property.
+        /*!
+            バイナリ形式のデータファイルから読み込んだかどうかへのプロパティ
+        */
+        Property<bool> const From_binary;
+
+        //! A property.
+        /*!
+            データ（方程式のタイプ、量子数、rのメッシュと関数の値）のハッシュ値へのプロパティ
+        */
+        Property<std::uint64_t> const Hash;
+
         //!  A property.
         /*!
             方位量子数へのプロパティ
@@ -109,6 +208,12 @@ namespace getdata {
         */
         Property<double> const Phimax;
 
+        //! A property.
+        /*!
+            3次スプラインの係数表へのプロパティ
+        */
+        Property<RadialTable const &> const Radial_table;
+
         //! A property.
         /*!
             波動関数が最大値を取るときのrへのプロパティ
@@ -137,19 +242,37 @@ namespace getdata {
 
         // #region メンバ変数
 
-    private:
-        //! A private member variable.
+    public:
+        //!  A public static member variable (constant expression).
+        /*!
+            バイナリ形式のデータファイルの拡張子
+        */
+        static constexpr char const * BINARY_EXTENSION = ".sv2r";
+
+        //!  A public static member variable (constant expression).
         /*!
-            gsl_interp_accelへのスマートポインタ
+            バイナリ形式のデータファイルの版（形式を変えたら1増やす）
         */
-        std::unique_ptr<gsl_interp_accel, decltype(&gsl_interp_accel_free)> const acc_;
+        static std::uint32_t constexpr BINARY_VERSION = 1;
 
+    private:
         //!  A private member variable.
         /*!
             元素名
         */
         std::string atomname_;
 
+        //!  A private member variable.
+        /*!
+            バイナリ形式のデータファイルから読み込んだかどうか
+        */
+        bool frombinary_ = false;
+
+        //!  A private member variable.
+        /*!
+            データのハッシュ値
+        */
+        std::uint64_t hash_;
 
         //!  A private member variable.
         /*!
@@ -181,6 +304,12 @@ namespace getdata {
         */
         double phimax_;
 
+        //! A private member variable.
+        /*!
+            3次スプラインの係数表へのスマートポインタ
+        */
+        std::unique_ptr<RadialTable const> pradialtable_;
+
         //!  A private member variable.
         /*!
             波動関数が最大値を取るときのr
@@ -215,7 +344,13 @@ namespace getdata {
         /*!
             gsl_interp_typeへのスマートポインタ
         */
-        std::unique_ptr<gsl_spline, decltype(&gsl_spline_free)> spline_;
+        mutable std::unique_ptr<gsl_spline, decltype(&gsl_spline_free)> spline_;
+
+        //! A private member variable.
+        /*!
+            3次スプラインを1度だけ作るためのフラグ
+        */
+        mutable std::once_flag splineonce_;
 
         // #endregion メンバ変数
 
@@ -250,12 +385,38 @@ namespace getdata {
 
     inline double GetData::operator()(double r) const
     {
-        return gsl_spline_eval(spline_.get(), r, acc_.get());
+        return gsl_spline_eval(Spline(), r, nullptr);
+    }
+
+    inline double GetData::operator()(double r, gsl_interp_accel * acc) const
+    {
+        return gsl_spline_eval(Spline(), r, acc);
     }
 
     inline double GetData::dphidr(double r) const
     {
-        return gsl_spline_eval_deriv(spline_.get(), r, acc_.get());
+        return gsl_spline_eval_deriv(Spline(), r, nullptr);
+    }
+
+    inline double GetData::dphidr(double r, gsl_interp_accel * acc) const
+    {
+        return gsl_spline_eval_deriv(Spline(), r, acc);
+    }
+
+    inline GetData::accel_ptr GetData::Make_accel()
+    {
+        return accel_ptr(gsl_interp_accel_alloc(), gsl_interp_accel_free);
+    }
+
+    inline gsl_spline const * GetData::Spline() const
+    {
+        std::call_once(splineonce_, [this] {
+            if (!spline_) {
+                Init_spline();
+            }
+        });
+
+        return spline_.get();
     }
 
     // #endregion メンバ関数
@@ -0,0 +1,173 @@
+﻿/*! \file radialtable.cpp
+    \brief 動径関数の3次スプラインの係数表を使って、動径関数とその微分を求めるクラスの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "radialtable.h"
+#include "radialtableavx2.h"
+#include <algorithm>        // for std::min
+#include <array>            // for std::array
+#include <cmath>            // for std::fabs, std::log
+#include <cstdint>          // for std::int32_t
+#include <stdexcept>        // for std::runtime_error
+
+#if defined(_MSC_VER)
+    #include <intrin.h>     // for __cpuid, __cpuidex, _xgetbv
+#endif
+
+namespace getdata {
+    namespace {
+        //! A function.
+        /*!
+            CPUとOSがAVX2に対応しているかどうかを調べる
+            \return AVX2が使えるかどうか
+        */
+        bool Avx2_supported()
+        {
+#if defined(_MSC_VER)
+            std::array<int, 4> info;
+            __cpuid(info.data(), 0);
+            if (info[0] < 7) {
+                return false;
+            }
+
+            // AVXとOSXSAVEに対応していて、OSがYMMレジスタを保存する必要がある
+            __cpuid(info.data(), 1);
+            if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 0x6) != 0x6) {
+                return false;
+            }
+
+            __cpuidex(info.data(), 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+        }
+    }
+
+    // #region コンストラクタ
+
+    RadialTable::RadialTable(std::vector<double> const & r_mesh, gsl_spline const * spline)
+    {
+        auto const size = r_mesh.size();
+        if (size < 2) {
+            throw std::runtime_error("データファイルが異常です！");
+        }
+
+        // 最後の区間の右端も持っておく
+        r_mesh_ = r_mesh;
+
+        a_.resize(size - 1);
+        b_.resize(size - 1);
+        c_.resize(size - 1);
+        d_.resize(size - 1);
+
+        // gslの3次スプラインの値と導関数から、各区間の左端を原点とする3次多項式の係数を求める
+        auto d2left = gsl_spline_eval_deriv2(spline, r_mesh[0], nullptr);
+        for (auto i = 0U; i < size - 1; i++) {
+            auto const h = r_mesh[i + 1] - r_mesh[i];
+            auto const d2right = gsl_spline_eval_deriv2(spline, r_mesh[i + 1], nullptr);
+
+            a_[i] = gsl_spline_eval(spline, r_mesh[i], nullptr);
+            b_[i] = gsl_spline_eval_deriv(spline, r_mesh[i], nullptr);
+            c_[i] = 0.5 * d2left;
+            d_[i] = (d2right - d2left) / (6.0 * h);
+
+            d2left = d2right;
+        }
+
+        Detect_log_mesh();
+    }
+
+    RadialTable::RadialTable(std::vector<double> const & r_mesh, double const * a, double const * b, double const * c, double const * d)
+    {
+        auto const size = r_mesh.size();
+        if (size < 2) {
+            throw std::runtime_error("データファイルが異常です！");
+        }
+
+        r_mesh_ = r_mesh;
+
+        a_.assign(a, a + size - 1);
+        b_.assign(b, b + size - 1);
+        c_.assign(c, c + size - 1);
+        d_.assign(d, d + size - 1);
+
+        Detect_log_mesh();
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    void RadialTable::operator()(double const * r, double * phi, std::size_t n) const
+    {
+        Eval<false>(r, phi, nullptr, n);
+    }
+
+    void RadialTable::operator()(double const * r, double * phi, double * dphidr, std::size_t n) const
+    {
+        Eval<true>(r, phi, dphidr, n);
+    }
+
+    bool RadialTable::Use_avx2()
+    {
+        static auto const avx2 = Avx2_supported();
+        return avx2;
+    }
+
+    void RadialTable::Detect_log_mesh()
+    {
+        auto const size = r_mesh_.size();
+
+        // log(r)が等間隔かどうか調べる
+        if (r_mesh_[0] > 0.0) {
+            logrmin_ = std::log(r_mesh_[0]);
+            auto const dlogr = (std::log(r_mesh_[size - 1]) - logrmin_) / static_cast<double>(size - 1);
+
+            islogmesh_ = dlogr > 0.0;
+            for (auto i = 1U; i < size && islogmesh_; i++) {
+                auto const expected = logrmin_ + dlogr * static_cast<double>(i);
+                islogmesh_ = std::fabs(std::log(r_mesh_[i]) - expected) < LOGMESHTOLERANCE * dlogr;
+            }
+
+            invdlogr_ = islogmesh_ ? 1.0 / dlogr : 0.0;
+        }
+    }
+
+    template <bool DERIV>
+    void RadialTable::Eval(double const * r, double * phi, double * dphidr, std::size_t n) const
+    {
+        std::size_t k = 0;
+
+        if (Use_avx2()) {
+            // 区間の探索はスカラーで行い、係数の読み出しと多項式の評価をAVX2で行う
+            std::array<std::int32_t, AVX2BLOCK> idx;
+            while (k + 4 <= n) {
+                auto const size = std::min(AVX2BLOCK, (n - k) & ~static_cast<std::size_t>(3));
+                for (std::size_t j = 0; j < size; j++) {
+                    idx[j] = static_cast<std::int32_t>(Index(r[k + j]));
+                }
+
+                Eval_avx2(r + k, idx.data(), size, r_mesh_.data(), a_.data(), b_.data(), c_.data(), d_.data(),
+                          phi + k, DERIV ? dphidr + k : nullptr);
+                k += size;
+            }
+        }
+
+        for (; k < n; k++) {
+            auto const i = Index(r[k]);
+            auto const t = r[k] - r_mesh_[i];
+            phi[k] = a_[i] + t * (b_[i] + t * (c_[i] + t * d_[i]));
+
+            if constexpr (DERIV) {
+                dphidr[k] = b_[i] + t * (2.0 * c_[i] + t * (3.0 * d_[i]));
+            }
+        }
+    }
+
+    // #endregion メンバ関数
+}
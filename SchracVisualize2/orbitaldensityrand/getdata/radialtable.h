@@ -0,0 +1,307 @@
+﻿/*! \file radialtable.h
+    \brief 動径関数の3次スプラインの係数表を使って、動径関数とその微分を求めるクラスの宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _RADIALTABLE_H_
+#define _RADIALTABLE_H_
+
+#pragma once
+
+#include <cmath>            // for std::log
+#include <cstddef>          // for std::size_t
+#include <vector>           // for std::vector
+#include <gsl/gsl_spline.h> // for gsl_spline
+
+namespace getdata {
+    //! A class.
+    /*!
+        gsl_splineの各区間の3次多項式の係数を、区間ごとの配列（SoA）として保持するクラス
+        メッシュが対数メッシュの場合は、区間の探索を二分探索ではなくlog(r)からO(1)で行う
+    */
+    class RadialTable final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param r_mesh rのメッシュ
+            \param spline r_meshで初期化済みの3次スプライン
+        */
+        RadialTable(std::vector<double> const & r_mesh, gsl_spline const * spline);
+
+        //! A constructor.
+        /*!
+            保存しておいた係数から作るコンストラクタ
+            \param r_mesh rのメッシュ
+            \param a 各区間の0次の係数（r_mesh.size() - 1個）
+            \param b 各区間の1次の係数（r_mesh.size() - 1個）
+            \param c 各区間の2次の係数（r_mesh.size() - 1個）
+            \param d 各区間の3次の係数（r_mesh.size() - 1個）
+        */
+        RadialTable(std::vector<double> const & r_mesh, double const * a, double const * b, double const * c, double const * d);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~RadialTable() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            各区間の0次の係数を返す
+            \return 各区間の0次の係数
+        */
+        std::vector<double> const & A() const
+        {
+            return a_;
+        }
+
+        //!  A public member function (const).
+        /*!
+            各区間の1次の係数を返す
+            \return 各区間の1次の係数
+        */
+        std::vector<double> const & B() const
+        {
+            return b_;
+        }
+
+        //!  A public member function (const).
+        /*!
+            各区間の2次の係数を返す
+            \return 各区間の2次の係数
+        */
+        std::vector<double> const & C() const
+        {
+            return c_;
+        }
+
+        //!  A public member function (const).
+        /*!
+            各区間の3次の係数を返す
+            \return 各区間の3次の係数
+        */
+        std::vector<double> const & D() const
+        {
+            return d_;
+        }
+
+        //!  A public member function (const).
+        /*!
+            rのメッシュを返す
+            \return rのメッシュ
+        */
+        std::vector<double> const & R_mesh() const
+        {
+            return r_mesh_;
+        }
+
+        //!  A public member function (const).
+        /*!
+            関数の値を返す
+            \param r rの値（rのメッシュの範囲内であること）
+            \return 関数の値
+        */
+        double operator()(double r) const;
+
+        //!  A public member function (const).
+        /*!
+            n個のrについて、関数の値をまとめて求める
+            CPUがAVX2に対応している場合は4個ずつSIMDで評価する
+            \param r rの値の配列（rのメッシュの範囲内であること）
+            \param phi 関数の値を格納する配列
+            \param n 配列の要素数
+        */
+        void operator()(double const * r, double * phi, std::size_t n) const;
+
+        //!  A public member function (const).
+        /*!
+            n個のrについて、関数の値と微分の値をまとめて求める
+            CPUがAVX2に対応している場合は4個ずつSIMDで評価する
+            \param r rの値の配列（rのメッシュの範囲内であること）
+            \param phi 関数の値を格納する配列
+            \param dphidr 関数の微分の値を格納する配列
+            \param n 配列の要素数
+        */
+        void operator()(double const * r, double * phi, double * dphidr, std::size_t n) const;
+
+        //!  A public member function (const).
+        /*!
+            関数の微分の値を返す
+            \param r rの値（rのメッシュの範囲内であること）
+            \return 関数の微分の値
+        */
+        double dphidr(double r) const;
+
+        //!  A public member function (const).
+        /*!
+            rが属する区間のインデックスを返す
+            \param r rの値
+            \return r_mesh[i] <= r < r_mesh[i + 1]となるi（範囲外の場合は両端の区間）
+        */
+        std::size_t Index(double r) const;
+
+        //!  A public member function (const).
+        /*!
+            メッシュが対数メッシュとして扱われているかどうかを返す
+            \return 対数メッシュとして扱われているかどうか
+        */
+        bool Is_log_mesh() const
+        {
+            return islogmesh_;
+        }
+
+        //!  A public static member function.
+        /*!
+            バッチ評価でAVX2の関数を使うかどうかを返す（最初の呼び出しでCPUを調べる）
+            \return CPUとOSがAVX2に対応しているかどうか
+        */
+        static bool Use_avx2();
+
+    private:
+        //!  A private member function.
+        /*!
+            rのメッシュが対数メッシュかどうか調べ、区間の探索に使う値を求める
+        */
+        void Detect_log_mesh();
+
+        //!  A private member function (const).
+        /*!
+            n個のrについて、関数の値と（dphidrがnullptrでなければ）微分の値をまとめて求める
+            \param r rの値の配列
+            \param phi 関数の値を格納する配列
+            \param dphidr 関数の微分の値を格納する配列（nullptrなら求めない）
+            \param n 配列の要素数
+        */
+        template <bool DERIV>
+        void Eval(double const * r, double * phi, double * dphidr, std::size_t n) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable (constant expression).
+        /*!
+            AVX2で評価するときに、まとめて区間のインデックスを求める要素数（4の倍数）
+        */
+        static std::size_t constexpr AVX2BLOCK = 256;
+
+        //! A private member variable (constant expression).
+        /*!
+            対数メッシュとみなすときの、log(r)の等間隔からのずれの許容値（刻み幅に対する割合）
+        */
+        static auto constexpr LOGMESHTOLERANCE = 1.0E-3;
+
+        //! A private member variable.
+        /*!
+            各区間の0次の係数（区間の左端での関数の値）
+        */
+        std::vector<double> a_;
+
+        //! A private member variable.
+        /*!
+            各区間の1次の係数
+        */
+        std::vector<double> b_;
+
+        //! A private member variable.
+        /*!
+            各区間の2次の係数
+        */
+        std::vector<double> c_;
+
+        //! A private member variable.
+        /*!
+            各区間の3次の係数
+        */
+        std::vector<double> d_;
+
+        //! A private member variable.
+        /*!
+            log(r)の刻み幅の逆数
+        */
+        double invdlogr_ = 0.0;
+
+        //! A private member variable.
+        /*!
+            メッシュが対数メッシュかどうか
+        */
+        bool islogmesh_ = false;
+
+        //! A private member variable.
+        /*!
+            log(r)のメッシュの最小値
+        */
+        double logrmin_ = 0.0;
+
+        //! A private member variable.
+        /*!
+            rのメッシュ（各区間の左端）
+        */
+        std::vector<double> r_mesh_;
+
+        // #endregion メンバ変数
+    };
+
+    // #region メンバ関数
+
+    inline double RadialTable::operator()(double r) const
+    {
+        auto const i = Index(r);
+        auto const t = r - r_mesh_[i];
+        return a_[i] + t * (b_[i] + t * (c_[i] + t * d_[i]));
+    }
+
+    inline double RadialTable::dphidr(double r) const
+    {
+        auto const i = Index(r);
+        auto const t = r - r_mesh_[i];
+        return b_[i] + t * (2.0 * c_[i] + t * (3.0 * d_[i]));
+    }
+
+    inline std::size_t RadialTable::Index(double r) const
+    {
+        auto const last = static_cast<std::ptrdiff_t>(r_mesh_.size()) - 2;
+
+        std::ptrdiff_t i;
+        if (islogmesh_) {
+            auto const di = (std::log(r) - logrmin_) * invdlogr_;
+            i = di <= 0.0 ? 0 : (di >= static_cast<double>(last) ? last : static_cast<std::ptrdiff_t>(di));
+
+            // 丸め誤差とメッシュのずれで、高々1区間ずれる
+            if (i > 0 && r < r_mesh_[i]) {
+                i--;
+            }
+            else if (i < last && r >= r_mesh_[i + 1]) {
+                i++;
+            }
+        }
+        else {
+            auto lo = std::ptrdiff_t(0);
+            auto hi = last + 1;
+            while (hi - lo > 1) {
+                auto const mid = (lo + hi) / 2;
+                if (r_mesh_[mid] > r) {
+                    hi = mid;
+                }
+                else {
+                    lo = mid;
+                }
+            }
+            i = lo > last ? last : lo;
+        }
+
+        return static_cast<std::size_t>(i);
+    }
+
+    // #endregion メンバ関数
+}
+
+#endif  // _RADIALTABLE_H_
@@ -0,0 +1,61 @@
+﻿/*! \file radialtableavx2.cpp
+    \brief 動径関数の3次スプラインの係数表をAVX2で評価する関数の実装
+    このファイルだけを/arch:AVX2でコンパイルする（インライン関数がAVX2の命令で生成されないよう、radialtable.hはインクルードしない）
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "radialtableavx2.h"
+#include <immintrin.h>  // for _mm256_mask_i32gather_pd
+
+#if defined(__GNUC__) && !defined(__AVX2__)
+    // GCCとClangでは、この翻訳単位の関数だけをAVX2向けに生成する
+    #pragma GCC target("avx2")
+#endif
+
+namespace getdata {
+    namespace {
+        //! A function.
+        /*!
+            base[idx[0]]、…、base[idx[3]]を読み出す
+            \param base 配列の先頭
+            \param idx 4個のインデックス
+            \return 読み出した値
+        */
+        inline __m256d Gather(double const * base, __m128i idx)
+        {
+            // 転送元をゼロで初期化するマスク付きの形を使う（_mm256_i32gather_pdはGCCで未初期化の警告が出る）
+            return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, idx, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+        }
+    }
+
+    void Eval_avx2(double const * r, std::int32_t const * idx, std::size_t n,
+                   double const * r_mesh, double const * a, double const * b, double const * c, double const * d,
+                   double * phi, double * dphidr)
+    {
+        for (std::size_t k = 0; k < n; k += 4) {
+            auto const i = _mm_loadu_si128(reinterpret_cast<__m128i const *>(idx + k));
+
+            auto const t = _mm256_sub_pd(_mm256_loadu_pd(r + k), Gather(r_mesh, i));
+            auto const ak = Gather(a, i);
+            auto const bk = Gather(b, i);
+            auto const ck = Gather(c, i);
+            auto const dk = Gather(d, i);
+
+            // a + t(b + t(c + td))
+            auto y = _mm256_add_pd(ck, _mm256_mul_pd(t, dk));
+            y = _mm256_add_pd(bk, _mm256_mul_pd(t, y));
+            y = _mm256_add_pd(ak, _mm256_mul_pd(t, y));
+
+            _mm256_storeu_pd(phi + k, y);
+
+            if (dphidr) {
+                // b + t(2c + 3td)
+                auto dy = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), ck), _mm256_mul_pd(t, _mm256_mul_pd(_mm256_set1_pd(3.0), dk)));
+                dy = _mm256_add_pd(bk, _mm256_mul_pd(t, dy));
+
+                _mm256_storeu_pd(dphidr + k, dy);
+            }
+        }
+    }
+}
@@ -0,0 +1,36 @@
+﻿/*! \file radialtableavx2.h
+    \brief 動径関数の3次スプラインの係数表をAVX2で評価する関数の宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _RADIALTABLEAVX2_H_
+#define _RADIALTABLEAVX2_H_
+
+#pragma once
+
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::int32_t
+
+namespace getdata {
+    //! A function.
+    /*!
+        区間のインデックスが求まっているn個のrについて、関数の値と（dphidrがnullptrでなければ）微分の値をAVX2で求める
+        この関数だけが/arch:AVX2でコンパイルされるので、RadialTable::Use_avx2()がtrueを返した場合にだけ呼ぶこと
+        \param r rの値の配列
+        \param idx 各rが属する区間のインデックスの配列
+        \param n 配列の要素数（4の倍数）
+        \param r_mesh rのメッシュ
+        \param a 各区間の0次の係数
+        \param b 各区間の1次の係数
+        \param c 各区間の2次の係数
+        \param d 各区間の3次の係数
+        \param phi 関数の値を格納する配列
+        \param dphidr 関数の微分の値を格納する配列（nullptrなら求めない）
+    */
+    void Eval_avx2(double const * r, std::int32_t const * idx, std::size_t n,
+                   double const * r_mesh, double const * a, double const * b, double const * c, double const * d,
+                   double * phi, double * dphidr);
+}
+
+#endif  // _RADIALTABLEAVX2_H_
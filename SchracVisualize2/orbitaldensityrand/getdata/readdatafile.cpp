@@ -1,57 +1,111 @@
-/*! \file readdatafile.cpp
-    \brief dqx̃f[^t@CǂݍރNX̎
+﻿/*! \file readdatafile.cpp
+    \brief 電子密度のデータファイルを読み込むクラスの実装
 
-    Copyright  2015-2019 @dc1394 All Rights Reserved.
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
     This software is released under the BSD 2-Clause License.
 */
 
-#include "DXUT.h"
 #include "readdatafile.h"
-#include <array>                        // for std::array
-#include <fstream>                      // for std::ifstream
-#include <stdexcept>                    // for std::runtime_error
-#include <boost/algorithm/string.hpp>   // for boost::algorithm
+#include <algorithm>                                // for std::count, std::find, std::find_if
+#include <cctype>                                   // for std::isspace
+#include <charconv>                                 // for std::from_chars
+#include <cstddef>                                  // for std::size_t
+#include <memory>                                   // for std::make_unique, std::unique_ptr
+#include <stdexcept>                                // for std::invalid_argument, std::out_of_range, std::runtime_error
+#include <system_error>                             // for std::errc
+#include <utility>                                  // for std::make_pair, std::move
+#include <boost/interprocess/file_mapping.hpp>      // for boost::interprocess::file_mapping
+#include <boost/interprocess/mapped_region.hpp>     // for boost::interprocess::mapped_region
 
 namespace getdata {
+    namespace {
+        //! A function.
+        /*!
+            トークンを浮動小数点数に変換する（std::stodと同じく先頭の空白と+記号を許し、トークン全体が数値でなければ例外を投げる）
+            \param first トークンの先頭
+            \param last トークンの末尾の次
+            \return 変換した値
+        */
+        double Parse_double(char const * first, char const * last)
+        {
+            while (first != last && std::isspace(static_cast<unsigned char>(*first))) {
+                ++first;
+            }
+
+            if (last - first > 1 && *first == '+' && first[1] != '+' && first[1] != '-') {
+                ++first;
+            }
+
+            auto value = 0.0;
+            auto const [ptr, ec] = std::from_chars(first, last, value);
+            if (ec == std::errc::invalid_argument) {
+                throw std::invalid_argument("Parse_double");
+            }
+            else if (ec == std::errc::result_out_of_range) {
+                throw std::out_of_range("Parse_double");
+            }
+            else if (ptr != last) {
+                throw std::runtime_error("データファイルが異常です！");
+            }
+
+            return value;
+        }
+    }
+
     ReadDataFile::mypair ReadDataFile::readdatafile(std::string const& filename) const
     {
-        std::ifstream ifs(filename);
-        std::array<char, BUFSIZE> buf;
-        std::vector<double> r_mesh, phiorrho;
+        using namespace boost::interprocess;
 
-        // g[N
-        std::vector<std::string> tokens;
+        // ファイルをメモリマップし、コピーせずに直接解析する
+        std::unique_ptr<mapped_region> region;
+        try {
+            file_mapping const fm(filename.c_str(), read_only);
+            region = std::make_unique<mapped_region>(fm, read_only);
+        }
+        catch (interprocess_exception const &) {
+            // 開けないファイルや空のファイル（大きさ0はマップできない）は、従来通り空のファイルとして扱う
+            throw std::runtime_error("データファイルが空です！");
+        }
 
-        for (auto i = 0;; i++) {
-            using namespace boost::algorithm;
+        auto const begin = static_cast<char const *>(region->get_address());
+        auto const end = begin + region->get_size();
+        if (begin == end) {
+            throw std::runtime_error("データファイルが空です！");
+        }
 
-            ifs.getline(buf.data(), BUFSIZE);
-            std::string line(buf.data());
+        // 行数で出力の大きさを見積もり、push_backによる再確保をなくす
+        auto const lines = static_cast<std::size_t>(std::count(begin, end, '\n')) + (end[-1] != '\n' ? 1 : 0);
+        std::vector<double> r_mesh, phiorrho;
+        r_mesh.reserve(lines);
+        phiorrho.reserve(lines);
 
-            split(tokens, line, is_any_of(","), token_compress_on);
+        for (auto p = begin; p != end;) {
+            auto const eol = std::find(p, end, '\n');
+            auto last = eol;
 
-            // ꕶǂ߂Ȃ
-            if (!ifs.gcount() && !i) {
-                throw std::runtime_error("f[^t@CłI");
+            // 改行コードがCR+LFのファイルをLinux等で読み込んだ場合
+            if (last != p && last[-1] == '\r') {
+                --last;
             }
-            else if (!ifs.gcount()) {
-                r_mesh.shrink_to_fit();
-                phiorrho.shrink_to_fit();
 
-                return std::make_pair(r_mesh, phiorrho);
-            }
-            else if (tokens.size() != 2) {
-                throw std::runtime_error("f[^t@CُłI");
+            // 連続した,は1つの区切りとみなし、ちょうど2つのトークンに分かれなければならない
+            auto const comma = std::find(p, last, ',');
+            if (comma == last) {
+                throw std::runtime_error("データファイルが異常です！");
             }
 
-            std::size_t index1, index2;
+            auto const second = std::find_if(comma, last, [](char c) { return c != ','; });
+            auto const secondlast = std::find(second, last, ',');
+            if (secondlast != last) {
+                throw std::runtime_error("データファイルが異常です！");
+            }
 
-            r_mesh.push_back(std::stod(tokens[0], &index1));
-            phiorrho.push_back(std::stod(tokens[1], &index2));
+            r_mesh.push_back(Parse_double(p, comma));
+            phiorrho.push_back(Parse_double(second, last));
 
-            if (tokens[0].size() != index1 || tokens[1].size() != index2) {
-                throw std::runtime_error("f[^t@CُłI");
-            }
+            p = eol == end ? end : eol + 1;
         }
+
+        return std::make_pair(std::move(r_mesh), std::move(phiorrho));
     }
 }
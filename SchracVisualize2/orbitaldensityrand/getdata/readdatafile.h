@@ -54,17 +54,6 @@ namespace getdata {
 
         // #endregion メンバ関数
 
-        // #region メンバ変数
-
-    private:
-        //!A private member variable(constant expression).
-        /*!
-            バッファサイズ
-        */
-        static std::streamsize const BUFSIZE = 1024;
-
-        // #endregion メンバ変数
-
         // #region 禁止されたコンストラクタ・メンバ関数
 
     private:
@@ -6,49 +6,174 @@
 */
 
 #include "myrandsfmt.h"
-#include <cmath>            // for std::sqrt, std::log, std::cos, std::sin
+#include <algorithm>    // for std::copy_n, std::min
+#include <cmath>        // for std::exp, std::fabs, std::log, std::sqrt
 
 namespace myrandom {
-    double MyRandSfmt::normal_distribution_rand()
-    {
-        using namespace boost::math::constants;
+    namespace {
+        //! A struct.
+        /*!
+            Ziggurat法（Doornik (2005) のZIGNOR）の表
+        */
+        struct ZigguratTable {
+            //! A public member variable (constant expression).
+            /*!
+                層の数
+            */
+            static std::size_t constexpr C = 128;
+
+            //! A public member variable (constant expression).
+            /*!
+                一番下の層の右端
+            */
+            static constexpr auto R = 3.442619855899;
+
+            //! A public member variable (constant expression).
+            /*!
+                各層の面積
+            */
+            static constexpr auto V = 9.91256303526217E-3;
+
+            //! A public member variable.
+            /*!
+                各層の右端
+            */
+            std::array<double, C + 1> x;
 
-        if (normal_dist_rand_.has_value()) {
-            auto const res = *normal_dist_rand_;
-            normal_dist_rand_ = std::nullopt;
+            //! A public member variable.
+            /*!
+                各層で、必ず分布の内側に入る部分の割合 x[i + 1] / x[i]
+            */
+            std::array<double, C> r;
 
-            return res;
+            //! A constructor.
+            /*!
+                唯一のコンストラクタ
+            */
+            ZigguratTable()
+            {
+                auto f = std::exp(-0.5 * R * R);
+                x[0] = V / f;
+                x[1] = R;
+                x[C] = 0.0;
+
+                for (auto i = 2U; i < C; i++) {
+                    x[i] = std::sqrt(-2.0 * std::log(V / x[i - 1] + f));
+                    f = std::exp(-0.5 * x[i] * x[i]);
+                }
+
+                for (auto i = 0U; i < C; i++) {
+                    r[i] = x[i + 1] / x[i];
+                }
+            }
+        };
+
+        //! A function.
+        /*!
+            Ziggurat法の表を返す（最初に呼ばれたときに作る）
+            \return Ziggurat法の表
+        */
+        ZigguratTable const & Ziggurat()
+        {
+            static ZigguratTable const zig;
+            return zig;
         }
-        else {
-            auto const r1 = myrand();
-            auto const r2 = myrand();
+    }
 
-            auto const res = std::sqrt(-2.0 * std::log(r1)) * std::cos(2.0 * pi<double>() * r2);
-            normal_dist_rand_ = std::make_optional(std::sqrt(-2.0 * std::log(r1)) * std::sin(2.0 * pi<double>() * r2));
+    // #region publicメンバ関数
 
-            return res;
+    void MyRandSfmt::myrand(double * x, std::size_t n)
+    {
+        while (n) {
+            if (uniformidx_ == UNIFORMSIZE) {
+                FillUniform();
+            }
+
+            auto const len = std::min(n, UNIFORMSIZE - uniformidx_);
+            std::copy_n(uniform_.begin() + uniformidx_, len, x);
+            uniformidx_ += len;
+            x += len;
+            n -= len;
         }
     }
 
-    double MyRandSfmt::normal_distribution_rand(double mu, double sigma2)
+    void MyRandSfmt::normal_distribution_rand(double * x, std::size_t n)
     {
-        using namespace boost::math::constants;
+        while (n) {
+            if (normalidx_ == NORMALSIZE) {
+                FillNormal();
+            }
 
-        auto const sigma = std::sqrt(sigma2);
-        if (normal_dist_rand_.has_value()) {
-            auto const res = *normal_dist_rand_;
-            normal_dist_rand_ = std::nullopt;
+            auto const len = std::min(n, NORMALSIZE - normalidx_);
+            std::copy_n(normal_.begin() + normalidx_, len, x);
+            normalidx_ += len;
+            x += len;
+            n -= len;
+        }
+    }
 
-            return res * sigma + mu;
+    // #endregion publicメンバ関数
+
+    // #region privateメンバ関数
+
+    void MyRandSfmt::FillNormal()
+    {
+        auto const & zig = Ziggurat();
+
+        for (auto && v : normal_) {
+            for (;;) {
+                // 下位7ビットで層を選び、上位53ビットから(-1, 1)の一様乱数を作る
+                auto const raw = NextRaw();
+                auto const i = static_cast<std::size_t>(raw & (ZigguratTable::C - 1));
+                auto const u = 2.0 * sfmt_to_res53(raw) - 1.0;
+
+                // ほとんど（約99%）はここで決まる
+                if (std::fabs(u) < zig.r[i]) {
+                    v = u * zig.x[i];
+                    break;
+                }
+
+                if (!i) {
+                    v = NormalTail(u < 0.0);
+                    break;
+                }
+
+                auto const x = u * zig.x[i];
+                auto const f0 = std::exp(-0.5 * (zig.x[i] * zig.x[i] - x * x));
+                auto const f1 = std::exp(-0.5 * (zig.x[i + 1] * zig.x[i + 1] - x * x));
+                if (f1 + sfmt_to_res53(NextRaw()) * (f0 - f1) < 1.0) {
+                    v = x;
+                    break;
+                }
+            }
         }
-        else {
-            auto const r1 = myrand();
-            auto const r2 = myrand();
-
-            auto const res = std::sqrt(-2.0 * std::log(r1)) * std::cos(2.0 * pi<double>() * r2) * sigma + mu;
-            normal_dist_rand_ = std::make_optional(std::sqrt(-2.0 * std::log(r1)) * std::sin(2.0 * pi<double>() * r2));
-            
-            return res;
+
+        normalidx_ = 0;
+    }
+
+    void MyRandSfmt::FillUniform()
+    {
+        for (auto i = 0U; i < UNIFORMSIZE / 2; i++) {
+            auto const raw = NextRaw();
+            uniform_[2 * i] = sfmt_to_real1(static_cast<std::uint32_t>(raw));
+            uniform_[2 * i + 1] = sfmt_to_real1(static_cast<std::uint32_t>(raw >> 32));
         }
+
+        uniformidx_ = 0;
     }
+
+    double MyRandSfmt::NormalTail(bool negative)
+    {
+        auto x = 0.0;
+        auto y = 0.0;
+        do {
+            // log(0)を避けるため(0, 1]の一様乱数を使う
+            x = std::log(1.0 - sfmt_to_res53(NextRaw())) / ZigguratTable::R;
+            y = std::log(1.0 - sfmt_to_res53(NextRaw()));
+        } while (-2.0 * y < x * x);
+
+        return negative ? x - ZigguratTable::R : ZigguratTable::R - x;
+    }
+
+    // #endregion privateメンバ関数
 }
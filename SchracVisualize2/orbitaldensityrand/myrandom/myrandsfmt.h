@@ -11,14 +11,17 @@
 #pragma once
 
 #include "../SFMT-src-1.5.1/SFMT.h"
-#include <optional>                             // for std::optional
+#include <array>                                // for std::array
+#include <cmath>                                // for std::sqrt
+#include <cstddef>                              // for std::size_t
+#include <cstdint>                              // for std::uint32_t, std::uint64_t
 #include <random>						        // for std::random_device
-#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
 
 namespace myrandom {
     //! A class.
     /*!
         自作乱数クラス
+        sfmt_fill_array64でまとめて生成した乱数から、一様乱数と正規乱数（Ziggurat法）をブロック単位で作っておき、1つずつ（または配列で）取り出す
     */
     class MyRandSfmt final {
         // #region コンストラクタ・デストラクタ
@@ -30,6 +33,22 @@ namespace myrandom {
         */
         MyRandSfmt();
 
+        //! A constructor.
+        /*!
+            シードを指定するコンストラクタ
+            \param seed 乱数のシード
+        */
+        explicit MyRandSfmt(std::uint32_t seed);
+
+        //! A constructor.
+        /*!
+            シードと乱数列の番号を指定するコンストラクタ
+            (seed, stream)を鍵としてsfmt_init_by_arrayで初期化するので、streamが異なれば互いに独立とみなせる乱数列になる
+            \param seed 乱数のシード
+            \param stream 乱数列の番号
+        */
+        MyRandSfmt(std::uint32_t seed, std::uint64_t stream);
+
         //! A destructor.
         /*!
             デフォルトデストラクタ
@@ -47,15 +66,34 @@ namespace myrandom {
         */
         double myrand()
         {
-            return sfmt_genrand_real1(&sfmt_);
+            if (uniformidx_ == UNIFORMSIZE) {
+                FillUniform();
+            }
+
+            return uniform_[uniformidx_++];
         }
 
+        //!  A public member function.
+        /*!
+            [0.0, 1.0]の閉区間の一様乱数をn個生成する
+            \param x 一様乱数を格納する配列
+            \param n 生成する個数
+        */
+        void myrand(double * x, std::size_t n);
+
         //!  A public member function.
         /*!
             平均0、分散1の正規乱数を生成する
             \return 平均0、分散1の正規乱数
         */
-        double normal_distribution_rand();
+        double normal_distribution_rand()
+        {
+            if (normalidx_ == NORMALSIZE) {
+                FillNormal();
+            }
+
+            return normal_[normalidx_++];
+        }
 
         //!  A public member function.
         /*!
@@ -64,25 +102,123 @@ namespace myrandom {
             \param sigma2 正規乱数の分散
             \return 平均mu、分散sigma^2の正規乱数
         */
-        double normal_distribution_rand(double mu, double sigma2);
+        double normal_distribution_rand(double mu, double sigma2)
+        {
+            return normal_distribution_rand() * std::sqrt(sigma2) + mu;
+        }
+
+        //!  A public member function.
+        /*!
+            平均0、分散1の正規乱数をn個生成する
+            \param x 正規乱数を格納する配列
+            \param n 生成する個数
+        */
+        void normal_distribution_rand(double * x, std::size_t n);
+
+    private:
+        //!  A private member function.
+        /*!
+            正規乱数のブロックを、Ziggurat法でまとめて生成する
+        */
+        void FillNormal();
+
+        //!  A private member function.
+        /*!
+            一様乱数のブロックをまとめて生成する
+        */
+        void FillUniform();
+
+        //!  A private member function.
+        /*!
+            sfmt_fill_array64で生成した64ビット整数を1つ取り出す
+            \return 64ビットの整数乱数
+        */
+        std::uint64_t NextRaw()
+        {
+            if (rawidx_ == RAWSIZE) {
+                sfmt_fill_array64(&sfmt_, raw_.data(), static_cast<int>(RAWSIZE));
+                rawidx_ = 0;
+            }
+
+            return raw_[rawidx_++];
+        }
+
+        //!  A private member function.
+        /*!
+            Ziggurat法の底の層で、裾野（|x| > R）の正規乱数を生成する
+            \param negative 負の値を返すかどうか
+            \return 裾野の正規乱数
+        */
+        double NormalTail(bool negative);
 
         // #endregion メンバ関数
 
         // #region メンバ変数
 
-    private:
+        //! A private member variable (constant expression).
+        /*!
+            sfmt_fill_array64で一度に生成する64ビット整数の個数
+        */
+        static std::size_t constexpr RAWSIZE = 1024;
+
+        static_assert(RAWSIZE >= SFMT_N64 && RAWSIZE % 2 == 0, "RAWSIZEはsfmt_fill_array64の要件を満たす必要があります");
+
+        //! A private member variable (constant expression).
+        /*!
+            正規乱数のブロックの大きさ
+        */
+        static std::size_t constexpr NORMALSIZE = 1024;
+
+        //! A private member variable (constant expression).
+        /*!
+            一様乱数のブロックの大きさ（64ビット整数1個から32ビットの一様乱数2個を作る）
+        */
+        static std::size_t constexpr UNIFORMSIZE = 2048;
+
+        //! A private member variable.
+        /*!
+            正規乱数のブロック
+        */
+        std::array<double, NORMALSIZE> normal_;
+
+        //! A private member variable.
+        /*!
+            正規乱数のブロックで次に取り出す位置
+        */
+        std::size_t normalidx_ = NORMALSIZE;
+
         //! A private member variable.
         /*!
-            生成された乱数
+            sfmt_fill_array64の出力（16バイト境界に置く必要がある）
         */
-        std::optional<double> normal_dist_rand_ = std::nullopt;
-                
+        alignas(16) std::array<std::uint64_t, RAWSIZE> raw_;
+
+        //! A private member variable.
+        /*!
+            raw_で次に取り出す位置
+        */
+        std::size_t rawidx_ = RAWSIZE;
+
         //! A private member variable.
         /*!
             乱数エンジン
         */
         sfmt_t sfmt_;
 
+        //! A private member variable.
+        /*!
+            一様乱数のブロック
+        */
+        std::array<double, UNIFORMSIZE> uniform_;
+
+        //! A private member variable.
+        /*!
+            一様乱数のブロックで次に取り出す位置
+        */
+        std::size_t uniformidx_ = UNIFORMSIZE;
+
+        // #endregion メンバ変数
+
         // #region 禁止されたコンストラクタ・メンバ関数
 
     public:
@@ -112,6 +248,19 @@ namespace myrandom {
         // 乱数エンジン
         sfmt_init_gen_rand(&sfmt_, rnd());
     }
+
+    inline MyRandSfmt::MyRandSfmt(std::uint32_t seed)
+    {
+        // 乱数エンジン
+        sfmt_init_gen_rand(&sfmt_, seed);
+    }
+
+    inline MyRandSfmt::MyRandSfmt(std::uint32_t seed, std::uint64_t stream)
+    {
+        // 乱数エンジン
+        std::array<std::uint32_t, 3> key = { seed, static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32) };
+        sfmt_init_by_array(&sfmt_, key.data(), static_cast<int>(key.size()));
+    }
 }
 
 #endif  // _MYRANDSFMT_H_
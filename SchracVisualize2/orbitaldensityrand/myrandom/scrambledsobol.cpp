@@ -0,0 +1,131 @@
+﻿/*! \file scrambledsobol.cpp
+    \brief Owenのスクランブルをかけた3次元のSobol点列を生成するクラスの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "scrambledsobol.h"
+
+namespace myrandom {
+    // #region コンストラクタ
+
+    ScrambledSobol::ScrambledSobol(std::uint32_t seed)
+    {
+        // 各次元の原始多項式の次数s、係数a、初期値m_1, ..., m_s（Joe-Kuoの表、1次元目はvan der Corput列）
+        struct Primitive {
+            std::int32_t s;
+            std::uint32_t a;
+            std::array<std::uint32_t, 2> m;
+        };
+        std::array<Primitive, DIMENSION> constexpr primitive = { {
+            { 0, 0U, { 0U, 0U } },
+            { 1, 0U, { 1U, 0U } },
+            { 2, 1U, { 1U, 3U } }
+        } };
+
+        for (auto d = 0; d < DIMENSION; d++) {
+            auto & v = direction_[d];
+            auto const & p = primitive[d];
+            if (!p.s) {
+                for (auto k = 0; k < BITS; k++) {
+                    v[k] = 1U << (BITS - 1 - k);
+                }
+                continue;
+            }
+
+            for (auto k = 0; k < p.s; k++) {
+                v[k] = p.m[k] << (BITS - 1 - k);
+            }
+
+            // v_k = a_1 v_{k-1} ^ ... ^ a_{s-1} v_{k-s+1} ^ v_{k-s} ^ (v_{k-s} >> s)
+            for (auto k = p.s; k < BITS; k++) {
+                v[k] = v[k - p.s] ^ (v[k - p.s] >> p.s);
+                for (auto j = 1; j < p.s; j++) {
+                    if ((p.a >> (p.s - 1 - j)) & 1U) {
+                        v[k] ^= v[k - j];
+                    }
+                }
+            }
+        }
+
+        // 次元ごとのシードは、シードをSplitMix64で混ぜて作る
+        auto state = static_cast<std::uint64_t>(seed);
+        for (auto & s : seed_) {
+            state += 0x9E3779B97F4A7C15ULL;
+            auto z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            s = static_cast<std::uint32_t>((z ^ (z >> 31)) >> 32);
+        }
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    void ScrambledSobol::operator()(std::uint32_t index, double * u0, double * u1, double * u2, std::size_t n) const
+    {
+        if (!n) {
+            return;
+        }
+
+        // 最初の点は、indexのGray符号の立っているビットの方向数の排他的論理和
+        std::array<std::uint32_t, DIMENSION> x = {};
+        auto const gray = index ^ (index >> 1);
+        for (auto k = 0; k < BITS; k++) {
+            if ((gray >> k) & 1U) {
+                for (auto d = 0; d < DIMENSION; d++) {
+                    x[d] ^= direction_[d][k];
+                }
+            }
+        }
+
+        // 座標を(0, 1)に収めるため、2^-32の刻みの区間の中点をとる
+        auto constexpr scale = 1.0 / 4294967296.0;
+        std::array<double *, DIMENSION> const u = { u0, u1, u2 };
+        for (std::size_t i = 0; ; i++) {
+            for (auto d = 0; d < DIMENSION; d++) {
+                u[d][i] = (static_cast<double>(Scramble(x[d], seed_[d])) + 0.5) * scale;
+            }
+
+            if (i + 1 == n) {
+                break;
+            }
+
+            // 次の点との違いは、次の番号の最下位の立っているビットの方向数だけ（Antonov-Saleevの方法）
+            auto const next = index + static_cast<std::uint32_t>(i) + 1U;
+            auto k = 0;
+            while (!((next >> k) & 1U)) {
+                k++;
+            }
+
+            for (auto d = 0; d < DIMENSION; d++) {
+                x[d] ^= direction_[d][k];
+            }
+        }
+    }
+
+    std::uint32_t ScrambledSobol::Reverse_bits(std::uint32_t x)
+    {
+        x = ((x >> 1) & 0x55555555U) | ((x & 0x55555555U) << 1);
+        x = ((x >> 2) & 0x33333333U) | ((x & 0x33333333U) << 2);
+        x = ((x >> 4) & 0x0F0F0F0FU) | ((x & 0x0F0F0F0FU) << 4);
+        x = ((x >> 8) & 0x00FF00FFU) | ((x & 0x00FF00FFU) << 8);
+        return (x >> 16) | (x << 16);
+    }
+
+    std::uint32_t ScrambledSobol::Scramble(std::uint32_t x, std::uint32_t seed)
+    {
+        // 逆順にしたビットへの加算と偶数の乗算では、各ビットの結果はそれより下位のビット（元の上位ビット）だけで決まるので、
+        // 元の各桁がそれより上位の桁に応じて置換される、入れ子の置換（Owenのスクランブル）になる
+        x = Reverse_bits(x);
+        x += seed;
+        x ^= x * 0x6C50B47CU;
+        x ^= x * 0xB82F1E52U;
+        x ^= x * 0xC7AFE638U;
+        x ^= x * 0x8D22F6E6U;
+        return Reverse_bits(x);
+    }
+
+    // #endregion メンバ関数
+}
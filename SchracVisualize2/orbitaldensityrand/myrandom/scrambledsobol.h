@@ -0,0 +1,133 @@
+﻿/*! \file scrambledsobol.h
+    \brief Owenのスクランブルをかけた3次元のSobol点列を生成するクラスの宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _SCRAMBLEDSOBOL_H_
+#define _SCRAMBLEDSOBOL_H_
+
+#pragma once
+
+#include <array>    // for std::array
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::int32_t, std::uint32_t
+
+namespace myrandom {
+    //! A class.
+    /*!
+        Owenのスクランブル（Burleyのハッシュによる方法）をかけた3次元のSobol点列を生成するクラス
+        点はGray符号の順に並べ、i番目の点はシードとiだけで決まるので、どこからでも生成し始められる
+    */
+    class ScrambledSobol final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param seed スクランブルのシード（シードが異なれば、互いに独立にスクランブルした点列になる）
+        */
+        explicit ScrambledSobol(std::uint32_t seed);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~ScrambledSobol() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            index番目からn個の点を、(0, 1)の開区間の座標として次元ごとの配列に生成する
+            \param index 最初の点の番号
+            \param u0 1次元目の座標を格納する配列
+            \param u1 2次元目の座標を格納する配列
+            \param u2 3次元目の座標を格納する配列
+            \param n 生成する個数
+        */
+        void operator()(std::uint32_t index, double * u0, double * u1, double * u2, std::size_t n) const;
+
+    private:
+        //!  A private static member function.
+        /*!
+            ビットの並びを逆順にする
+            \param x 32ビットの整数
+            \return ビットを逆順にした整数
+        */
+        static std::uint32_t Reverse_bits(std::uint32_t x);
+
+        //!  A private static member function.
+        /*!
+            Sobol点列の1つの次元の座標（32ビットの固定小数点数）に、Owenのスクランブルをかける
+            ビットを逆順にしてから、下位ビットが上位ビットに依存しない置換（Laine-Karrasのハッシュ）をかけ、元の順に戻す
+            \param x 座標
+            \param seed その次元のスクランブルのシード
+            \return スクランブルをかけた座標
+        */
+        static std::uint32_t Scramble(std::uint32_t x, std::uint32_t seed);
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    public:
+        //! A public static member variable (constant expression).
+        /*!
+            点列の次元
+        */
+        static std::int32_t constexpr DIMENSION = 3;
+
+    private:
+        //! A private static member variable (constant expression).
+        /*!
+            座標のビット数
+        */
+        static std::int32_t constexpr BITS = 32;
+
+        //! A private member variable.
+        /*!
+            次元ごとの方向数（Joe-Kuoの表の最初の3次元）
+        */
+        std::array<std::array<std::uint32_t, BITS>, DIMENSION> direction_;
+
+        //! A private member variable.
+        /*!
+            次元ごとのスクランブルのシード
+        */
+        std::array<std::uint32_t, DIMENSION> seed_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A public constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        ScrambledSobol() = delete;
+
+        //! A public copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        ScrambledSobol(ScrambledSobol const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        ScrambledSobol & operator=(ScrambledSobol const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _SCRAMBLEDSOBOL_H_
@@ -8,26 +8,103 @@
 */
 
 #include "orbitaldensityrand.h"
-#include "utility/utility.h"
+#include "realylm/realylm.h"
+#include "sampler/chainstep.h"
+#include "utility/chunkscheduler.h"
+#include "utility/fnv1a.h"
+#include "utility/safedelete.h"
+#include <algorithm>                                            // for std::max, std::min
+#include <cmath>                                                // for std::fabs, std::hypot, std::pow, std::sqrt
+#include <limits>                                               // for std::numeric_limits
+#include <random>                                               // for std::random_device
+#include <stdexcept>                                            // for std::invalid_argument
+#include <utility>                                              // for std::move
 #include <boost/assert.hpp>                                     // for boost::assert
-#include <boost/math/constants/constants.hpp>                   // for boost::math::constants::pi
 #include <boost/math/special_functions/spherical_harmonic.hpp>  // for boost::math::spherical_harmonic
-#include <boost/range/algorithm.hpp>                            // for boost::fill
 
 namespace orbitaldensityrand {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            PackedVertexの座標の固定小数点数の最大値（DXGI_FORMAT_R16G16B16A16_SNORMの1.0）
+        */
+        static long constexpr PACKEDMAX = 32767;
+
+        //! A global variable (constant expression).
+        /*!
+            動径関数の節を二分法で求めるときの反復回数
+        */
+        static auto constexpr RADIALNODEBISECTIONS = 60;
+
+        //! A global variable (constant expression).
+        /*!
+            電子密度の極小点を節とみなす、最大値に対する比の上限
+        */
+        static auto constexpr RADIALNODETOLERANCE = 1.0E-3;
+    }
+
     // #region コンストラクタ
 
 	OrbitalDensityRand::OrbitalDensityRand(std::shared_ptr<getdata::GetData> const & pgd)
-        :   Complete([this] { return complete_.load(); }, nullptr),
+        :   Acceptance_rate([this] {
+                auto const proposed = proposed_.load();
+                return proposed ? static_cast<double>(accepted_.load()) / static_cast<double>(proposed) : 0.0; }, nullptr),
+            Burnin([this] { return burnin_; }, [this](auto burnin) {
+                if (burnin < 0) {
+                    throw std::invalid_argument("バーンインのステップ数が異常です！");
+                }
+                return burnin_ = burnin; }),
+            Cache([this] { return pcache_; }, [this](auto const & pcache) { return pcache_ = pcache; }),
+            Cache_hit([this] { return cachehit_; }, nullptr),
+            Chains([this] { return chains_; }, [this](auto chains) {
+                if (chains != 1 && chains != 4 && chains != 8 && chains != 16) {
+                    throw std::invalid_argument("チェーン数が異常です！");
+                }
+                return chains_ = chains; }),
+            Chunk_counts([this] { return std::cref(chunkcounts_); }, nullptr),
+            Complete([this] { return complete_.load(); }, nullptr),
             Dt([this] { return dt_; }, [this](auto dt) { return dt_ = dt; }),
             Elapsed_time([this] { return count_ * dt_; }, nullptr),
+            Generation([this] { return generation_; }, nullptr),
+            Pool_budget([this] { return pool_.Budget(); }, [this](auto poolbudget) { return pool_.Budget(poolbudget); }),
+            Pool_bytes([this] { return pool_.Bytes(); }, nullptr),
+            Pool_hit([this] { return poolhit_; }, nullptr),
+            Pool_size([this] { return pool_.Size(); }, nullptr),
+            Proposal_sigma([this] { return sigma_; }, nullptr),
             Pth([this] { return std::cref(pth_); }, nullptr),
+            Packed([this] { return packed_; }, [this](auto packed) { return packed_ = packed; }),
+            Packed_vertex([this] {
+                return pregion_ && packed_ ?
+                    VertexView<PackedVertex>(static_cast<PackedVertex const *>(pregion_->get_address()), vertexsize_) :
+                    VertexView<PackedVertex>(packedvertex_.data(), std::min(packedvertex_.size(), vertexsize_.load())); }, nullptr),
 		    Redraw(nullptr, [this](auto redraw) { return redraw_ = redraw; }),
             Rmax([this] { return rmax_; }, nullptr),
+            Rungs([this] { return rungs_; }, [this](auto rungs) {
+                if (rungs != 4 && rungs != 8 && rungs != 16) {
+                    throw std::invalid_argument("梯子の段数が異常です！");
+                }
+                return rungs_ = rungs; }),
+            Ready_vertexsize([this] { return readysize_.load(std::memory_order_acquire); }, nullptr),
+            Seed([this] { return seed_; }, [this](auto const & seed) { return seed_ = seed; }),
+            Speculative([this] { return speculative_; }, [this](auto speculative) { return speculative_ = speculative; }),
+            Swap_rate([this] {
+                auto const proposed = swapproposed_.load();
+                return proposed ? static_cast<double>(swapaccepted_.load()) / static_cast<double>(proposed) : 0.0; }, nullptr),
             Thread_end(nullptr, [this](auto thread_end) { 
 			    thread_end_.store(thread_end);
 			    return thread_end; }),
-            Vertex([this] { return std::cref(vertex_); }, nullptr),
+            Threads([this] { return threads_; }, [this](auto threads) { return threads_ = std::max(threads, 1); }),
+            Thinning([this] { return thinning_; }, [this](auto thinning) {
+                if (thinning < 1) {
+                    throw std::invalid_argument("間引きの間隔が異常です！");
+                }
+                return thinning_ = thinning; }),
+            Vertex([this] {
+                return pregion_ && !packed_ ?
+                    VertexView<SimpleVertex>(static_cast<SimpleVertex const *>(pregion_->get_address()), vertexsize_) :
+                    VertexView<SimpleVertex>(vertex_.data(), std::min(vertex_.size(), vertexsize_.load())); }, nullptr),
+            Vertex_bytes([this] {
+                return vertex_.capacity() * sizeof(SimpleVertex) + packedvertex_.capacity() * sizeof(PackedVertex) + (pregion_ ? pregion_->get_size() : 0); }, nullptr),
 		    Vertexsize([this]{ return vertexsize_.load(); }, [this](std::vector<SimpleVertex>::size_type size) { 
 				vertexsize_.store(size);
 				return size; }),
@@ -35,6 +112,8 @@ namespace orbitaldensityrand {
             q0_({ 1.0, 1.0, 0.0 }),
             q_(q0_),
 		    rmax_(GetRmax(pgd)),
+            threads_(std::max(static_cast<std::int32_t>(std::thread::hardware_concurrency()), 1)),
+            tuner_(pgd),
 		    vertex_(pgd_->Rho_wf_type == getdata::GetData::Rho_Wf_type::RHO ? RHO_VERTEXSIZE_INIT_VALUE : WF_VERTEXSIZE_INIT_VALUE),
             vertexsize_(pgd_->Rho_wf_type == getdata::GetData::Rho_Wf_type::RHO ? RHO_VERTEXSIZE_INIT_VALUE : WF_VERTEXSIZE_INIT_VALUE)
     {
@@ -42,16 +121,246 @@ namespace orbitaldensityrand {
 
     // #endregion コンストラクタ
 
+    // #region publicメンバ関数
+
+    diagnostics::ChainDiagnostics OrbitalDensityRand::Diagnose(Normal_Nelson_type nornel) const
+    {
+        auto const size = static_cast<std::size_t>(readysize_.load(std::memory_order_acquire));
+        auto const packedview = Packed_vertex();
+        auto const view = Vertex();
+        auto const radius = [&](std::size_t i) {
+            auto const v = packed_ ? Unpack_vertex(packedview[i], rmax_) : view[i];
+            return std::sqrt(static_cast<double>(v.Pos.x) * v.Pos.x + static_cast<double>(v.Pos.y) * v.Pos.y + static_cast<double>(v.Pos.z) * v.Pos.z);
+        };
+
+        // 末尾の途中までのチャンクは、チャンクが1つしかない場合だけ使う
+        auto const chunksize = static_cast<std::size_t>(CHUNKSIZE);
+        auto const chunks = std::max(size / chunksize, static_cast<std::size_t>(1));
+        auto const chunklength = std::min(size, chunksize);
+
+        std::vector<double> samples;
+        std::size_t chains;
+        switch (nornel)
+        {
+        case Normal_Nelson_type::NORMAL:
+        case Normal_Nelson_type::MALA:
+        {
+            // チャンク内では、K本のチェーンの点がチェーンの順に交互に並んでいる
+            auto const k = static_cast<std::size_t>(chains_);
+            auto const length = chunklength / k;
+            chains = chunks * k;
+            samples.reserve(chains * length);
+            for (std::size_t c = 0; c < chunks; c++) {
+                for (std::size_t j = 0; j < k; j++) {
+                    for (std::size_t t = 0; t < length; t++) {
+                        samples.push_back(radius(c * chunksize + j + k * t));
+                    }
+                }
+            }
+            break;
+        }
+
+        case Normal_Nelson_type::DIRECT:
+        case Normal_Nelson_type::QUASI:
+        case Normal_Nelson_type::TEMPERING:
+            // 交換モンテカルロ法ではチャンクごとに1本のβ = 1のチェーンの点が順に並んでいる
+            chains = chunks;
+            samples.reserve(chains * chunklength);
+            for (std::size_t c = 0; c < chunks; c++) {
+                for (std::size_t t = 0; t < chunklength; t++) {
+                    samples.push_back(radius(c * chunksize + t));
+                }
+            }
+            break;
+
+        case Normal_Nelson_type::NELSON:
+            chains = DIAGNOSESEGMENTS;
+            samples.reserve(size);
+            for (std::size_t i = 0; i < size; i++) {
+                samples.push_back(radius(i));
+            }
+            break;
+
+        default:
+            throw std::invalid_argument("nornelが異常です！");
+        }
+
+        return diagnostics::Diagnose(samples, chains);
+    }
+
+    diagnostics::LobeBalance OrbitalDensityRand::Lobe_balance(std::int32_t m) const
+    {
+        auto const size = static_cast<std::size_t>(readysize_.load(std::memory_order_acquire));
+        auto const packedview = Packed_vertex();
+        auto const view = Vertex();
+        diagnostics::LobePartition const partition(static_cast<std::int32_t>(pgd_->L), m, Radial_nodes());
+
+        std::vector<std::uint32_t> label(size);
+        for (std::size_t i = 0; i < size; i++) {
+            auto const v = packed_ ? Unpack_vertex(packedview[i], rmax_) : view[i];
+            label[i] = partition(v.Pos.x, v.Pos.y, v.Pos.z);
+        }
+
+        // 窓が1つもなければ偏りは測れない
+        if (size < static_cast<std::size_t>(CHUNKSIZE)) {
+            diagnostics::LobeBalance result;
+            result.lobes = partition.size();
+            return result;
+        }
+
+        // 1つのチャンクは1つのスレッドが1本の（K本の）連鎖で生成するので、チャンクを窓にする
+        return diagnostics::Balance(label, partition.size(), static_cast<std::size_t>(CHUNKSIZE));
+    }
+
+    // #endregion publicメンバ関数
+
     // #region privateメンバ関数
 
     void OrbitalDensityRand::operator()(std::int32_t m, Normal_Nelson_type nornel)
     {
         if (redraw_) {
-            if (vertex_.size() != vertexsize_) {
-                vertex_.resize(vertexsize_);
+            // 先読みを含む前回の生成を止めてから始める
+            pth_.reset();
+            thread_end_.store(false);
+
+            // 頂点数だけが変わった場合は、同じ乱数列の点群の先頭部分が生成済みなので、それを残して使う
+            auto const size = vertexsize_.load();
+            auto const streamkey = Stream_key(nornel);
+            auto resize = nornel != Normal_Nelson_type::NELSON && currentm_ == m && streamkey == streamkey_ && size != currentsize_ && generated_;
+
+            // m以外の設定が変わっていればプールの点群は使えないので捨て、同じなら表示中の完成した点群をプールに戻す
+            auto const family = Family_key(nornel);
+            poolhit_ = false;
+            if (family != family_) {
+                pool_.Clear();
+            }
+            else if (completem_ && *completem_ != m) {
+                cloudpool::PoolEntry entry;
+                entry.packedvertex = std::move(packedvertex_);
+                entry.pregion = std::move(pregion_);
+                entry.seed = seedused_;
+                entry.vertex = std::move(vertex_);
+                pool_.Insert(*completem_, std::move(entry));
+            }
+
+            if (auto entry = pool_.Take(m)) {
+                packedvertex_ = std::move(entry->packedvertex);
+                pregion_ = std::move(entry->pregion);
+                seedused_ = entry->seed;
+                vertex_ = std::move(entry->vertex);
+                poolhit_ = true;
+            }
+
+            family_ = family;
+            completem_.reset();
+            if (!poolhit_ && !resize) {
+                pregion_.reset();
+            }
+
+            // シードが指定されていれば、同じ点群がキャッシュにないか探す（見つかればコピーせずにマップした領域をそのまま使う）
+            auto const pcache = seed_ ? pcache_ : nullptr;
+            auto const key = pcache ? Cache_key(m, family) : 0;
+            cachehit_ = false;
+            if (pcache && !poolhit_) {
+                if (auto pregion = pcache->Find(key, Cache_bytes())) {
+                    pregion_ = std::move(pregion);
+                    seedused_ = *seed_;
+                    cachehit_ = true;
+                    resize = false;
+                }
+            }
+
+            if (!resize) {
+                // 縮める前に公開済みの頂点数を0に戻しておく
+                readysize_.store(0, std::memory_order_release);
+                generation_++;
             }
+            else if (pregion_ && size > generated_) {
+                // マップした領域は伸ばせないので、生成済みの頂点を配列に写してから伸ばす
+                auto const src = pregion_->get_address();
+                if (packed_) {
+                    packedvertex_.assign(static_cast<PackedVertex const *>(src), static_cast<PackedVertex const *>(src) + generated_);
+                }
+                else {
+                    vertex_.assign(static_cast<SimpleVertex const *>(src), static_cast<SimpleVertex const *>(src) + generated_);
+                }
+                pregion_.reset();
+            }
+
+            // 使わない方の形式の頂点は解放する（マップした領域を使うならどちらも使わない）
+            // 頂点数を減らしただけなら、配列は縮めずに残しておく
+            if (pregion_) {
+                std::vector<SimpleVertex>().swap(vertex_);
+                std::vector<PackedVertex>().swap(packedvertex_);
+            }
+            else if (packed_) {
+                std::vector<SimpleVertex>().swap(vertex_);
+                if (packedvertex_.size() < size || (!resize && packedvertex_.size() != size)) {
+                    packedvertex_.resize(size);
+                }
+            }
+            else {
+                std::vector<PackedVertex>().swap(packedvertex_);
+                if (vertex_.size() < size || (!resize && vertex_.size() != size)) {
+                    vertex_.resize(size);
+                }
+            }
+
+            auto const hit = poolhit_ || cachehit_;
+            if (hit) {
+                generated_ = size;
+            }
+
+            // 生成済みの頂点で足りれば、生成はしない
+            auto const ready = hit || (resize && size <= generated_);
+            if (hit) {
+                // 採択率は生成した点群についてしか分からない
+                accepted_.store(0);
+                proposed_.store(0);
+                swapaccepted_.store(0);
+                swapproposed_.store(0);
+            }
+
+            if (ready) {
+                sigma_ = Markov_chain(nornel) ? Tuned_step(m, nornel) : 0.0;
+                chunkcounts_.clear();
+                count_ = nornel == Normal_Nelson_type::NELSON ? static_cast<std::uint32_t>(size) : 0U;
+                completem_ = m;
+                readysize_.store(size, std::memory_order_release);
+                complete_.store(true);
+            }
+
+            // 頂点数を増やした場合は、生成済みの頂点が途中までしかないチャンクから生成し直す
+            auto const firstchunk = resize ? static_cast<std::int32_t>(generated_ / CHUNKSIZE) : 0;
+            if (resize && !ready) {
+                readysize_.store(static_cast<std::vector<SimpleVertex>::size_type>(firstchunk) * CHUNKSIZE, std::memory_order_release);
+            }
+
+            currentm_ = m;
+            currentsize_ = size;
+            streamkey_ = streamkey;
+
+            // 点群が見つかった場合も、Pthを待つ側と先読みのためにスレッドを作る
+            pth_.reset(new std::thread([this, m, nornel, family, pcache, key, ready, resize, firstchunk, speculative = speculative_] {
+                if (!ready) {
+                    resize ? ExtendSimpleVertex(m, nornel, firstchunk) : ClearFillSimpleVertex(m, nornel);
+
+                    // 途中で止めた点群は保存しない
+                    if (thread_end_) {
+                        return;
+                    }
+
+                    if (pcache) {
+                        pcache->Store(key, packed_ ? static_cast<void const *>(packedvertex_.data()) : static_cast<void const *>(vertex_.data()), Cache_bytes());
+                    }
 
-            pth_.reset(new std::thread([this, m, nornel] { ClearFillSimpleVertex(m, nornel); }), [this](std::thread * pth)
+                    completem_ = m;
+                }
+
+                if (speculative && nornel != Normal_Nelson_type::NELSON) {
+                    Speculate(m, nornel, family, pcache);
+                }
+            }), [this](std::thread * pth)
             {
                 if (pth->joinable()) {
                     thread_end_.store(true);
@@ -65,36 +374,59 @@ namespace orbitaldensityrand {
         }
     }
 
+    template <typename T>
+    std::shared_ptr<T const> OrbitalDensityRand::Angular_table(std::map<std::int32_t, std::shared_ptr<T const>> & tables, std::int32_t m)
+    {
+        // 先読みのスレッドからも呼ばれるので、ロックして作る
+        std::lock_guard<std::mutex> lock(directmtx_);
+        auto & ptable = tables[m];
+        if (!ptable) {
+            ptable = std::make_shared<T const>(
+                static_cast<std::int32_t>(pgd_->L), m, pgd_->Rho_wf_type == getdata::GetData::Rho_Wf_type::RHO);
+        }
+
+        return ptable;
+    }
+
 	void OrbitalDensityRand::ClearFillSimpleVertex(std::int32_t m, Normal_Nelson_type nornel)
 	{
 		complete_.store(false);
 
-		SimpleVertex sv{};
-		sv.Color = { 0.0f, 0.0f, 0.0f, 0.0f };
-		sv.Pos = { 0.0f, 0.0f, 0.0f };
-		boost::fill(vertex_, sv);
+        // 頂点は公開済みの範囲しか描画されないので、事前にクリアする必要はない
+        readysize_.store(0, std::memory_order_release);
+
+        // シードが指定されていなければランダムデバイスで初期化する
+        auto const seed = seed_ ? *seed_ : std::random_device()();
+        seedused_ = seed;
+
+        packedvertexout_ = packedvertex_.data();
+        vertexout_ = vertex_.data();
+
+        accepted_.store(0);
+        proposed_.store(0);
+        swapaccepted_.store(0);
+        swapproposed_.store(0);
+        sigma_ = Markov_chain(nornel) ? Tuned_step(m, nornel) : 0.0;
 
         switch (nornel)
         {
         case Normal_Nelson_type::NORMAL:
-            {
-                auto const threads = static_cast<std::int32_t>(std::thread::hardware_concurrency());
-                auto const num = static_cast<std::int32_t>(vertexsize_.load() / threads);
+        case Normal_Nelson_type::DIRECT:
+        case Normal_Nelson_type::QUASI:
+        case Normal_Nelson_type::TEMPERING:
+        case Normal_Nelson_type::MALA:
+            FillSimpleVertexChunks(m, nornel, 0, static_cast<std::int32_t>(vertexsize_.load()), seed, threads_, true);
 
-                auto thvec = std::vector<std::thread>(threads);
-                for (auto i = 0; i < threads - 1; i++) {
-                    thvec[i] = std::thread([i, m, num, this]() { FillSimpleVertex(m, num * i, num * (i + 1)); });
-                }
-                thvec[threads - 1] = std::thread([m, num, threads, this]() { FillSimpleVertex(m, num * (threads - 1), static_cast<std::int32_t>(vertexsize_.load())); });
-
-                for (auto && th : thvec) {
-                    th.join();
-                }
-            }
+            // 途中で止めた場合も、公開済みの範囲は頂点数を増やすときに使える
+            generated_ = readysize_.load(std::memory_order_acquire);
             break;
 
         case Normal_Nelson_type::NELSON:
-            FillSimpleVertex(m);
+            chunkcounts_.clear();
+            FillSimpleVertex(m, seed);
+
+            // 軌跡は途中から伸ばせないので、頂点数を変えたら生成し直す
+            generated_ = 0;
             break;
 
         default:
@@ -105,10 +437,67 @@ namespace orbitaldensityrand {
 		complete_.store(true);
 	}
 
-    void OrbitalDensityRand::FillSimpleVertex(std::int32_t m)
+    std::size_t OrbitalDensityRand::Cache_bytes() const
+    {
+        return vertexsize_.load() * (packed_ ? sizeof(PackedVertex) : sizeof(SimpleVertex));
+    }
+
+    std::uint64_t OrbitalDensityRand::Cache_key(std::int32_t m, std::uint64_t family) const
+    {
+        return utility::Fnv1a(m, family);
+    }
+
+    void OrbitalDensityRand::ExtendSimpleVertex(std::int32_t m, Normal_Nelson_type nornel, std::int32_t firstchunk)
+    {
+        complete_.store(false);
+
+        packedvertexout_ = packedvertex_.data();
+        vertexout_ = vertex_.data();
+
+        // チャンクの乱数列は頂点数によらないので、前回と同じシードで残りのチャンクだけを生成すれば、最初から生成したものと一致する
+        FillSimpleVertexChunks(m, nornel, firstchunk, static_cast<std::int32_t>(vertexsize_.load()), seedused_, threads_, true);
+        generated_ = readysize_.load(std::memory_order_acquire);
+
+        complete_.store(true);
+    }
+
+    std::uint64_t OrbitalDensityRand::Family_key(Normal_Nelson_type nornel) const
+    {
+        return utility::Fnv1a(static_cast<std::uint64_t>(vertexsize_.load()), Stream_key(nornel));
+    }
+
+    std::uint64_t OrbitalDensityRand::Stream_key(Normal_Nelson_type nornel) const
+    {
+        // スレッド数は点群に影響しないのでキーに含めない
+        auto hash = utility::Fnv1a(pgd_->Hash());
+        hash = utility::Fnv1a(CACHE_VERSION, hash);
+        hash = utility::Fnv1a(static_cast<std::int32_t>(nornel), hash);
+        hash = utility::Fnv1a(seed_.has_value(), hash);
+        hash = utility::Fnv1a(seed_.value_or(0U), hash);
+        hash = utility::Fnv1a(nornel == Normal_Nelson_type::NELSON ? dt_ : 0.0, hash);
+        auto const chains = nornel == Normal_Nelson_type::NORMAL || nornel == Normal_Nelson_type::MALA;
+        hash = utility::Fnv1a(chains ? chains_ : 0, hash);
+        hash = utility::Fnv1a(Markov_chain(nornel) ? burnin_ : 0, hash);
+        hash = utility::Fnv1a(Markov_chain(nornel) ? thinning_ : 0, hash);
+        hash = utility::Fnv1a(nornel == Normal_Nelson_type::TEMPERING ? rungs_ : 0, hash);
+        hash = utility::Fnv1a(packed_, hash);
+
+        return hash;
+    }
+
+    void OrbitalDensityRand::FillSimpleVertex(std::int32_t m, std::uint32_t seed)
     {
         auto const actual_dt = dt_ * ATTOSECTOAU;
 
+        myrandom::MyRandSfmt mr(seed);
+        realylm::RealYlm const ylm(static_cast<std::int32_t>(pgd_->L), m);
+        auto const acc = getdata::GetData::Make_accel();
+
+        // シードが指定されていれば同じ軌跡を再現できるよう初期座標から始める
+        if (seed_) {
+            Resetq();
+        }
+
         count_ = 0U;
         do {
             if (thread_end_) {
@@ -122,229 +511,506 @@ namespace orbitaldensityrand {
                 continue;
             }
 
-            auto phi = 0.0;
-            if (std::fabs(q_[1]) < THRESHOLD) {
-                if (q_[0] < 0.0) {
-                    phi = boost::math::constants::pi<double>();
-                }
-            }
-            else if (q_[0] * q_[0] + q_[1] * q_[1] > 0.0) {
-                auto const sign = q_[1] > 0 ? 1 : -1;
-                phi = sign * std::acos(q_[0] / std::sqrt(q_[0] * q_[0] + q_[1] * q_[1]));
-            }
-            auto const theta = std::acos(q_[2] / r);
+            // 動径方向の単位ベクトル
+            auto const ux = q_[0] / r;
+            auto const uy = q_[1] / r;
+            auto const uz = q_[2] / r;
 
-            auto const ylm = Spherical_harmonic(pgd_->L, m, theta, phi);
-            auto const dylmdtheta = Numerical_diff(
-                theta,
-                myfunctional::make_functional([this, m, phi](double th) { return Spherical_harmonic(pgd_->L, m, th, phi); }));
+            std::array<double, 3> grad;
+            auto const ylmval = ylm.Gradient(ux, uy, uz, grad);
+            auto const rval = (*pgd_)(r, acc.get());
 
-            if (std::fabs(ylm) < THRESHOLD && std::fabs(dylmdtheta) < THRESHOLD) {
-                Resetq();
-                continue;
-            }
+            // ドリフトは∇ψ/ψで、ψが0になる節の上では定義できないので、拡散だけで節から離れる
+            // （初期座標が節の上にあるときに、初期値に戻すと同じ節に戻り続けてしまう）
+            auto const f = std::fabs(rval * ylmval) < sampler::THRESHOLD ?
+                std::array<double, 3>{} :
+                sampler::Drift(r, ux, uy, uz, pgd_->dphidr(r, acc.get()) / rval, ylmval, grad, 1.0);
 
-            auto const dylmdphi = Numerical_diff(
-                phi,
-                myfunctional::make_functional([this, m, theta](double ph) { return Spherical_harmonic(pgd_->L, m, theta, ph); }));
+            q_[0] += f[0] * actual_dt + mr.normal_distribution_rand() * std::sqrt(actual_dt);
+            q_[1] += f[1] * actual_dt + mr.normal_distribution_rand() * std::sqrt(actual_dt);
+            q_[2] += f[2] * actual_dt + mr.normal_distribution_rand() * std::sqrt(actual_dt);
 
-            if (std::fabs(ylm) < THRESHOLD && std::fabs(dylmdphi) < THRESHOLD) {
-                Resetq();
-                continue;
+            Put_vertex(count_, q_[0], q_[1], q_[2], 1.0f);
+
+            count_++;
+
+            // 線分の端点が揃った偶数個の単位で公開する
+            if (!(count_ % PUBLISHINTERVAL)) {
+                readysize_.store(count_, std::memory_order_release);
             }
+        } while (count_ < vertexsize_.load());
 
-            auto f_x = std::sin(theta) * std::cos(phi) * pgd_->dphidr(r) / (*pgd_)(r);
-            f_x += std::cos(theta) * std::cos(phi) / r * dylmdtheta / ylm;
-            f_x -= std::sin(phi) / (r * std::sin(theta)) * dylmdphi / ylm;
+        readysize_.store(count_, std::memory_order_release);
+    }
 
-            auto f_y = std::sin(theta) * std::sin(phi) * pgd_->dphidr(r) / (*pgd_)(r);
-            f_y += std::cos(theta) * std::sin(phi) / r * dylmdtheta / ylm;
-            f_y += std::cos(phi) / (r * std::sin(theta)) * dylmdphi / ylm;
+	sampler::AcceptanceCount OrbitalDensityRand::FillSimpleVertex(std::int32_t m, Normal_Nelson_type nornel, std::int32_t starti, std::int32_t endi, std::uint32_t seed, std::uint64_t stream)
+	{
+        auto const wf = pgd_->Rho_wf_type == getdata::GetData::Rho_Wf_type::WF;
 
-            auto f_z = std::cos(theta) * pgd_->dphidr(r) / (*pgd_)(r);
-            f_z -= std::sin(theta) / r * dylmdtheta / ylm;
+        if (nornel == Normal_Nelson_type::DIRECT) {
+            wf ? FillSimpleVertexDirect<true>(m, starti, endi, seed, stream) : FillSimpleVertexDirect<false>(m, starti, endi, seed, stream);
+            return sampler::AcceptanceCount();
+        }
 
-            q_[0] += f_x * actual_dt + mr_.normal_distribution_rand() * std::sqrt(actual_dt);
-            q_[1] += f_y * actual_dt + mr_.normal_distribution_rand() * std::sqrt(actual_dt);
-            q_[2] += f_z * actual_dt + mr_.normal_distribution_rand() * std::sqrt(actual_dt);
+        if (nornel == Normal_Nelson_type::QUASI) {
+            wf ? FillSimpleVertexQuasi<true>(m, starti, endi, seed) : FillSimpleVertexQuasi<false>(m, starti, endi, seed);
+            return sampler::AcceptanceCount();
+        }
 
-            vertex_[count_].Pos.x = static_cast<float>(q_[0]);
-            vertex_[count_].Pos.y = static_cast<float>(q_[1]);
-            vertex_[count_].Pos.z = static_cast<float>(q_[2]);
+        if (nornel == Normal_Nelson_type::MALA) {
+            switch (chains_) {
+            case 1:
+                return wf ? FillSimpleVertexGradient<1, true>(m, starti, endi, seed, stream) : FillSimpleVertexGradient<1, false>(m, starti, endi, seed, stream);
 
-            vertex_[count_].Color.x = 0.8f;
-            vertex_[count_].Color.y = 0.0f;
-            vertex_[count_].Color.z = 0.8f;
-            vertex_[count_].Color.w = 1.0f;
+            case 4:
+                return wf ? FillSimpleVertexGradient<4, true>(m, starti, endi, seed, stream) : FillSimpleVertexGradient<4, false>(m, starti, endi, seed, stream);
 
-            count_++;
-        } while (count_ < vertexsize_.load());
-    }
+            case 8:
+                return wf ? FillSimpleVertexGradient<8, true>(m, starti, endi, seed, stream) : FillSimpleVertexGradient<8, false>(m, starti, endi, seed, stream);
 
-	void OrbitalDensityRand::FillSimpleVertex(std::int32_t m, std::int32_t starti, std::int32_t endi)
-	{
-		if (thread_end_) {
-			return;
-		}
+            case 16:
+                return wf ? FillSimpleVertexGradient<16, true>(m, starti, endi, seed, stream) : FillSimpleVertexGradient<16, false>(m, starti, endi, seed, stream);
 
-		auto sign = 1;
-		auto x = 0.0;
-        auto y = 0.0;
-        auto z = 0.0;
+            default:
+                BOOST_ASSERT(!"chains_が異常!");
+                return sampler::AcceptanceCount();
+            }
+        }
 
-        myrandom::MyRandSfmt mr;
-                
-        auto nextflag = false;
-        auto count_ = 0;
+        if (nornel == Normal_Nelson_type::TEMPERING) {
+            switch (rungs_) {
+            case 4:
+                return wf ? FillSimpleVertexTempering<4, true>(m, starti, endi, seed, stream) : FillSimpleVertexTempering<4, false>(m, starti, endi, seed, stream);
 
-        do {
-            if (thread_end_) {
-                return;
+            case 8:
+                return wf ? FillSimpleVertexTempering<8, true>(m, starti, endi, seed, stream) : FillSimpleVertexTempering<8, false>(m, starti, endi, seed, stream);
+
+            case 16:
+                return wf ? FillSimpleVertexTempering<16, true>(m, starti, endi, seed, stream) : FillSimpleVertexTempering<16, false>(m, starti, endi, seed, stream);
+
+            default:
+                BOOST_ASSERT(!"rungs_が異常!");
+                return sampler::AcceptanceCount();
             }
+        }
 
-            switch (pgd_->Rho_wf_type) {
-            case getdata::GetData::Rho_Wf_type::RHO:
-            {
-                auto rho = [this, m, nextflag](auto x, auto y, auto z) mutable
-                {
-                    auto const r = std::sqrt(x * x + y * y + z * z);
-                    if (r < pgd_->R_meshmin()) {
-                        nextflag = true;
-                        return 0.0;
+        switch (chains_) {
+        case 1:
+            return wf ? FillSimpleVertexChains<1, true>(m, starti, endi, seed, stream) : FillSimpleVertexChains<1, false>(m, starti, endi, seed, stream);
+
+        case 4:
+            return wf ? FillSimpleVertexChains<4, true>(m, starti, endi, seed, stream) : FillSimpleVertexChains<4, false>(m, starti, endi, seed, stream);
+
+        case 8:
+            return wf ? FillSimpleVertexChains<8, true>(m, starti, endi, seed, stream) : FillSimpleVertexChains<8, false>(m, starti, endi, seed, stream);
+
+        case 16:
+            return wf ? FillSimpleVertexChains<16, true>(m, starti, endi, seed, stream) : FillSimpleVertexChains<16, false>(m, starti, endi, seed, stream);
+
+        default:
+            BOOST_ASSERT(!"chains_が異常!");
+            return sampler::AcceptanceCount();
+        }
+	}
+
+    void OrbitalDensityRand::FillSimpleVertexChunks(std::int32_t m, Normal_Nelson_type nornel, std::int32_t firstchunk, std::int32_t size, std::uint32_t seed, std::int32_t threads, bool publish)
+    {
+        // 出力をCHUNKSIZEごとのチャンクに分け、チャンクごとに独立な乱数列を使う
+        // こうするとスレッド数やチャンクを処理したスレッドによらず、同じシードからは同じ点群が得られる
+        // また、頂点数が少ない点群は多い点群の先頭部分になる（最後のチャンクも、同じチャンクを途中まで生成したものになる）
+        auto const chunks = (size + CHUNKSIZE - 1) / CHUNKSIZE;
+
+        if (publish) {
+            readychunks_ = std::make_unique<std::atomic<std::uint64_t>[]>((chunks + 63) / 64);
+            readyprefix_.store(firstchunk);
+        }
+
+        // 波動関数の場合は棄却の頻度で1チャンクあたりの仕事量がばらつくので、空いたスレッドが残りのチャンクを盗む
+        utility::ChunkScheduler scheduler(chunks - firstchunk, threads);
+        std::vector<std::int32_t> counts(threads, 0);
+
+        auto thvec = std::vector<std::thread>(threads);
+        for (auto i = 0; i < threads; i++) {
+            thvec[i] = std::thread([i, m, nornel, firstchunk, size, chunks, seed, publish, &counts, &scheduler, this]() {
+                auto count = 0;
+                sampler::AcceptanceCount acceptance;
+                while (auto const next = scheduler.Next(i)) {
+                    if (thread_end_) {
+                        break;
                     }
 
-                    double phi = 0.0;
-                    if (std::fabs(y) < EPS) {
-                        if (x < 0.0) {
-                            phi = boost::math::constants::pi<double>();
-                        }
+                    auto const c = firstchunk + *next;
+                    auto const chunkacceptance = FillSimpleVertex(m, nornel, c * CHUNKSIZE, std::min((c + 1) * CHUNKSIZE, size), seed, static_cast<std::uint64_t>(c));
+                    acceptance.accepted += chunkacceptance.accepted;
+                    acceptance.proposed += chunkacceptance.proposed;
+                    acceptance.swapaccepted += chunkacceptance.swapaccepted;
+                    acceptance.swapproposed += chunkacceptance.swapproposed;
+                    if (thread_end_) {
+                        break;
                     }
-                    else if (x * x + y * y > 0.0) {
-                        auto const sign = y > 0 ? 1 : -1;
-                        phi = sign * std::acos(x / std::sqrt(x * x + y * y));
+
+                    if (publish) {
+                        PublishChunk(c, chunks, size);
                     }
+                    count++;
+                }
+
+                counts[i] = count;
+
+                // 先読みの点群の採択率は、表示中の点群の採択率に含めない
+                if (publish) {
+                    accepted_.fetch_add(acceptance.accepted);
+                    proposed_.fetch_add(acceptance.proposed);
+                    swapaccepted_.fetch_add(acceptance.swapaccepted);
+                    swapproposed_.fetch_add(acceptance.swapproposed);
+                }
+            });
+        }
+
+        for (auto && th : thvec) {
+            th.join();
+        }
+
+        if (publish) {
+            chunkcounts_ = std::move(counts);
+        }
+    }
+
+    template <std::size_t K, bool WF>
+    sampler::AcceptanceCount OrbitalDensityRand::FillSimpleVertexChains(std::int32_t m, std::int32_t starti, std::int32_t endi, std::uint32_t seed, std::uint64_t stream)
+    {
+        myrandom::MyRandSfmt mr(seed, stream);
+        realylm::RealYlm const ylm(static_cast<std::int32_t>(pgd_->L), m);
+        auto const & table = pgd_->Radial_table();
+        std::array<double, K> sigma, beta;
+        sigma.fill(tuner_.Sigma(m));
+        beta.fill(1.0);
+
+        sampler::ChainState<K> state;
+        auto const n = endi - starti;
+        auto count = 0;
 
-                    auto const ylm = Spherical_harmonic(pgd_->L, m, std::acos(z / r), phi);
+        // 原点から始めたチェーンが目標の分布に近づくまでは詰めない
+        for (auto step = 0; step < burnin_; step++) {
+            if (thread_end_) {
+                return state.count;
+            }
 
-                    return (*pgd_)(r) * ylm * ylm;
-                };
+            sampler::Metropolis_step<K, WF>(state, mr, ylm, table, sigma, beta);
+        }
 
-                auto const maxr = pgd_->R2rhomaxr();
+        while (count < n) {
+            if (thread_end_) {
+                return state.count;
+            }
 
-                auto const x_star = mr.normal_distribution_rand(x, maxr);
-                auto const y_star = mr.normal_distribution_rand(y, maxr);
-                auto const z_star = mr.normal_distribution_rand(z, maxr);
+            // 連続するステップの点は強く相関しているので、thinning_ステップごとに詰める
+            for (auto step = 0; step < thinning_; step++) {
+                sampler::Metropolis_step<K, WF>(state, mr, ylm, table, sigma, beta);
+            }
 
-                auto const rho_t = rho(x, y, z);    // xの電子密度
-                if (nextflag) {
-                    x = x_star;
-                    y = y_star;
-                    z = z_star;
-                    nextflag = false;
+            // 有効な点にいるチェーンの現在の点を詰める（棄却された場合は同じ点をもう一度詰めることで、目標の分布に従う）
+            for (auto k = 0U; k < K && count < n; k++) {
+                if (state.val[k] == 0.0) {
                     continue;
                 }
 
-                auto const rho_star = rho(x_star, y_star, z_star);  // x* の電子密度
+                Put_vertex(starti + count, state.x[k], state.y[k], state.z[k], state.sign[k]);
+                count++;
+            }
+        }
 
-                // 採択率を計算  α = p(x*) / p(x_t)
-                auto const alpha = (rho_star * rho_star) / (rho_t * rho_t);
+        return state.count;
+    }
 
-                // 採択率により決定
-                auto const ar = mr.myrand();    // 0 <= ar <= 1 の一様乱数 ar を生成
-                if (ar <= alpha) {              // 採択
-                    x = x_star;
-                    y = y_star;
-                    z = z_star;
-                    if (rho_star >= 0.0) {
-                        sign = 1;
-                    }
-                    else {
-                        sign = -1;
-                    }
-                }
+    template <bool WF>
+    void OrbitalDensityRand::FillSimpleVertexDirect(std::int32_t m, std::int32_t starti, std::int32_t endi, std::uint32_t seed, std::uint64_t stream)
+    {
+        myrandom::MyRandSfmt mr(seed, stream);
+        auto const & table = pgd_->Radial_table();
+        auto const & cdf = Radial_cdf();
+        auto const pangular = Angular_table(angularsamplers_, m);
+
+        std::array<double, DIRECTBLOCK> u, r, radial, ux, uy, uz, angular;
+
+        // 最後のブロックも丸ごと生成して必要な分だけ詰めるので、チャンクの先頭部分は頂点数によらず同じになる
+        for (auto i = starti; i < endi; i += DIRECTBLOCK) {
+            if (thread_end_) {
+                return;
             }
-            break;
 
-            case getdata::GetData::Rho_Wf_type::WF:
-            {
-                auto phi = [this, m, nextflag](auto x, auto y, auto z) mutable
-                {
-                    auto const r = std::sqrt(x * x + y * y + z * z);
-                    if (r < pgd_->R_meshmin()) {
-                        nextflag = true;
-                        return 0.0;
-                    }
+            mr.myrand(u.data(), DIRECTBLOCK);
+            cdf(u.data(), r.data(), DIRECTBLOCK);
+            table(r.data(), radial.data(), DIRECTBLOCK);
+            (*pangular)(mr, ux.data(), uy.data(), uz.data(), angular.data(), DIRECTBLOCK);
 
-                    double phi = 0.0;
-                    if (std::fabs(y) < EPS) {
-                        if (x < 0.0) {
-                            phi = boost::math::constants::pi<double>();
-                        }
-                    }
-                    else if (x * x + y * y > 0.0) {
-                        auto const sign = y > 0 ? 1 : -1;
-                        phi = sign * std::acos(x / std::sqrt(x * x + y * y));
-                    }
+            auto const n = std::min(DIRECTBLOCK, endi - i);
+            for (auto k = 0; k < n; k++) {
+                // 符号はメトロポリス・ヘイスティングス法と同じく、波動関数（電子密度）の値の符号
+                auto const v = WF ? radial[k] * angular[k] : radial[k];
+                Put_vertex(i + k, r[k] * ux[k], r[k] * uy[k], r[k] * uz[k], v >= 0.0 ? 1.0f : -1.0f);
+            }
+        }
+    }
+
+    template <std::size_t K, bool WF>
+    sampler::AcceptanceCount OrbitalDensityRand::FillSimpleVertexGradient(std::int32_t m, std::int32_t starti, std::int32_t endi, std::uint32_t seed, std::uint64_t stream)
+    {
+        myrandom::MyRandSfmt mr(seed, stream);
+        realylm::RealYlm const ylm(static_cast<std::int32_t>(pgd_->L), m);
+        auto const & table = pgd_->Radial_table();
+        auto const step = Tuned_step(m, Normal_Nelson_type::MALA);
+
+        sampler::ChainState<K> state;
+        std::array<double, 3 * K> grad{};
+        auto const advance = [&] {
+            sampler::Langevin_step<K, WF>(state, grad, mr, ylm, table, step);
+        };
+
+        auto const n = endi - starti;
+        auto count = 0;
+
+        for (auto i = 0; i < burnin_; i++) {
+            if (thread_end_) {
+                return state.count;
+            }
 
-                    return (*pgd_)(r) * Spherical_harmonic(pgd_->L, m, std::acos(z / r), phi);
-                };
+            advance();
+        }
 
-                auto const maxr = pgd_->R2rhomaxr();
+        while (count < n) {
+            if (thread_end_) {
+                return state.count;
+            }
 
-                auto const x_star = mr.normal_distribution_rand(x, maxr);
-                auto const y_star = mr.normal_distribution_rand(y, maxr);
-                auto const z_star = mr.normal_distribution_rand(z, maxr);
+            for (auto i = 0; i < thinning_; i++) {
+                advance();
+            }
 
-                auto const phi_t = phi(x, y, z);    // xの波動関数
-                if (nextflag) {
-                    x = x_star;
-                    y = y_star;
-                    z = z_star;
-                    nextflag = false;
+            for (auto k = 0U; k < K && count < n; k++) {
+                if (state.val[k] == 0.0) {
                     continue;
                 }
 
-                auto const phi_star = phi(x_star, y_star, z_star);  // x* の波動関数
+                Put_vertex(starti + count, state.x[k], state.y[k], state.z[k], state.sign[k]);
+                count++;
+            }
+        }
 
-                // 採択率を計算  α = p(x*) / p(x_t)
-                auto const alpha = (phi_star * phi_star) / (phi_t * phi_t);
+        return state.count;
+    }
 
-                //採択率により決定
-                auto const ar = mr.myrand();    // 0 <= ar <= 1 の一様乱数 ar を生成
-                if (ar <= alpha) {              // 採択
-                    x = x_star;
-                    y = y_star;
-                    z = z_star;
-                    if (phi_star >= 0.0) {
-                        sign = 1;
-                    }
-                    else {
-                        sign = -1;
-                    }
-                }
-                else {                          // 採択しない
-                    continue;
+    template <bool WF>
+    void OrbitalDensityRand::FillSimpleVertexQuasi(std::int32_t m, std::int32_t starti, std::int32_t endi, std::uint32_t seed)
+    {
+        myrandom::ScrambledSobol const sobol(seed);
+        auto const & table = pgd_->Radial_table();
+        auto const & cdf = Radial_cdf();
+        auto const pangular = Angular_table(angularcdfs_, m);
+
+        std::array<double, DIRECTBLOCK> u0, u1, u2, r, radial, ux, uy, uz, angular;
+
+        for (auto i = starti; i < endi; i += DIRECTBLOCK) {
+            if (thread_end_) {
+                return;
+            }
+
+            // 2次元の射影の一様さが最もよい1、2次元目を角度方向に、3次元目を動径方向に使う
+            auto const n = std::min(DIRECTBLOCK, endi - i);
+            sobol(static_cast<std::uint32_t>(i), u0.data(), u1.data(), u2.data(), n);
+            cdf(u2.data(), r.data(), n);
+            table(r.data(), radial.data(), n);
+            (*pangular)(u0.data(), u1.data(), ux.data(), uy.data(), uz.data(), angular.data(), n);
+
+            for (auto k = 0; k < n; k++) {
+                auto const v = WF ? radial[k] * angular[k] : radial[k];
+                Put_vertex(i + k, r[k] * ux[k], r[k] * uy[k], r[k] * uz[k], v >= 0.0 ? 1.0f : -1.0f);
+            }
+        }
+    }
+
+    template <std::size_t K, bool WF>
+    sampler::AcceptanceCount OrbitalDensityRand::FillSimpleVertexTempering(std::int32_t m, std::int32_t starti, std::int32_t endi, std::uint32_t seed, std::uint64_t stream)
+    {
+        myrandom::MyRandSfmt mr(seed, stream);
+        realylm::RealYlm const ylm(static_cast<std::int32_t>(pgd_->L), m);
+        auto const & table = pgd_->Radial_table();
+        auto const sigma0 = tuner_.Sigma(m);
+
+        // β_0 = 1からβ_{K-1} = BETAMINまで等比に並べ、|ψ|^(2β)の広がりに合わせて提案分布の標準偏差を1 / √βに比例させる
+        std::array<double, K> sigma, beta;
+        for (auto k = 0U; k < K; k++) {
+            beta[k] = k ? std::pow(BETAMIN, static_cast<double>(k) / static_cast<double>(K - 1)) : 1.0;
+            sigma[k] = sigma0 / std::sqrt(beta[k]);
+        }
+
+        sampler::ChainState<K> state;
+        auto const n = endi - starti;
+        auto count = 0;
+        std::size_t parity = 0;
+
+        for (auto step = 0; step < burnin_; step++) {
+            if (thread_end_) {
+                return state.count;
+            }
+
+            sampler::Metropolis_step<K, WF>(state, mr, ylm, table, sigma, beta);
+            sampler::Swap_step<K>(state, mr, beta, parity);
+            parity ^= 1;
+        }
+
+        while (count < n) {
+            if (thread_end_) {
+                return state.count;
+            }
+
+            for (auto step = 0; step < thinning_; step++) {
+                sampler::Metropolis_step<K, WF>(state, mr, ylm, table, sigma, beta);
+                sampler::Swap_step<K>(state, mr, beta, parity);
+                parity ^= 1;
+            }
+
+            // 高温のチェーンは目標の分布に従わないので、β = 1のチェーンの点だけを詰める
+            if (state.val[0] != 0.0) {
+                Put_vertex(starti + count, state.x[0], state.y[0], state.z[0], state.sign[0]);
+                count++;
+            }
+        }
+
+        return state.count;
+    }
+
+    bool OrbitalDensityRand::Markov_chain(Normal_Nelson_type nornel)
+    {
+        return nornel == Normal_Nelson_type::NORMAL || nornel == Normal_Nelson_type::TEMPERING ||
+            nornel == Normal_Nelson_type::MALA;
+    }
+
+    void OrbitalDensityRand::Put_vertex(std::size_t i, double x, double y, double z, float sign)
+    {
+        if (packed_) {
+            packedvertexout_[i] = Pack_vertex(x, y, z, sign, rmax_);
+            return;
+        }
+
+        auto & v = vertexout_[i];
+        v.Pos.x = static_cast<float>(x);
+        v.Pos.y = static_cast<float>(y);
+        v.Pos.z = static_cast<float>(z);
+
+        v.Color.x = sign > 0.0f ? 0.8f : 0.0f;
+        v.Color.y = sign < 0.0f ? 0.8f : 0.0f;
+        v.Color.z = 0.8f;
+        v.Color.w = 1.0f;
+    }
+
+    void OrbitalDensityRand::PublishChunk(std::int32_t c, std::int32_t chunks, std::int32_t size)
+    {
+        // チャンクの頂点の書き込みは、ビットを立てるより前に完了している
+        readychunks_[c / 64].fetch_or(std::uint64_t(1) << (c % 64), std::memory_order_release);
+
+        // 先頭から連続して完了しているチャンクの分だけ境界を進める
+        auto prefix = readyprefix_.load(std::memory_order_acquire);
+        while (prefix < chunks && (readychunks_[prefix / 64].load(std::memory_order_acquire) >> (prefix % 64)) & 1) {
+            if (readyprefix_.compare_exchange_weak(prefix, prefix + 1, std::memory_order_acq_rel)) {
+                prefix++;
+            }
+        }
+
+        // 他のスレッドがより先まで公開していれば、その値を残す（単調増加）
+        auto const newsize = static_cast<std::vector<SimpleVertex>::size_type>(std::min(prefix * CHUNKSIZE, size));
+        auto oldsize = readysize_.load(std::memory_order_relaxed);
+        while (oldsize < newsize && !readysize_.compare_exchange_weak(oldsize, newsize, std::memory_order_acq_rel)) {
+        }
+    }
+
+    std::vector<double> OrbitalDensityRand::Radial_nodes() const
+    {
+        auto const & table = pgd_->Radial_table();
+        auto const & rmesh = table.R_mesh();
+
+        std::vector<double> phi(rmesh.size());
+        table(rmesh.data(), phi.data(), rmesh.size());
+
+        auto phimax = 0.0;
+        for (auto const v : phi) {
+            phimax = std::max(phimax, std::fabs(v));
+        }
+
+        std::vector<double> nodes;
+        for (std::size_t i = 1; i < rmesh.size(); i++) {
+            // 符号が変わる区間は二分法で節を求める
+            if ((phi[i - 1] < 0.0 && phi[i] > 0.0) || (phi[i - 1] > 0.0 && phi[i] < 0.0)) {
+                auto a = rmesh[i - 1], b = rmesh[i];
+                auto const sa = phi[i - 1] > 0.0;
+                for (auto iter = 0; iter < RADIALNODEBISECTIONS; iter++) {
+                    auto const c = 0.5 * (a + b);
+                    ((table(c) > 0.0) == sa ? a : b) = c;
                 }
+                nodes.push_back(0.5 * (a + b));
+                continue;
             }
-            break;
 
-            default:
-                BOOST_ASSERT(!"何かがおかしい!");
-                break;
+            // 電子密度は節で符号が変わらないので、ほぼ0まで下がる内側の極小点を節とみなす
+            if (i + 1 < rmesh.size() && std::fabs(phi[i]) < RADIALNODETOLERANCE * phimax &&
+                std::fabs(phi[i]) < std::fabs(phi[i - 1]) && std::fabs(phi[i]) <= std::fabs(phi[i + 1]) && phi[i] != 0.0) {
+                nodes.push_back(rmesh[i]);
             }
+        }
 
-            vertex_[starti + count_].Pos.x = static_cast<float>(x);
-            vertex_[starti + count_].Pos.y = static_cast<float>(y);
-            vertex_[starti + count_].Pos.z = static_cast<float>(z);
+        return nodes;
+    }
 
-            vertex_[starti + count_].Color.x = sign > 0 ? 0.8f : 0.0f;
-            vertex_[starti + count_].Color.y = sign < 0 ? 0.8f : 0.0f;
-            vertex_[starti + count_].Color.z = 0.8f;
-            vertex_[starti + count_].Color.w = 1.0f;
-            count_++;
-		} while (count_ < (endi - starti));
-	}
+    directsampler::RadialCdf const & OrbitalDensityRand::Radial_cdf()
+    {
+        std::lock_guard<std::mutex> lock(directmtx_);
+        if (!pradialcdf_) {
+            pradialcdf_ = std::make_unique<directsampler::RadialCdf const>(pgd_->Radial_table());
+        }
+
+        return *pradialcdf_;
+    }
 
+    void OrbitalDensityRand::Speculate(std::int32_t m, Normal_Nelson_type nornel, std::uint64_t family, std::shared_ptr<samplecache::SampleCache> const & pcache)
+    {
+        auto const size = vertexsize_.load();
+        auto const bytes = Cache_bytes();
+
+        // 描画スレッドのために1コア空けておく
+        auto const threads = std::max(threads_ - 1, 1);
+
+        pool_.Speculate(m, static_cast<std::int32_t>(pgd_->L), bytes, thread_end_, [&](std::int32_t mm, cloudpool::PoolEntry & entry) {
+            auto const key = Cache_key(mm, family);
+            if (pcache) {
+                entry.pregion = pcache->Find(key, bytes);
+            }
+
+            if (entry.pregion) {
+                return true;
+            }
+
+            packed_ ? entry.packedvertex.resize(size) : entry.vertex.resize(size);
+            packedvertexout_ = entry.packedvertex.data();
+            vertexout_ = entry.vertex.data();
+
+            entry.seed = seed_ ? *seed_ : std::random_device()();
+            FillSimpleVertexChunks(mm, nornel, 0, static_cast<std::int32_t>(size), entry.seed, threads, false);
+            if (thread_end_) {
+                return false;
+            }
+
+            if (pcache) {
+                pcache->Store(key, packed_ ? static_cast<void const *>(entry.packedvertex.data()) : static_cast<void const *>(entry.vertex.data()), bytes);
+            }
+
+            return true;
+        });
+    }
+
+    double OrbitalDensityRand::Tuned_step(std::int32_t m, Normal_Nelson_type nornel)
+    {
+        return nornel == Normal_Nelson_type::MALA ? tuner_.Step(m) : tuner_.Sigma(m);
+    }
     // #endregion privateメンバ関数
 
     // #region フリー関数
@@ -355,6 +1021,24 @@ namespace orbitaldensityrand {
 		return (2.3622 * n + 3.3340) * n + 1.3228;
 	}
 
+    PackedVertex Pack_vertex(double x, double y, double z, float sign, double scale)
+    {
+        auto const s = static_cast<double>(PACKEDMAX) / scale;
+        auto const quantize = [s](double v) {
+            // 範囲外の座標を丸めてから、0から遠い方へ四捨五入する
+            auto const t = std::min(std::max(v * s, -static_cast<double>(PACKEDMAX)), static_cast<double>(PACKEDMAX));
+            return static_cast<std::int16_t>(t + (t >= 0.0 ? 0.5 : -0.5));
+        };
+
+        return { quantize(x), quantize(y), quantize(z), static_cast<std::int16_t>(sign < 0.0f ? -PACKEDMAX : PACKEDMAX) };
+    }
+
+    double Packed_error_bound(double scale)
+    {
+        // 丸めによる誤差は量子化の幅の半分で、元に戻すときと元の座標のfloatへの丸めの分を加える
+        return 0.5 * scale / static_cast<double>(PACKEDMAX) + scale * std::numeric_limits<float>::epsilon();
+    }
+
     double Spherical_harmonic(std::int32_t l, std::int32_t m, double theta, double phi)
     {
         if (!m) {
@@ -371,5 +1055,16 @@ namespace orbitaldensityrand {
         }
     }
 
+    SimpleVertex Unpack_vertex(PackedVertex const & pv, double scale)
+    {
+        auto const s = scale / static_cast<double>(PACKEDMAX);
+
+        SimpleVertex v;
+        v.Pos = { static_cast<float>(pv.x * s), static_cast<float>(pv.y * s), static_cast<float>(pv.z * s) };
+        v.Color = { pv.w > 0 ? 0.8f : 0.0f, pv.w < 0 ? 0.8f : 0.0f, 0.8f, 1.0f };
+
+        return v;
+    }
+
     // #endregion フリー関数
 }
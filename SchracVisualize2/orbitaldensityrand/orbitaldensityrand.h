@@ -10,28 +10,33 @@
 
 #pragma once
 
-#include "DXUT.h"
+#include "cloudpool/cloudpool.h"
+#include "diagnostics/chaindiagnostics.h"
+#include "diagnostics/lobebalance.h"
+#include "directsampler/angularcdf.h"
+#include "directsampler/angularsampler.h"
+#include "directsampler/radialcdf.h"
 #include "getdata/getdata.h"
-#include "myfunctional/functional.h"
 #include "myrandom/myrandsfmt.h"
+#include "myrandom/scrambledsobol.h"
+#include "realylm/realylm.h"
+#include "samplecache/samplecache.h"
+#include "sampler/chainstate.h"
+#include "sampler/steptuner.h"
 #include "utility/property.h"
+#include "vertex.h"
 #include <array>                // for std::array
 #include <atomic>               // for std::atomic
+#include <cstddef>              // for std::size_t
+#include <cstdint>              // for std::int32_t, std::uint32_t, std::uint64_t
+#include <map>                  // for std::map
 #include <memory>               // for std::shared_ptr, for std::unique_ptr
+#include <mutex>                // for std::mutex
+#include <optional>             // for std::optional
 #include <thread>               // for std::thread
 #include <vector>               // for std::vector
 
 namespace orbitaldensityrand {
-    //! A struct.
-    /*!
-        頂点構造体
-    */
-    struct SimpleVertex
-    {
-        DirectX::XMFLOAT3 Pos;
-        DirectX::XMFLOAT4 Color;
-    };
-
     //! A class.
     /*!
         軌道・電子密度の乱数生成クラス
@@ -48,7 +53,15 @@ namespace orbitaldensityrand {
             // Nelsonの確率力学を使わない
             NORMAL,
             // Nelsonの確率力学を使う
-            NELSON
+            NELSON,
+            // マルコフ連鎖を使わず、動径方向と角度方向を独立に直接生成する
+            DIRECT,
+            // スクランブルしたSobol点列（準乱数）を、動径方向と角度方向の累積分布関数の逆関数で写す
+            QUASI,
+            // 逆温度の異なるチェーンの梯子を進めて隣どうしを交換し（交換モンテカルロ法）、β = 1のチェーンの点だけを詰める
+            TEMPERING,
+            // ネルソンの確率力学と同じドリフト∇log|ψ|で提案点をずらし、メトロポリス・ヘイスティングス法で補正する（MALA）
+            MALA
         };
 
         // #endregion 列挙型
@@ -81,7 +94,38 @@ namespace orbitaldensityrand {
         */
         void operator()(std::int32_t m, Normal_Nelson_type nornel);
 
+        //! A public member function (const).
+        /*!
+            公開済みの点群の原点からの距離rについて、積分自己相関時間、有効サンプルサイズとR-hatを求める
+            メトロポリス・ヘイスティングス法ではチャンクごとの各チェーンを、直接生成と準乱数ではチャンクを、
+            ネルソンの確率力学では軌跡をDIAGNOSESEGMENTS個に分けたものを、それぞれ1本の連鎖とみなす
+            \param nornel 点群を生成したときのモード
+            \return 診断結果
+        */
+        diagnostics::ChainDiagnostics Diagnose(Normal_Nelson_type nornel) const;
+
+        //! A public member function (const).
+        /*!
+            公開済みの点群を、各スレッドがまとめて生成する連続した頂点（チャンク）ごとに分け、チャンクごとのローブ（節面で
+            区切られた領域）の頻度が点群全体の頻度からどれだけ偏っているかを求める
+            \param m 点群の磁気量子数
+            \return 測定結果（チャンクが1つもなければwindowsが0）
+        */
+        diagnostics::LobeBalance Lobe_balance(std::int32_t m) const;
+
     private:
+        //! A private member function (template function).
+        /*!
+            磁気量子数mの角度方向の表（directsampler::AngularCdfかdirectsampler::AngularSampler）を返す
+            初めて使うmなら作ってtablesに残しておく
+            \tparam T 表の型（(l, m, 電子密度かどうか)から作れること）
+            \param tables 磁気量子数ごとの表
+            \param m 磁気量子数
+            \return 角度方向の表
+        */
+        template <typename T>
+        std::shared_ptr<T const> Angular_table(std::map<std::int32_t, std::shared_ptr<T const>> & tables, std::int32_t m);
+
         //! A private member function.
         /*!
             SimpleVertexのデータをクリアし、新しいデータを詰める
@@ -92,28 +136,187 @@ namespace orbitaldensityrand {
 
         //! A private member function.
         /*!
-            SimpleVertexにデータを詰める
+            磁気量子数mの点群に対応するキャッシュのキーを求める
             \param m 磁気量子数
+            \param family m以外の設定のキー（Family_keyの戻り値）
+            \return キャッシュのキー
+        */
+        std::uint64_t Cache_key(std::int32_t m, std::uint64_t family) const;
+
+        //! A private member function.
+        /*!
+            現在の形式の頂点の配列のバイト数を返す
+            \return 頂点の配列のバイト数
         */
-        void FillSimpleVertex(std::int32_t m);
+        std::size_t Cache_bytes() const;
+
+        //! A private member function.
+        /*!
+            生成済みの頂点を残したまま、頂点数を増やした分だけ点群を生成する（Nelsonの確率力学以外）
+            \param m 磁気量子数
+            \param nornel ネルソンの確率力学を使用するかどうか
+            \param firstchunk 生成を始めるチャンクの番号（生成済みの頂点が途中までしかないチャンクは作り直す）
+        */
+        void ExtendSimpleVertex(std::int32_t m, Normal_Nelson_type nornel, std::int32_t firstchunk);
+
+        //! A private member function.
+        /*!
+            m以外の現在の設定（データ、モード、頂点数、シード等）のキーを求める
+            \param nornel ネルソンの確率力学を使用するかどうか
+            \return m以外の設定のキー
+        */
+        std::uint64_t Family_key(Normal_Nelson_type nornel) const;
 
         //! A private member function.
         /*!
             SimpleVertexにデータを詰める
             \param m 磁気量子数
+            \param seed 乱数のシード
+        */
+        void FillSimpleVertex(std::int32_t m, std::uint32_t seed);
+
+        //! A private member function.
+        /*!
+            SimpleVertexにデータを詰める（モード、チェーン数とデータの種類に応じてFillSimpleVertexChains、FillSimpleVertexDirectか
+            FillSimpleVertexQuasiを呼ぶ）
+            \return メトロポリス・ヘイスティングス法の採択数と提案数（直接生成と準乱数では0）
+            \param m 磁気量子数
+            \param nornel ネルソンの確率力学を使用するかどうか（NORMAL、DIRECTかQUASI）
+            \param starti 描画開始の際のiのインデックス
+            \param endi 描画終了の際のiのインデックス
+            \param seed 乱数のシード
+            \param stream 乱数列の番号（チャンクの番号）
+        */
+        sampler::AcceptanceCount FillSimpleVertex(std::int32_t m, Normal_Nelson_type nornel, std::int32_t starti, std::int32_t endi, std::uint32_t seed, std::uint64_t stream);
+
+        //! A private member function.
+        /*!
+            頂点をチャンクに分け、複数のスレッドでメトロポリス・ヘイスティングス法（または直接生成）によりSimpleVertexにデータを詰める
+            \param m 磁気量子数
+            \param nornel ネルソンの確率力学を使用するかどうか（NORMAL、DIRECTかQUASI）
+            \param firstchunk 生成を始めるチャンクの番号（それより前のチャンクは生成済み）
+            \param size 頂点数
+            \param seed 乱数のシード
+            \param threads スレッド数
+            \param publish 完了したチャンクを公開済みの頂点数に反映するかどうか（先読みではfalse）
+        */
+        void FillSimpleVertexChunks(std::int32_t m, Normal_Nelson_type nornel, std::int32_t firstchunk, std::int32_t size, std::uint32_t seed, std::int32_t threads, bool publish);
+
+        //! A private member function (template function).
+        /*!
+            K本の独立なマルコフ連鎖をSoA形式で同時に進め、SimpleVertexにチェーンの順に交互に詰める
+            提案分布の標準偏差はTuned_stepで調整した値を使い、棄却された場合も現在の点をもう一度詰める
+            \tparam K 1スレッドあたりのチェーン数
+            \tparam WF 波動関数のデータかどうか（falseなら電子密度）
+            \param m 磁気量子数
+            \param starti 描画開始の際のiのインデックス
+            \param endi 描画終了の際のiのインデックス
+            \param seed 乱数のシード
+            \param stream 乱数列の番号（チャンクの番号）
+            \return 採択数と提案数
+        */
+        template <std::size_t K, bool WF>
+        sampler::AcceptanceCount FillSimpleVertexChains(std::int32_t m, std::int32_t starti, std::int32_t endi, std::uint32_t seed, std::uint64_t stream);
+
+        //! A private member function (template function).
+        /*!
+            K本のマルコフ連鎖を、目標の分布の勾配を使う提案（MALA）で進め、SimpleVertexにチェーンの順に交互に詰める
+            σはTuned_stepで調整した値を使い、棄却された場合も現在の点をもう一度詰める
+            \tparam K 1スレッドあたりのチェーン数
+            \tparam WF 波動関数のデータかどうか（falseなら電子密度）
+            \param m 磁気量子数
+            \param starti 描画開始の際のiのインデックス
+            \param endi 描画終了の際のiのインデックス
+            \param seed 乱数のシード
+            \param stream 乱数列の番号（チャンクの番号）
+            \return 採択数と提案数
+        */
+        template <std::size_t K, bool WF>
+        sampler::AcceptanceCount FillSimpleVertexGradient(std::int32_t m, std::int32_t starti, std::int32_t endi, std::uint32_t seed, std::uint64_t stream);
+
+        //! A private member function (template function).
+        /*!
+            動径方向を累積分布関数の逆関数で、角度方向を棄却法で生成し、互いに独立な点をSimpleVertexに詰める
+            \tparam WF 波動関数のデータかどうか（falseなら電子密度）
+            \param m 磁気量子数
+            \param starti 描画開始の際のiのインデックス
+            \param endi 描画終了の際のiのインデックス
+            \param seed 乱数のシード
+            \param stream 乱数列の番号（チャンクの番号）
+        */
+        template <bool WF>
+        void FillSimpleVertexDirect(std::int32_t m, std::int32_t starti, std::int32_t endi, std::uint32_t seed, std::uint64_t stream);
+
+        //! A private member function (template function).
+        /*!
+            i番目の頂点を、スクランブルしたSobol点列のi番目の点を動径方向と角度方向の累積分布関数の逆関数で写して詰める
+            点は頂点の番号とシードだけで決まるので、チャンクの分け方やスレッド数によらず同じ点群になる
+            \tparam WF 波動関数のデータかどうか（falseなら電子密度）
+            \param m 磁気量子数
+            \param starti 描画開始の際のiのインデックス
+            \param endi 描画終了の際のiのインデックス
+            \param seed スクランブルのシード
+        */
+        template <bool WF>
+        void FillSimpleVertexQuasi(std::int32_t m, std::int32_t starti, std::int32_t endi, std::uint32_t seed);
+
+        //! A private member function (template function).
+        /*!
+            逆温度β_k = BETAMIN^(k / (K - 1))のK本のチェーンの梯子を進め、毎ステップ隣どうしの交換を試みて、β = 1のチェーンの点だけを詰める
+            βの小さいチェーンは|ψ|^(2β)に従うので節面を越えやすく、交換によってβ = 1のチェーンも別のローブに移りやすくなる
+            \tparam K 梯子の段数
+            \tparam WF 波動関数のデータかどうか（falseなら電子密度）
+            \param m 磁気量子数
             \param starti 描画開始の際のiのインデックス
             \param endi 描画終了の際のiのインデックス
+            \param seed 乱数のシード
+            \param stream 乱数列の番号（チャンクの番号）
+            \return 採択数と提案数、交換の採択数と試行数
         */
-        void FillSimpleVertex(std::int32_t m, std::int32_t starti, std::int32_t endi);
+        template <std::size_t K, bool WF>
+        sampler::AcceptanceCount FillSimpleVertexTempering(std::int32_t m, std::int32_t starti, std::int32_t endi, std::uint32_t seed, std::uint64_t stream);
+
+        //! A private member function (static).
+        /*!
+            マルコフ連鎖で点を生成するモード（提案分布の標準偏差や刻み幅を調整し、バーンインと間引きを使う）かどうかを返す
+            \param nornel 点群の生成方法
+            \return マルコフ連鎖で点を生成するかどうか
+        */
+        static bool Markov_chain(Normal_Nelson_type nornel);
+
+        //! A private member function.
+        /*!
+            i番目の頂点を、現在の形式（SimpleVertexかPackedVertex）で書き込む
+            \param i 頂点のインデックス
+            \param x 座標のx成分
+            \param y 座標のy成分
+            \param z 座標のz成分
+            \param sign 波動関数の符号
+        */
+        void Put_vertex(std::size_t i, double x, double y, double z, float sign);
 
         //! A private member function.
         /*!
-            関数の数値微分を求める
-            \param x 微分する座標x
-            \param func 微分対象の関数
+            チャンクの生成完了を記録し、先頭から連続して完了したチャンクの分だけ公開済みの頂点数を進める
+            \param c 生成が完了したチャンクの番号
+            \param chunks チャンクの総数
+            \param size 頂点数
         */
-        template <typename FUNCTYPE>
-        double Numerical_diff(double x, myfunctional::Functional<FUNCTYPE> const & func);
+        void PublishChunk(std::int32_t c, std::int32_t chunks, std::int32_t size);
+
+        //! A private member function (const).
+        /*!
+            動径関数の節（符号が変わる点、電子密度の場合はほぼ0になる極小点）のrを求める
+            \return 節のr（昇順）
+        */
+        std::vector<double> Radial_nodes() const;
+
+        //! A private member function.
+        /*!
+            動径方向の累積分布関数の表を返す（初めて使うときに作る）
+            \return 動径方向の累積分布関数の表
+        */
+        directsampler::RadialCdf const & Radial_cdf();
 
         //! A private member function.
         /*!
@@ -124,11 +327,75 @@ namespace orbitaldensityrand {
             q_ = q0_;
         }
 
+        //! A private member function.
+        /*!
+            表示中の点群の生成が終わった後、残りのコアで他のmの点群を先読みしてプールに入れる（ネルソンの確率力学以外の全ての生成方法）
+            \param m 表示中の点群の磁気量子数
+            \param nornel 点群の生成方法（NELSON以外）
+            \param family m以外の設定のキー
+            \param pcache 点群のキャッシュ（nullptrならキャッシュを使わない）
+        */
+        void Speculate(std::int32_t m, Normal_Nelson_type nornel, std::uint64_t family, std::shared_ptr<samplecache::SampleCache> const & pcache);
+
+        //! A private member function.
+        /*!
+            mと頂点数以外の現在の設定（データ、モード、シード等）のキーを求める
+            このキーとmが同じ点群は、頂点数によらず同じ乱数列から生成されるので、一方が他方の先頭部分になる
+            \param nornel ネルソンの確率力学を使用するかどうか
+            \return mと頂点数以外の設定のキー
+        */
+        std::uint64_t Stream_key(Normal_Nelson_type nornel) const;
+
+        //! A private member function.
+        /*!
+            磁気量子数mの軌道について調整した、nornelの提案分布の標準偏差を返す（初めて使う組なら調整して残しておく）
+            \param m 磁気量子数
+            \param nornel 点群の生成方法（マルコフ連鎖を使うもの）
+            \return 提案分布の標準偏差
+        */
+        double Tuned_step(std::int32_t m, Normal_Nelson_type nornel);
+
         // #endregion メンバ関数
 
         // #region プロパティ
 
     public:
+        //! A property.
+        /*!
+            直前に生成した点群のメトロポリス・ヘイスティングス法の採択率へのプロパティ（生成していなければ0）
+        */
+        utility::Property<double> const Acceptance_rate;
+
+        //! A property.
+        /*!
+            メトロポリス・ヘイスティングス法で、各チェーンが点を詰め始める前に進めるステップ数（バーンイン）へのプロパティ
+        */
+        utility::Property<std::int32_t> Burnin;
+
+        //! A property.
+        /*!
+            点群のキャッシュへのプロパティ（nullptrならキャッシュを使わない、シードが指定されているときだけ使う）
+        */
+        utility::Property<std::shared_ptr<samplecache::SampleCache>> Cache;
+
+        //! A property.
+        /*!
+            直前の再描画で点群がキャッシュから読み込まれたかどうかへのプロパティ
+        */
+        utility::Property<bool> const Cache_hit;
+
+        //! A property.
+        /*!
+            1スレッドあたりのマルコフ連鎖の数へのプロパティ（1、4、8、16のいずれか）
+        */
+        utility::Property<std::int32_t> Chains;
+
+        //! A property.
+        /*!
+            直前の生成で各スレッドが処理したチャンク数へのプロパティ（メトロポリス・ヘイスティングス法のみ）
+        */
+        utility::Property<std::vector<std::int32_t> const &> const Chunk_counts;
+
         //! A property.
         /*!
             描画スレッドの作業が完了したかどうかへのプロパティ
@@ -146,13 +413,61 @@ namespace orbitaldensityrand {
             経過時間のカウントへのプロパティ
         */
         utility::Property<double> Elapsed_time;
+
+        //! A property.
+        /*!
+            点群の世代（再生成を始めるたびに1増える）へのプロパティ
+        */
+        utility::Property<std::uint64_t> const Generation;
         
+        //! A property.
+        /*!
+            プールに残す点群の合計のバイト数の上限へのプロパティ
+        */
+        utility::Property<std::size_t> Pool_budget;
+
+        //! A property.
+        /*!
+            プールの点群の合計のバイト数へのプロパティ
+        */
+        utility::Property<std::size_t> const Pool_bytes;
+
+        //! A property.
+        /*!
+            直前の再描画で点群がプールから取り出されたかどうかへのプロパティ
+        */
+        utility::Property<bool> const Pool_hit;
+
+        //! A property.
+        /*!
+            プールの点群の数へのプロパティ
+        */
+        utility::Property<std::int32_t> const Pool_size;
+
+        //! A property.
+        /*!
+            表示中の軌道について調整した提案分布の標準偏差へのプロパティ（マルコフ連鎖を使わない場合は0）
+        */
+        utility::Property<double> const Proposal_sigma;
+
         //! A property.
         /*!
             スレッドへのスマートポインタのプロパティ
         */
         utility::Property<std::shared_ptr<std::thread> const &> const Pth;
 
+        //! A property.
+        /*!
+            頂点を圧縮した形式（PackedVertex）で生成するかどうかへのプロパティ（次の再描画から有効）
+        */
+        utility::Property<bool> Packed;
+
+        //! A property.
+        /*!
+            圧縮した頂点へのプロパティ
+        */
+        utility::Property<VertexView<PackedVertex>> const Packed_vertex;
+
         //! A property.
         /*!
             再描画するかどうかへのプロパティ
@@ -165,21 +480,72 @@ namespace orbitaldensityrand {
         */
         utility::Property<double> Rmax;
 
+        //! A property.
+        /*!
+            交換モンテカルロ法の梯子の段数（逆温度の数）へのプロパティ（4、8、16のいずれか）
+        */
+        utility::Property<std::int32_t> Rungs;
+
+        //! A property.
+        /*!
+            生成済みで描画してよい先頭からの頂点数へのプロパティ（生成中も単調に増加する）
+        */
+        utility::Property<std::vector<SimpleVertex>::size_type> const Ready_vertexsize;
+
+        //! A property.
+        /*!
+            乱数のシードへのプロパティ（std::nulloptの場合はstd::random_deviceで初期化する）
+            シード、頂点数、チェーン数が同じなら、スレッド数によらず同じ点群が生成される（頂点数の少ない点群は多い点群の先頭部分と一致する）
+        */
+        utility::Property<std::optional<std::uint32_t>> Seed;
+
+        //! A property.
+        /*!
+            表示中の点群の生成が終わった後、他のmの点群を先読みするかどうかへのプロパティ（次の再描画から有効）
+        */
+        utility::Property<bool> Speculative;
+
+        //! A property.
+        /*!
+            直前に生成した点群の交換モンテカルロ法の交換の採択率へのプロパティ（生成していなければ0）
+        */
+        utility::Property<double> const Swap_rate;
+
         //! A property.
         /*!
             スレッドを強制終了するかどうかへのプロパティ
         */
         utility::Property<bool> Thread_end;
 
+        //! A property.
+        /*!
+            乱数生成に使うスレッド数へのプロパティ
+        */
+        utility::Property<std::int32_t> Threads;
+
+        //! A property.
+        /*!
+            メトロポリス・ヘイスティングス法で、何ステップごとに点を詰めるか（間引き）へのプロパティ（1以上）
+        */
+        utility::Property<std::int32_t> Thinning;
+
         //! A property.
         /*!
             頂点へのプロパティ
         */
-        utility::Property<std::vector<SimpleVertex> const &> Vertex;
+        utility::Property<VertexView<SimpleVertex>> const Vertex;
+
+        //! A property.
+        /*!
+            頂点の格納に使っているホスト側のメモリ（バイト）へのプロパティ
+        */
+        utility::Property<std::size_t> const Vertex_bytes;
 
         //! A property.
         /*!
             頂点数へのプロパティ
+            メトロポリス・ヘイスティングス法で頂点数だけを変えた場合、次の再描画では生成済みの頂点を残し、増やした分だけを生成する
+            （減らした場合は描画する範囲を縮めるだけで、生成済みの頂点は増やし直すときのために残す）
         */
         utility::Property<std::vector<SimpleVertex>::size_type> Vertexsize;
 
@@ -187,6 +553,12 @@ namespace orbitaldensityrand {
 
         // #region メンバ変数
 
+        //! A public static member variable (constant expression).
+        /*!
+            バーンインのステップ数の初期値
+        */
+        static std::int32_t constexpr BURNIN_INIT_VALUE = 64;
+
         //! A public static member variable (constant).
         /*!
             頂点数の初期値（電子密度）
@@ -214,9 +586,47 @@ namespace orbitaldensityrand {
 
         //! A private member variable (constant expression).
         /*!
-            数値微分の刻み幅
+            交換モンテカルロ法の梯子の最も高温のチェーンの逆温度
+        */
+        static auto constexpr BETAMIN = 0.1;
+
+        //! A private member variable (constant expression).
+        /*!
+            キャッシュのキーに含める生成方法の版（同じパラメータでも生成される点群が変わる変更をしたら1増やす）
+        */
+        static std::uint64_t constexpr CACHE_VERSION = 5;
+
+        //! A private member variable (constant expression).
+        /*!
+            メトロポリス・ヘイスティングス法で、独立な乱数列を割り当てる頂点のまとまり（チャンク）の大きさ
+        */
+        static auto constexpr CHUNKSIZE = 65536;
+
+        //! A private member variable (constant expression).
+        /*!
+            1スレッドあたりのマルコフ連鎖の数の初期値
+        */
+        static auto constexpr CHAINS = 8;
+
+        //! A private member variable (constant expression).
+        /*!
+            交換モンテカルロ法の梯子の段数の初期値
         */
-        static auto constexpr DH = 1.0E-7;
+        static auto constexpr RUNGS = 8;
+
+        //! A private member variable (constant expression).
+        /*!
+            ネルソンの確率力学の軌跡を診断するときに分ける連鎖の数
+        */
+        static auto constexpr DIAGNOSESEGMENTS = 4;
+
+        //! A private member variable (constant expression).
+        /*!
+            直接生成と準乱数で、1回にまとめて生成する頂点数（CHUNKSIZEの約数であること）
+        */
+        static auto constexpr DIRECTBLOCK = 64;
+
+        static_assert(CHUNKSIZE % DIRECTBLOCK == 0, "DIRECTBLOCKはCHUNKSIZEの約数である必要があります");
 
         //! A private member variable (constant expression).
         /*!
@@ -226,28 +636,88 @@ namespace orbitaldensityrand {
 
         //! A private member variable (constant expression).
         /*!
-            許容誤差
+            ネルソンの確率力学で、公開済みの頂点数を更新するステップの間隔
         */
-        static auto constexpr EPS = 1.0E-15;
+        static auto constexpr PUBLISHINTERVAL = 4096U;
 
-        //! A private member variable (constant expression).
+        //! A private member variable.
         /*!
-            0の判定に使う閾値
+            直前に生成した点群の採択数
         */
-        static auto constexpr THRESHOLD = 1.0E-15;
+        std::atomic<std::uint64_t> accepted_ = 0;
                 
+        //! A private member variable.
+        /*!
+            磁気量子数ごとの角度方向の累積分布関数の表
+        */
+        std::map<std::int32_t, std::shared_ptr<directsampler::AngularCdf const>> angularcdfs_;
+
+        //! A private member variable.
+        /*!
+            磁気量子数ごとの角度方向のサンプラー
+        */
+        std::map<std::int32_t, std::shared_ptr<directsampler::AngularSampler const>> angularsamplers_;
+
+        //! A private member variable.
+        /*!
+            直前の再描画で点群がキャッシュから読み込まれたかどうか
+        */
+        bool cachehit_ = false;
+
+        //! A private member variable.
+        /*!
+            バーンインのステップ数
+        */
+        std::int32_t burnin_ = BURNIN_INIT_VALUE;
+
+        //! A private member variable.
+        /*!
+            1スレッドあたりのマルコフ連鎖の数
+        */
+        std::int32_t chains_ = CHAINS;
+
+        //! A private member variable.
+        /*!
+            直前の生成で各スレッドが処理したチャンク数
+        */
+        std::vector<std::int32_t> chunkcounts_;
+
         //! A private member variable.
         /*!
             描画スレッドの作業が完了したかどうか
         */
         std::atomic<bool> complete_ = false;
 
+        //! A private member variable.
+        /*!
+            表示中の点群が完成していれば、その磁気量子数
+        */
+        std::optional<std::int32_t> completem_;
+
         //! A private member variable.
         /*!
             時間経過のカウント
         */
         std::uint32_t count_ = 0U;
 
+        //! A private member variable.
+        /*!
+            頂点の配列に入っている点群の磁気量子数
+        */
+        std::optional<std::int32_t> currentm_;
+
+        //! A private member variable.
+        /*!
+            頂点の配列に入っている点群を生成したときの頂点数
+        */
+        std::vector<SimpleVertex>::size_type currentsize_ = 0;
+
+        //! A private member variable.
+        /*!
+            角度方向のサンプラー、角度方向と動径方向の累積分布関数の表を作るときに保護するミューテックス
+        */
+        std::mutex directmtx_;
+
         //! A private member variable.
         /*!
             時間刻み（アト秒）
@@ -256,9 +726,45 @@ namespace orbitaldensityrand {
 
         //! A private member variable.
         /*!
-            SFMT乱数オブジェクト
+            表示中の点群とプールの点群のm以外の設定のキー
+        */
+        std::uint64_t family_ = 0;
+
+        //! A private member variable.
+        /*!
+            頂点の配列の先頭から生成済みの頂点数（頂点数を減らしても、増やし直すときのために残しておく）
+        */
+        std::vector<SimpleVertex>::size_type generated_ = 0;
+
+        //! A private member variable.
+        /*!
+            点群の世代
+        */
+        std::uint64_t generation_ = 0;
+
+        //! A private member variable.
+        /*!
+            頂点を圧縮した形式で生成するかどうか
+        */
+        bool packed_ = false;
+
+        //! A private member variable.
+        /*!
+            圧縮した頂点
+        */
+        std::vector<PackedVertex> packedvertex_;
+
+        //! A private member variable.
+        /*!
+            圧縮した頂点を書き込む先
+        */
+        PackedVertex * packedvertexout_ = nullptr;
+
+        //! A private member variable.
+        /*!
+            点群のキャッシュ
         */
-        myrandom::MyRandSfmt mr_;
+        std::shared_ptr<samplecache::SampleCache> pcache_;
 
         //! A private member variable.
         /*!
@@ -266,12 +772,60 @@ namespace orbitaldensityrand {
         */
         std::shared_ptr<getdata::GetData> pgd_;
 
+        //! A private member variable.
+        /*!
+            動径方向の累積分布関数の表
+        */
+        std::unique_ptr<directsampler::RadialCdf const> pradialcdf_;
+
+        //! A private member variable.
+        /*!
+            磁気量子数ごとの完成した点群のプール
+        */
+        cloudpool::CloudPool pool_;
+
+        //! A private member variable.
+        /*!
+            直前の再描画で点群がプールから取り出されたかどうか
+        */
+        bool poolhit_ = false;
+
+        //! A private member variable.
+        /*!
+            直前に生成した点群の提案数
+        */
+        std::atomic<std::uint64_t> proposed_ = 0;
+
         //! A private member variable.
         /*!
             スレッドへのスマートポインタ
         */
         std::shared_ptr<std::thread> pth_;
 
+        //! A private member variable.
+        /*!
+            キャッシュから読み込んだ頂点の配列をマップした領域
+        */
+        samplecache::SampleCache::region_ptr pregion_;
+
+        //! A private member variable.
+        /*!
+            生成が完了したチャンクのビットマップ
+        */
+        std::unique_ptr<std::atomic<std::uint64_t>[]> readychunks_;
+
+        //! A private member variable.
+        /*!
+            先頭から連続して生成が完了したチャンクの数
+        */
+        std::atomic<std::int32_t> readyprefix_ = 0;
+
+        //! A private member variable.
+        /*!
+            生成済みで描画してよい先頭からの頂点数
+        */
+        std::atomic<std::vector<SimpleVertex>::size_type> readysize_ = 0;
+
         //! A private member variable (constant expression).
         /*!
             座標の初期値
@@ -296,12 +850,78 @@ namespace orbitaldensityrand {
         */
         double rmax_;
 
+        //! A private member variable.
+        /*!
+            乱数のシード
+        */
+        std::optional<std::uint32_t> seed_;
+
+        //! A private member variable.
+        /*!
+            交換モンテカルロ法の梯子の段数
+        */
+        std::int32_t rungs_ = RUNGS;
+
+        //! A private member variable.
+        /*!
+            頂点の配列に入っている点群の生成に使った乱数のシード
+        */
+        std::uint32_t seedused_ = 0;
+
+        //! A private member variable.
+        /*!
+            表示中の軌道について調整した提案分布の標準偏差
+        */
+        double sigma_ = 0.0;
+
+        //! A private member variable.
+        /*!
+            他のmの点群を先読みするかどうか
+        */
+        bool speculative_ = false;
+
+        //! A private member variable.
+        /*!
+            頂点の配列に入っている点群のmと頂点数以外の設定のキー
+        */
+        std::uint64_t streamkey_ = 0;
+
+        //! A private member variable.
+        /*!
+            直前に生成した点群の交換の採択数
+        */
+        std::atomic<std::uint64_t> swapaccepted_ = 0;
+
+        //! A private member variable.
+        /*!
+            直前に生成した点群の交換の試行数
+        */
+        std::atomic<std::uint64_t> swapproposed_ = 0;
+
         //! A private member variable.
         /*!
             スレッドを強制終了するかどうか
         */
         std::atomic<bool> thread_end_ = false;
 
+        //! A private member variable.
+        /*!
+            乱数生成に使うスレッド数
+        */
+        std::int32_t threads_;
+
+        //! A private member variable.
+        /*!
+            間引きの間隔
+        */
+        std::int32_t thinning_ = 1;
+
+        //! A private member variable.
+        /*!
+            磁気量子数ごとに調整した提案分布の標準偏差とMALAのσ
+        */
+        sampler::StepTuner tuner_;
+
         //! A private member variable.
         /*!
             頂点数
@@ -314,6 +934,12 @@ namespace orbitaldensityrand {
         */
         std::vector<SimpleVertex> vertex_;
 
+        //! A private member variable.
+        /*!
+            頂点を書き込む先
+        */
+        SimpleVertex * vertexout_ = nullptr;
+
     public:
         // #region 禁止されたコンストラクタ・メンバ関数
 
@@ -349,6 +975,35 @@ namespace orbitaldensityrand {
     */
     double GetRmax(std::shared_ptr<getdata::GetData> const& pgd);
 
+    //! A function.
+    /*!
+        頂点を圧縮する（範囲外の座標は±scaleに丸める）
+        \param x 座標のx成分
+        \param y 座標のy成分
+        \param z 座標のz成分
+        \param sign 波動関数の符号
+        \param scale 座標の最大値（Rmax）
+        \return 圧縮した頂点
+    */
+    PackedVertex Pack_vertex(double x, double y, double z, float sign, double scale);
+
+    //! A function.
+    /*!
+        圧縮して元に戻した座標と、SimpleVertexの座標との各成分の差の上限（範囲内の座標の場合）を求める
+        \param scale 座標の最大値（Rmax）
+        \return 誤差の上限
+    */
+    double Packed_error_bound(double scale);
+
+    //! A function.
+    /*!
+        圧縮した頂点を元に戻す
+        \param pv 圧縮した頂点
+        \param scale 座標の最大値（Rmax）
+        \return 元に戻した頂点
+    */
+    SimpleVertex Unpack_vertex(PackedVertex const & pv, double scale);
+
     //! A function.
     /*!
         実関数表示の球面調和関数を求める
@@ -359,19 +1014,6 @@ namespace orbitaldensityrand {
         \return 実関数表示の球面調和関数
     */
     double Spherical_harmonic(std::int32_t l, std::int32_t m, double theta, double phi);
-
-    template <typename FUNCTYPE>
-    inline double OrbitalDensityRand::Numerical_diff(double x, myfunctional::Functional<FUNCTYPE> const & func)
-    {
-        auto const term1 = func(x + 3.0 * DH) / 60.0;
-        auto const term2 = -3.0 / 20.0 * func(x + 2.0 * DH);
-        auto const term3 = 3.0 / 4.0 * func(x + DH);
-        auto const term4 = -3.0 / 4.0 * func(x - DH);
-        auto const term5 = 3.0 / 20.0 * func(x - 2.0 * DH);
-        auto const term6 = -func(x - 3.0 * DH) / 60.0;
-
-        return (term1 + term2 + term3 + term4 + term5 + term6) / DH;
-    }
 }
 
 #endif  // _ORBITALDENSITYRAND_H_
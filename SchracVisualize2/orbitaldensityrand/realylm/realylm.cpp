@@ -0,0 +1,97 @@
+﻿/*! \file realylm.cpp
+    \brief 直交座標で実関数表示の球面調和関数を求めるクラスの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "realylm.h"
+#include <algorithm>                            // for std::min
+#include <cmath>                                // for std::sqrt
+#include <stdexcept>                            // for std::invalid_argument
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+
+namespace realylm {
+    // #region コンストラクタ
+
+    RealYlm::RealYlm(std::int32_t l, std::int32_t m)
+        : l_(l), m_(m)
+    {
+        using namespace boost::math::constants;
+
+        auto const am = m >= 0 ? m : -m;
+        if (l < 0 || l > LMAX || am > l) {
+            throw std::invalid_argument("量子数の指定が異常です！");
+        }
+
+        // (l - |m|)! / (l + |m|)!
+        auto factratio = 1.0;
+        for (auto k = l - am + 1; k <= l + am; k++) {
+            factratio /= static_cast<double>(k);
+        }
+
+        // (2|m| - 1)!!
+        auto dfact = 1.0;
+        for (auto k = 2 * am - 1; k > 1; k -= 2) {
+            dfact *= static_cast<double>(k);
+        }
+
+        norm_ = std::sqrt(static_cast<double>(2 * l + 1) / (4.0 * pi<double>()) * factratio) * dfact;
+        if (m) {
+            norm_ *= root_two<double>();
+        }
+
+        for (auto k = am + 1; k <= l; k++) {
+            c1_[k] = static_cast<double>(2 * k - 1) / static_cast<double>(k - am);
+            c2_[k] = static_cast<double>(k + am - 1) / static_cast<double>(k - am);
+        }
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    void RealYlm::operator()(double const * x, double const * y, double const * z, double * ylm, std::size_t n) const
+    {
+        auto const am = m_ >= 0 ? m_ : -m_;
+
+        for (std::size_t k0 = 0; k0 < n; k0 += BLOCKSIZE) {
+            auto const nb = std::min(BLOCKSIZE, n - k0);
+            auto const xb = x + k0;
+            auto const yb = y + k0;
+            auto const zb = z + k0;
+
+            std::array<double, BLOCKSIZE> c, s, qkm1, qkm2;
+            for (std::size_t j = 0; j < nb; j++) {
+                c[j] = 1.0;
+                s[j] = 0.0;
+                qkm1[j] = 1.0;
+                qkm2[j] = 0.0;
+            }
+
+            for (auto i = 0; i < am; i++) {
+                for (std::size_t j = 0; j < nb; j++) {
+                    auto const ctmp = c[j] * xb[j] - s[j] * yb[j];
+                    s[j] = c[j] * yb[j] + s[j] * xb[j];
+                    c[j] = ctmp;
+                }
+            }
+
+            for (auto k = am + 1; k <= l_; k++) {
+                auto const c1 = c1_[k];
+                auto const c2 = c2_[k];
+                for (std::size_t j = 0; j < nb; j++) {
+                    auto const qk = c1 * zb[j] * qkm1[j] - c2 * qkm2[j];
+                    qkm2[j] = qkm1[j];
+                    qkm1[j] = qk;
+                }
+            }
+
+            auto const & a = m_ > 0 ? c : s;
+            for (std::size_t j = 0; j < nb; j++) {
+                ylm[k0 + j] = norm_ * qkm1[j] * (m_ ? a[j] : 1.0);
+            }
+        }
+    }
+
+    // #endregion メンバ関数
+}
@@ -0,0 +1,201 @@
+﻿/*! \file realylm.h
+    \brief 直交座標で実関数表示の球面調和関数を求めるクラスの宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _REALYLM_H_
+#define _REALYLM_H_
+
+#pragma once
+
+#include <array>    // for std::array
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::int32_t
+
+namespace realylm {
+    //! A class.
+    /*!
+        実関数表示の球面調和関数を、単位ベクトル(x, y, z)の多項式（solid harmonics）として求めるクラス
+        θ、φを経由しないため、acosやatan等の超越関数を呼ばない
+    */
+    class RealYlm final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param l 方位量子数
+            \param m 磁気量子数
+        */
+        RealYlm(std::int32_t l, std::int32_t m);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~RealYlm() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function (const).
+        /*!
+            実関数表示の球面調和関数の値を返す
+            \param x 単位ベクトルのx成分
+            \param y 単位ベクトルのy成分
+            \param z 単位ベクトルのz成分
+            \return 実関数表示の球面調和関数の値
+        */
+        double operator()(double x, double y, double z) const;
+
+        //! A public member function (const).
+        /*!
+            n個の単位ベクトルについて、実関数表示の球面調和関数の値をまとめて求める
+            漸化式の各段で全要素をループするので、コンパイラがベクトル化できる
+            \param x 単位ベクトルのx成分の配列
+            \param y 単位ベクトルのy成分の配列
+            \param z 単位ベクトルのz成分の配列
+            \param ylm 実関数表示の球面調和関数の値を格納する配列
+            \param n 配列の要素数
+        */
+        void operator()(double const * x, double const * y, double const * z, double * ylm, std::size_t n) const;
+
+        //! A public member function (const).
+        /*!
+            実関数表示の球面調和関数の値と、それを(x, y, z)の多項式とみなしたときの勾配を求める
+            単位球面上の勾配は、この勾配から動径方向の成分を除いたものになる
+            \param x 単位ベクトルのx成分
+            \param y 単位ベクトルのy成分
+            \param z 単位ベクトルのz成分
+            \param grad 勾配を格納する配列
+            \return 実関数表示の球面調和関数の値
+        */
+        double Gradient(double x, double y, double z, std::array<double, 3> & grad) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A public static member variable (constant expression).
+        /*!
+            対応する方位量子数の最大値
+        */
+        static std::int32_t constexpr LMAX = 10;
+
+    private:
+        //! A private member variable (constant expression).
+        /*!
+            まとめて評価するときに、一度に処理する要素数
+        */
+        static std::size_t constexpr BLOCKSIZE = 16;
+
+        //! A private member variable.
+        /*!
+            漸化式のzの係数 (2k - 1) / (k - |m|)
+        */
+        std::array<double, LMAX + 1> c1_{};
+
+        //! A private member variable.
+        /*!
+            漸化式の2つ前の項の係数 (k + |m| - 1) / (k - |m|)
+        */
+        std::array<double, LMAX + 1> c2_{};
+
+        //! A private member variable.
+        /*!
+            方位量子数
+        */
+        std::int32_t l_;
+
+        //! A private member variable.
+        /*!
+            磁気量子数
+        */
+        std::int32_t m_;
+
+        //! A private member variable.
+        /*!
+            規格化定数（(2|m| - 1)!!と、m ≠ 0のときの√2を含む）
+        */
+        double norm_;
+
+        // #endregion メンバ変数
+    };
+
+    // #region メンバ関数
+
+    inline double RealYlm::operator()(double x, double y, double z) const
+    {
+        auto const am = m_ >= 0 ? m_ : -m_;
+
+        // Re((x + iy)^|m|)、Im((x + iy)^|m|) = sin^|m|θ cos(|m|φ)、sin^|m|θ sin(|m|φ)
+        auto c = 1.0;
+        auto s = 0.0;
+        for (auto i = 0; i < am; i++) {
+            auto const ctmp = c * x - s * y;
+            s = c * y + s * x;
+            c = ctmp;
+        }
+
+        // P_l^|m|(z) / sin^|m|θ を漸化式で求める
+        auto qkm2 = 0.0;
+        auto qkm1 = 1.0;
+        for (auto k = am + 1; k <= l_; k++) {
+            auto const qk = c1_[k] * z * qkm1 - c2_[k] * qkm2;
+            qkm2 = qkm1;
+            qkm1 = qk;
+        }
+
+        return norm_ * qkm1 * (m_ > 0 ? c : (m_ < 0 ? s : 1.0));
+    }
+
+    inline double RealYlm::Gradient(double x, double y, double z, std::array<double, 3> & grad) const
+    {
+        auto const am = m_ >= 0 ? m_ : -m_;
+
+        // (x + iy)^(|m| - 1)を求めてから(x + iy)^|m|を求める
+        auto cm1 = 1.0;
+        auto sm1 = 0.0;
+        for (auto i = 1; i < am; i++) {
+            auto const ctmp = cm1 * x - sm1 * y;
+            sm1 = cm1 * y + sm1 * x;
+            cm1 = ctmp;
+        }
+        auto const c = am ? cm1 * x - sm1 * y : 1.0;
+        auto const s = am ? cm1 * y + sm1 * x : 0.0;
+
+        // Q_k(z)とその導関数Q'_k(z)を同時に漸化式で求める
+        auto qkm2 = 0.0;
+        auto qkm1 = 1.0;
+        auto dqkm2 = 0.0;
+        auto dqkm1 = 0.0;
+        for (auto k = am + 1; k <= l_; k++) {
+            auto const qk = c1_[k] * z * qkm1 - c2_[k] * qkm2;
+            auto const dqk = c1_[k] * (qkm1 + z * dqkm1) - c2_[k] * dqkm2;
+            qkm2 = qkm1;
+            qkm1 = qk;
+            dqkm2 = dqkm1;
+            dqkm1 = dqk;
+        }
+
+        // ∂Re(w^|m|)/∂x = |m|Re(w^(|m| - 1))、∂Re(w^|m|)/∂y = -|m|Im(w^(|m| - 1))
+        // ∂Im(w^|m|)/∂x = |m|Im(w^(|m| - 1))、∂Im(w^|m|)/∂y = |m|Re(w^(|m| - 1))
+        auto const dam = static_cast<double>(am);
+        auto const a = m_ > 0 ? c : (m_ < 0 ? s : 1.0);
+        auto const dadx = m_ > 0 ? dam * cm1 : (m_ < 0 ? dam * sm1 : 0.0);
+        auto const dady = m_ > 0 ? -dam * sm1 : (m_ < 0 ? dam * cm1 : 0.0);
+
+        grad[0] = norm_ * qkm1 * dadx;
+        grad[1] = norm_ * qkm1 * dady;
+        grad[2] = norm_ * dqkm1 * a;
+
+        return norm_ * qkm1 * a;
+    }
+
+    // #endregion メンバ関数
+}
+
+#endif  // _REALYLM_H_
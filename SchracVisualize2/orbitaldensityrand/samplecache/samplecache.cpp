@@ -0,0 +1,169 @@
+﻿/*! \file samplecache.cpp
+    \brief 生成した点群をファイルに保存し、メモリマップで再利用するキャッシュクラスの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "samplecache.h"
+#include <algorithm>                                // for std::sort
+#include <cstdio>                                   // for std::snprintf
+#include <cstring>                                  // for std::memcmp, std::memcpy
+#include <fstream>                                  // for std::ifstream, std::ofstream
+#include <system_error>                             // for std::error_code
+#include <tuple>                                    // for std::tuple
+#include <vector>                                   // for std::vector
+#include <boost/interprocess/file_mapping.hpp>      // for boost::interprocess::file_mapping
+
+namespace samplecache {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            キャッシュのファイルの種類を表す文字列（最後の文字は形式の版）
+        */
+        static char const MAGIC[8] = { 'S', 'V', '2', 'C', 'A', 'C', 'H', '1' };
+    }
+
+    // #region コンストラクタ
+
+    SampleCache::SampleCache(std::filesystem::path const & dir, std::uintmax_t maxbytes)
+        :   Hits([this] { return hits_; }, nullptr),
+            Misses([this] { return misses_; }, nullptr),
+            dir_(dir),
+            maxbytes_(maxbytes)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(dir_, ec);
+    }
+
+    // #endregion コンストラクタ
+
+    // #region publicメンバ関数
+
+    SampleCache::region_ptr SampleCache::Find(std::uint64_t key, std::size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        auto const path = Path(key);
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec)) {
+            misses_++;
+            return nullptr;
+        }
+
+        // ヘッダとファイルの大きさが合わなければ、壊れたファイルとして消す
+        Header header;
+        {
+            std::ifstream ifs(path, std::ios::binary);
+            if (!ifs.read(reinterpret_cast<char *>(&header), sizeof(Header)) ||
+                std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) || header.key != key || header.bytes != bytes ||
+                std::filesystem::file_size(path, ec) != sizeof(Header) + bytes) {
+                ifs.close();
+                std::filesystem::remove(path, ec);
+                misses_++;
+                return nullptr;
+            }
+        }
+
+        try {
+            // ヘッダの後ろの頂点の配列だけをマップする（コピーしない）
+            boost::interprocess::file_mapping const fm(path.string().c_str(), boost::interprocess::read_only);
+            auto region = std::make_unique<boost::interprocess::mapped_region>(fm, boost::interprocess::read_only, sizeof(Header), bytes);
+
+            // 最終使用時刻として更新時刻を今にする
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+
+            hits_++;
+            return region;
+        }
+        catch (boost::interprocess::interprocess_exception const &) {
+            misses_++;
+            return nullptr;
+        }
+    }
+
+    void SampleCache::Store(std::uint64_t key, void const * data, std::size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        if (sizeof(Header) + bytes > maxbytes_) {
+            return;
+        }
+
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.key = key;
+        header.bytes = bytes;
+
+        // 書きかけのファイルが見つからないよう、一時ファイルに書いてから名前を変える
+        auto const path = Path(key);
+        auto tmppath = path;
+        tmppath += ".tmp";
+
+        std::error_code ec;
+        {
+            std::ofstream ofs(tmppath, std::ios::binary);
+            if (!ofs.write(reinterpret_cast<char const *>(&header), sizeof(Header)) ||
+                !ofs.write(static_cast<char const *>(data), static_cast<std::streamsize>(bytes))) {
+                ofs.close();
+                std::filesystem::remove(tmppath, ec);
+                return;
+            }
+        }
+
+        std::filesystem::rename(tmppath, path, ec);
+        if (ec) {
+            std::filesystem::remove(tmppath, ec);
+            return;
+        }
+
+        Evict(path);
+    }
+
+    // #endregion publicメンバ関数
+
+    // #region privateメンバ関数
+
+    void SampleCache::Evict(std::filesystem::path const & keep)
+    {
+        std::error_code ec;
+        std::vector<std::tuple<std::filesystem::file_time_type, std::uintmax_t, std::filesystem::path>> files;
+        std::uintmax_t total = 0;
+
+        for (auto const & entry : std::filesystem::directory_iterator(dir_, ec)) {
+            if (entry.path().extension() != EXTENSION) {
+                continue;
+            }
+
+            auto const size = entry.file_size(ec);
+            if (ec) {
+                continue;
+            }
+
+            files.emplace_back(entry.last_write_time(ec), size, entry.path());
+            total += size;
+        }
+
+        std::sort(files.begin(), files.end());
+
+        // マップ中で消せないファイル（Windows）は飛ばす
+        for (auto const & [time, size, path] : files) {
+            if (total <= maxbytes_) {
+                break;
+            }
+
+            if (path != keep && std::filesystem::remove(path, ec)) {
+                total -= size;
+            }
+        }
+    }
+
+    std::filesystem::path SampleCache::Path(std::uint64_t key) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+
+        return dir_ / (std::string(name) + EXTENSION);
+    }
+
+    // #endregion privateメンバ関数
+}
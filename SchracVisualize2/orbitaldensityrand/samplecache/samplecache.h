@@ -0,0 +1,214 @@
+﻿/*! \file samplecache.h
+    \brief 生成した点群をファイルに保存し、メモリマップで再利用するキャッシュクラスの宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _SAMPLECACHE_H_
+#define _SAMPLECACHE_H_
+
+#pragma once
+
+#include "../utility/property.h"
+#include <cstddef>                                  // for std::size_t
+#include <cstdint>                                  // for std::int32_t, std::uint64_t, std::uintmax_t
+#include <filesystem>                               // for std::filesystem::path
+#include <memory>                                   // for std::unique_ptr
+#include <mutex>                                    // for std::mutex
+#include <boost/interprocess/mapped_region.hpp>     // for boost::interprocess::mapped_region
+
+namespace samplecache {
+    //! A class.
+    /*!
+        生成した点群をファイルに保存し、メモリマップで再利用するキャッシュクラス
+        キーごとに1個のファイル（ヘッダと頂点の配列）を作り、合計の大きさが上限を超えたら最終使用時刻（更新時刻）の古いものから消す
+    */
+    class SampleCache final {
+        // #region 型エイリアス
+
+    public:
+        using region_ptr = std::unique_ptr<boost::interprocess::mapped_region>;
+
+        // #endregion 型エイリアス
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param dir キャッシュのファイルを置くディレクトリ（なければ作る）
+            \param maxbytes キャッシュのファイルの合計の大きさの上限（バイト）
+        */
+        SampleCache(std::filesystem::path const & dir, std::uintmax_t maxbytes);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~SampleCache() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            キャッシュを探し、見つかれば頂点の配列の部分を読み取り専用でメモリマップする
+            \param key キー
+            \param bytes 頂点の配列のバイト数
+            \return 頂点の配列をマップした領域（見つからなければnullptr）
+        */
+        region_ptr Find(std::uint64_t key, std::size_t bytes);
+
+        //! A public member function.
+        /*!
+            頂点の配列をキャッシュに保存し、上限を超えた分を古いものから消す
+            \param key キー
+            \param data 頂点の配列の先頭
+            \param bytes 頂点の配列のバイト数
+        */
+        void Store(std::uint64_t key, void const * data, std::size_t bytes);
+
+    private:
+        //! A private member function.
+        /*!
+            合計の大きさが上限を超えている間、最終使用時刻の古いファイルから消す
+            \param keep 消さないファイル
+        */
+        void Evict(std::filesystem::path const & keep);
+
+        //! A private member function.
+        /*!
+            キーに対応するファイルのパスを返す
+            \param key キー
+            \return ファイルのパス
+        */
+        std::filesystem::path Path(std::uint64_t key) const;
+
+        // #endregion メンバ関数
+
+        // #region プロパティ
+
+    public:
+        //! A property.
+        /*!
+            キャッシュが見つかった回数へのプロパティ
+        */
+        utility::Property<std::int32_t> const Hits;
+
+        //! A property.
+        /*!
+            キャッシュが見つからなかった回数へのプロパティ
+        */
+        utility::Property<std::int32_t> const Misses;
+
+        // #endregion プロパティ
+
+        // #region メンバ変数
+
+        //! A public static member variable (constant expression).
+        /*!
+            ファイルの拡張子
+        */
+        static constexpr char const * EXTENSION = ".sv2c";
+
+        //! A public static member variable (constant expression).
+        /*!
+            キャッシュのファイルの合計の大きさの上限の初期値（2GiB）
+        */
+        static std::uintmax_t constexpr MAXBYTES_INIT_VALUE = std::uintmax_t(2) << 30;
+
+    private:
+        //! A struct.
+        /*!
+            キャッシュのファイルのヘッダ
+        */
+        struct Header {
+            //! A public member variable.
+            /*!
+                ファイルの種類を表す文字列
+            */
+            char magic[8];
+
+            //! A public member variable.
+            /*!
+                キー
+            */
+            std::uint64_t key;
+
+            //! A public member variable.
+            /*!
+                頂点の配列のバイト数
+            */
+            std::uint64_t bytes;
+
+            //! A public member variable.
+            /*!
+                予約（0）
+            */
+            std::uint64_t reserved[5];
+        };
+
+        static_assert(sizeof(Header) == 64, "Headerの大きさが異常です");
+
+        //! A private member variable (constant).
+        /*!
+            キャッシュのファイルを置くディレクトリ
+        */
+        std::filesystem::path const dir_;
+
+        //! A private member variable.
+        /*!
+            キャッシュが見つかった回数
+        */
+        std::int32_t hits_ = 0;
+
+        //! A private member variable (constant).
+        /*!
+            キャッシュのファイルの合計の大きさの上限（バイト）
+        */
+        std::uintmax_t const maxbytes_;
+
+        //! A private member variable.
+        /*!
+            キャッシュが見つからなかった回数
+        */
+        std::int32_t misses_ = 0;
+
+        //! A private member variable.
+        /*!
+            ファイルの操作を保護するミューテックス
+        */
+        std::mutex mtx_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A public constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        SampleCache() = delete;
+
+        //! A public copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        SampleCache(SampleCache const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        SampleCache & operator=(SampleCache const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _SAMPLECACHE_H_
@@ -0,0 +1,101 @@
+﻿/*! \file chainstate.h
+    \brief マルコフ連鎖の状態と、採択数・提案数を数える構造体の宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _CHAINSTATE_H_
+#define _CHAINSTATE_H_
+
+#pragma once
+
+#include <array>    // for std::array
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint64_t
+
+namespace sampler {
+    //! A struct.
+    /*!
+        メトロポリス・ヘイスティングス法で採択された提案と、全ての提案の数
+    */
+    struct AcceptanceCount final {
+        //! A public member variable.
+        /*!
+            採択された提案の数
+        */
+        std::uint64_t accepted = 0;
+
+        //! A public member variable.
+        /*!
+            提案の数（まだ有効な点にいないチェーンの提案は数えない）
+        */
+        std::uint64_t proposed = 0;
+
+        //! A public member variable.
+        /*!
+            交換モンテカルロ法で採択された交換の数
+        */
+        std::uint64_t swapaccepted = 0;
+
+        //! A public member variable.
+        /*!
+            交換モンテカルロ法で試みた交換の数
+        */
+        std::uint64_t swapproposed = 0;
+    };
+
+    //! A struct (template).
+    /*!
+        K本のマルコフ連鎖の現在の状態
+        \tparam K チェーン数
+    */
+    template <std::size_t K>
+    struct ChainState final {
+        //! A public constructor.
+        /*!
+            全てのチェーンを原点（まだ有効な点にいない状態）に置く
+        */
+        ChainState()
+        {
+            sign.fill(1.0f);
+        }
+
+        //! A public member variable.
+        /*!
+            採択数と提案数
+        */
+        AcceptanceCount count;
+
+        //! A public member variable.
+        /*!
+            各チェーンの現在の点での波動関数（電子密度）の符号
+        */
+        std::array<float, K> sign;
+
+        //! A public member variable.
+        /*!
+            各チェーンの現在の点での波動関数（電子密度）の値（0はまだ有効な点にいないことを表す）
+        */
+        std::array<double, K> val{};
+
+        //! A public member variable.
+        /*!
+            各チェーンの現在のx座標
+        */
+        std::array<double, K> x{};
+
+        //! A public member variable.
+        /*!
+            各チェーンの現在のy座標
+        */
+        std::array<double, K> y{};
+
+        //! A public member variable.
+        /*!
+            各チェーンの現在のz座標
+        */
+        std::array<double, K> z{};
+    };
+}
+
+#endif  // _CHAINSTATE_H_
@@ -0,0 +1,33 @@
+﻿/*! \file chainstep.cpp
+    \brief マルコフ連鎖を1ステップずつ進める関数のうち、テンプレートでないものの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "chainstep.h"
+
+namespace sampler {
+    std::array<double, 3> Drift(double r, double ux, double uy, double uz, double dlogrdr, double ylmval, std::array<double, 3> const & grad, double angularpower)
+    {
+        // ∇ψ/ψ = (R'(r)/R(r))û + (I - ûû^T)∇Y/(rY)
+        auto const ugrad = ux * grad[0] + uy * grad[1] + uz * grad[2];
+        auto const ry = r * ylmval;
+
+        return {
+            dlogrdr * ux + angularpower * (grad[0] - ugrad * ux) / ry,
+            dlogrdr * uy + angularpower * (grad[1] - ugrad * uy) / ry,
+            dlogrdr * uz + angularpower * (grad[2] - ugrad * uz) / ry
+        };
+    }
+
+    std::array<double, 3> Truncate_gradient(std::array<double, 3> const & grad, double limit)
+    {
+        auto const norm = std::sqrt(grad[0] * grad[0] + grad[1] * grad[1] + grad[2] * grad[2]);
+        if (norm <= limit) {
+            return grad;
+        }
+
+        auto const scale = limit / norm;
+        return { grad[0] * scale, grad[1] * scale, grad[2] * scale };
+    }
+}
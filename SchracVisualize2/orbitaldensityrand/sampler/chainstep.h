@@ -0,0 +1,290 @@
+﻿/*! \file chainstep.h
+    \brief マルコフ連鎖を1ステップずつ進める関数（メトロポリス・ヘイスティングス法、MALA、交換モンテカルロ法の交換）の宣言と実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _CHAINSTEP_H_
+#define _CHAINSTEP_H_
+
+#pragma once
+
+#include "chainstate.h"
+#include "../getdata/radialtable.h"
+#include "../myrandom/myrandsfmt.h"
+#include "../realylm/realylm.h"
+#include <algorithm>    // for std::max, std::min
+#include <array>        // for std::array
+#include <cmath>        // for std::exp, std::fabs, std::pow, std::sqrt
+#include <cstddef>      // for std::size_t
+#include <utility>      // for std::swap
+
+namespace sampler {
+    //! A global variable (constant expression).
+    /*!
+        MALAで、勾配の大きさを打ち切る上限の、σの逆数に対する倍率
+    */
+    static auto constexpr GRADIENTLIMIT = 2.0;
+
+    //! A global variable (constant expression).
+    /*!
+        0の判定に使う閾値
+    */
+    static auto constexpr THRESHOLD = 1.0E-15;
+
+    //! A function.
+    /*!
+        単位ベクトルû方向の距離rの点で、ドリフト a(R'(r)/R(r))û + b(I - ûû^T)∇Y/(rY) を求める
+        ネルソンの確率力学（a = b = 1で∇log|ψ|）と、MALA（目標の分布の対数の勾配）で共有する
+        \param r 原点からの距離
+        \param ux 動径方向の単位ベクトルのx成分
+        \param uy 動径方向の単位ベクトルのy成分
+        \param uz 動径方向の単位ベクトルのz成分
+        \param dlogrdr 動径部分の対数微分R'(r)/R(r)に係数aを掛けたもの
+        \param ylmval 実関数表示の球面調和関数の値
+        \param grad 実関数表示の球面調和関数の勾配（RealYlm::Gradientの結果）
+        \param angularpower 角度部分の係数b
+        \return ドリフト
+    */
+    std::array<double, 3> Drift(double r, double ux, double uy, double uz, double dlogrdr, double ylmval, std::array<double, 3> const & grad, double angularpower);
+
+    //! A function.
+    /*!
+        勾配の大きさをlimitで打ち切る（節の近くでは∇log pが発散し、提案点が遠くに飛んで棄却され続けるのを防ぐ）
+        打ち切った勾配を提案だけに使い、採択率は正しく補正するので、目標の分布は変わらない
+        \param grad 勾配
+        \param limit 勾配の大きさの上限
+        \return 打ち切った勾配
+    */
+    std::array<double, 3> Truncate_gradient(std::array<double, 3> const & grad, double limit);
+
+    //! A function (template function).
+    /*!
+        点(x, y, z)での、目標の分布 p ∝ val^2 の値のもとになるval（メトロポリス・ヘイスティングス法と同じ）とlog pの勾配を求める
+        \tparam WF 波動関数のデータかどうか（falseなら電子密度）
+        \param x 点のx座標
+        \param y 点のy座標
+        \param z 点のz座標
+        \param ylm 実関数表示の球面調和関数
+        \param table 動径関数の3次スプラインの係数表
+        \param grad log pの勾配を格納する配列
+        \return val（メッシュの範囲外か、ほぼ0なら0）
+    */
+    template <bool WF>
+    double Log_gradient(double x, double y, double z, realylm::RealYlm const & ylm, getdata::RadialTable const & table, std::array<double, 3> & grad)
+    {
+        auto const r = std::sqrt(x * x + y * y + z * z);
+
+        // メッシュの範囲外の点は確率0とする
+        if (r < table.R_mesh().front() || r > table.R_mesh().back()) {
+            grad.fill(0.0);
+            return 0.0;
+        }
+
+        auto const ux = x / r;
+        auto const uy = y / r;
+        auto const uz = z / r;
+
+        std::array<double, 3> ylmgrad;
+        auto const ylmval = ylm.Gradient(ux, uy, uz, ylmgrad);
+
+        double radial, dradial;
+        table(&r, &radial, &dradial, 1);
+
+        auto const val = WF ? radial * ylmval : radial * ylmval * ylmval;
+        if (std::fabs(val) < THRESHOLD) {
+            grad.fill(0.0);
+            return 0.0;
+        }
+
+        // log p = 2log|R| + 2log|Y|（電子密度では2log|R| + 4log|Y|）なので、ネルソンの確率力学のドリフトの係数を変えたものになる
+        grad = Drift(r, ux, uy, uz, 2.0 * dradial / radial, ylmval, ylmgrad, WF ? 2.0 : 4.0);
+        return val;
+    }
+
+    //! A function (template function).
+    /*!
+        K本のマルコフ連鎖を、ランジュバン方程式を時間刻みh = σ^2で1ステップ進めた点 x + (h / 2)∇log p(x) + σξ を提案として1ステップずつ進める（MALA）
+        提案分布が非対称なので、採択率にはq(x_t|x*) / q(x*|x_t)も掛ける
+        \tparam K チェーン数
+        \tparam WF 波動関数のデータかどうか（falseなら電子密度）
+        \param state チェーンの状態（採択数と提案数も数える）
+        \param grad 各チェーンの現在の点でのlog pの勾配（x成分、y成分、z成分の順にK個ずつ、採択されれば更新する）
+        \param mr 乱数生成器
+        \param ylm 実関数表示の球面調和関数
+        \param table 動径関数の3次スプラインの係数表
+        \param sigma ランダムな移動の標準偏差σ
+    */
+    template <std::size_t K, bool WF>
+    void Langevin_step(ChainState<K> & state, std::array<double, 3 * K> & grad, myrandom::MyRandSfmt & mr, realylm::RealYlm const & ylm,
+        getdata::RadialTable const & table, double sigma)
+    {
+        auto const h = sigma * sigma;
+        auto const limit = GRADIENTLIMIT / sigma;
+
+        std::array<double, 3 * K> gauss;
+        std::array<double, K> ar;
+        mr.normal_distribution_rand(gauss.data(), 3 * K);
+        mr.myrand(ar.data(), K);
+
+        for (auto k = 0U; k < K; k++) {
+            // まだ有効な点にいないチェーンは勾配が分からないので、最初に有効な点に移るまでドリフトなしで動かす
+            auto const valid = state.val[k] != 0.0;
+            std::array<double, 3> const x = { state.x[k], state.y[k], state.z[k] };
+            auto const g = Truncate_gradient({ grad[k], grad[K + k], grad[2 * K + k] }, limit);
+
+            std::array<double, 3> x_star, g_star;
+            for (auto d = 0U; d < 3; d++) {
+                x_star[d] = x[d] + (valid ? 0.5 * h * g[d] : 0.0) + sigma * gauss[d * K + k];
+            }
+
+            auto const val_star = Log_gradient<WF>(x_star[0], x_star[1], x_star[2], ylm, table, g_star);
+            auto accepted = val_star != 0.0;
+
+            if (valid) {
+                // α = p(x*)q(x_t|x*) / (p(x_t)q(x*|x_t))、q(a|b) ∝ exp(-|a - b - (h / 2)∇log p(b)|^2 / (2h))（∇log p(b)は打ち切ったもの）
+                auto const gt_star = Truncate_gradient(g_star, limit);
+                auto forward = 0.0;
+                auto backward = 0.0;
+                for (auto d = 0U; d < 3; d++) {
+                    auto const f = x_star[d] - x[d] - 0.5 * h * g[d];
+                    auto const b = x[d] - x_star[d] - 0.5 * h * gt_star[d];
+                    forward += f * f;
+                    backward += b * b;
+                }
+
+                auto const alpha = (val_star * val_star) / (state.val[k] * state.val[k]) * std::exp((forward - backward) / (2.0 * h));
+                accepted = accepted && ar[k] <= alpha;
+
+                state.count.proposed++;
+                state.count.accepted += accepted ? 1 : 0;
+            }
+
+            if (accepted) {
+                state.x[k] = x_star[0];
+                state.y[k] = x_star[1];
+                state.z[k] = x_star[2];
+                state.val[k] = val_star;
+                state.sign[k] = val_star >= 0.0 ? 1.0f : -1.0f;
+                grad[k] = g_star[0];
+                grad[K + k] = g_star[1];
+                grad[2 * K + k] = g_star[2];
+            }
+        }
+    }
+
+    //! A function (template function).
+    /*!
+        K本のマルコフ連鎖を、等方的な正規分布を提案分布とするメトロポリス・ヘイスティングス法で1ステップずつ進める
+        k番目のチェーンは|ψ|^(2β_k)に従う（β_k = 1なら通常のメトロポリス・ヘイスティングス法）
+        \tparam K チェーン数
+        \tparam WF 波動関数のデータかどうか（falseなら電子密度）
+        \param state チェーンの状態（採択数と提案数も数える）
+        \param mr 乱数生成器
+        \param ylm 実関数表示の球面調和関数
+        \param table 動径関数の3次スプラインの係数表
+        \param sigma 各チェーンの提案分布の標準偏差
+        \param beta 各チェーンの逆温度
+    */
+    template <std::size_t K, bool WF>
+    void Metropolis_step(ChainState<K> & state, myrandom::MyRandSfmt & mr, realylm::RealYlm const & ylm, getdata::RadialTable const & table,
+        std::array<double, K> const & sigma, std::array<double, K> const & beta)
+    {
+        auto const rmin = table.R_mesh().front();
+        auto const rmax = table.R_mesh().back();
+
+        // 提案された座標と、そこでの動径部分・角度部分の値
+        std::array<double, K> x_star, y_star, z_star, r, rc, ux, uy, uz, radial, angular, val_star;
+
+        // 1ステップ分の正規乱数と一様乱数
+        std::array<double, 3 * K> gauss;
+        std::array<double, K> ar;
+
+        // 提案分布 q(x*|x_t) から x* をサンプリング
+        mr.normal_distribution_rand(gauss.data(), 3 * K);
+        for (auto k = 0U; k < K; k++) {
+            x_star[k] = state.x[k] + sigma[k] * gauss[k];
+            y_star[k] = state.y[k] + sigma[k] * gauss[K + k];
+            z_star[k] = state.z[k] + sigma[k] * gauss[2 * K + k];
+        }
+
+        for (auto k = 0U; k < K; k++) {
+            r[k] = std::sqrt(x_star[k] * x_star[k] + y_star[k] * y_star[k] + z_star[k] * z_star[k]);
+            rc[k] = std::min(std::max(r[k], rmin), rmax);
+            ux[k] = x_star[k] / rc[k];
+            uy[k] = y_star[k] / rc[k];
+            uz[k] = z_star[k] / rc[k];
+        }
+
+        table(rc.data(), radial.data(), K);
+        ylm(ux.data(), uy.data(), uz.data(), angular.data(), K);
+
+        // メッシュの範囲外の点は確率0として棄却する
+        for (auto k = 0U; k < K; k++) {
+            auto const v = WF ? radial[k] * angular[k] : radial[k] * angular[k] * angular[k];
+            val_star[k] = r[k] >= rmin && r[k] <= rmax ? v : 0.0;
+        }
+
+        // 採択率 α = (p(x*) / p(x_t))^β により決定（β = 1ならpowを呼ばないので、通常のメトロポリス・ヘイスティングス法の結果は変わらない）
+        mr.myrand(ar.data(), K);    // 0 <= ar <= 1 の一様乱数 ar を生成
+        for (auto k = 0U; k < K; k++) {
+            auto const ratio = (val_star[k] * val_star[k]) / (state.val[k] * state.val[k]);
+            auto const alpha = beta[k] == 1.0 ? ratio : std::pow(ratio, beta[k]);
+            auto const accepted = ar[k] <= alpha;
+
+            // まだ有効な点にいないチェーンは、最初に有効な点に移るまで数えない
+            if (state.val[k] != 0.0) {
+                state.count.proposed++;
+                state.count.accepted += accepted ? 1 : 0;
+            }
+
+            if (accepted) {
+                state.x[k] = x_star[k];
+                state.y[k] = y_star[k];
+                state.z[k] = z_star[k];
+                state.val[k] = val_star[k];
+                state.sign[k] = val_star[k] >= 0.0 ? 1.0f : -1.0f;
+            }
+        }
+    }
+
+    //! A function (template function).
+    /*!
+        K本のチェーンの梯子で、隣り合うチェーンの状態の交換をmin(1, (p_{k+1} / p_k)^(β_k - β_{k+1}))の確率で採択する
+        parityが0なら(0, 1), (2, 3), ...の組、1なら(1, 2), (3, 4), ...の組で試みる（交互に呼ぶ）
+        \tparam K チェーン数
+        \param state チェーンの状態（交換の採択数と試行数も数える）
+        \param mr 乱数生成器
+        \param beta 各チェーンの逆温度
+        \param parity 交換を試みる組の偶奇
+    */
+    template <std::size_t K>
+    void Swap_step(ChainState<K> & state, myrandom::MyRandSfmt & mr, std::array<double, K> const & beta, std::size_t parity)
+    {
+        // 試みる組の数によらず同じ数の乱数を使う
+        std::array<double, K> ar;
+        mr.myrand(ar.data(), K);
+
+        for (auto k = parity; k + 1 < K; k += 2) {
+            // まだ有効な点にいないチェーンとは交換しない
+            if (state.val[k] == 0.0 || state.val[k + 1] == 0.0) {
+                continue;
+            }
+
+            auto const ratio = (state.val[k + 1] * state.val[k + 1]) / (state.val[k] * state.val[k]);
+            auto const accepted = ar[k] <= std::pow(ratio, beta[k] - beta[k + 1]);
+
+            state.count.swapproposed++;
+            if (accepted) {
+                state.count.swapaccepted++;
+                std::swap(state.x[k], state.x[k + 1]);
+                std::swap(state.y[k], state.y[k + 1]);
+                std::swap(state.z[k], state.z[k + 1]);
+                std::swap(state.val[k], state.val[k + 1]);
+                std::swap(state.sign[k], state.sign[k + 1]);
+            }
+        }
+    }
+}
+
+#endif  // _CHAINSTEP_H_
@@ -0,0 +1,113 @@
+﻿/*! \file steptuner.cpp
+    \brief 磁気量子数ごとにマルコフ連鎖の提案分布の標準偏差を調整して残すクラスの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "chainstep.h"
+#include "steptuner.h"
+#include "../myrandom/myrandsfmt.h"
+#include "../realylm/realylm.h"
+#include <array>    // for std::array
+#include <cmath>    // for std::exp, std::log, std::sqrt
+
+namespace sampler {
+    // #region コンストラクタ
+
+    StepTuner::StepTuner(std::shared_ptr<getdata::GetData> const & pgd)
+        : pgd_(pgd)
+    {
+    }
+
+    // #endregion コンストラクタ
+
+    // #region publicメンバ関数
+
+    double StepTuner::Sigma(std::int32_t m)
+    {
+        // 先読みのスレッドからも呼ばれるので、ロックして調整する
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto const it = sigmas_.find(m);
+        if (it != sigmas_.end()) {
+            return it->second;
+        }
+
+        auto const sigma = pgd_->Rho_wf_type == getdata::GetData::Rho_Wf_type::WF ? Tune_sigma<true>(m) : Tune_sigma<false>(m);
+        sigmas_.emplace(m, sigma);
+        return sigma;
+    }
+
+    double StepTuner::Step(std::int32_t m)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto const it = steps_.find(m);
+        if (it != steps_.end()) {
+            return it->second;
+        }
+
+        auto const step = pgd_->Rho_wf_type == getdata::GetData::Rho_Wf_type::WF ? Tune_step<true>(m) : Tune_step<false>(m);
+        steps_.emplace(m, step);
+        return step;
+    }
+
+    // #endregion publicメンバ関数
+
+    // #region privateメンバ関数
+
+    template <bool WF>
+    double StepTuner::Tune_sigma(std::int32_t m) const
+    {
+        myrandom::MyRandSfmt mr(0U, TUNESTREAM);
+        realylm::RealYlm const ylm(static_cast<std::int32_t>(pgd_->L), m);
+        auto const & table = pgd_->Radial_table();
+
+        // 以前の固定値（R2rhomaxrの平方根）から始め、log σを採択率と目標の差に比例して動かす
+        // 歩幅を1 / √(回数)で小さくしていくので、最後の方はほとんど動かない
+        auto logsigma = std::log(std::sqrt(pgd_->R2rhomaxr()));
+        ChainState<CHAINS> state;
+        std::array<double, CHAINS> sigma, beta;
+        beta.fill(1.0);
+        for (auto round = 0; round < TUNEROUNDS; round++) {
+            sigma.fill(std::exp(logsigma));
+            state.count = AcceptanceCount();
+            for (auto step = 0; step < TUNESTEPS; step++) {
+                Metropolis_step<CHAINS, WF>(state, mr, ylm, table, sigma, beta);
+            }
+
+            if (state.count.proposed) {
+                auto const rate = static_cast<double>(state.count.accepted) / static_cast<double>(state.count.proposed);
+                logsigma += (rate - TARGETACCEPTANCE) / std::sqrt(static_cast<double>(round + 1));
+            }
+        }
+
+        return std::exp(logsigma);
+    }
+
+    template <bool WF>
+    double StepTuner::Tune_step(std::int32_t m) const
+    {
+        myrandom::MyRandSfmt mr(0U, TUNESTREAM);
+        realylm::RealYlm const ylm(static_cast<std::int32_t>(pgd_->L), m);
+        auto const & table = pgd_->Radial_table();
+
+        auto logstep = std::log(std::sqrt(pgd_->R2rhomaxr()));
+        ChainState<CHAINS> state;
+        std::array<double, 3 * CHAINS> grad{};
+        for (auto round = 0; round < TUNEROUNDS; round++) {
+            state.count = AcceptanceCount();
+            for (auto step = 0; step < TUNESTEPS; step++) {
+                Langevin_step<CHAINS, WF>(state, grad, mr, ylm, table, std::exp(logstep));
+            }
+
+            if (state.count.proposed) {
+                auto const rate = static_cast<double>(state.count.accepted) / static_cast<double>(state.count.proposed);
+                logstep += (rate - MALAACCEPTANCE) / std::sqrt(static_cast<double>(round + 1));
+            }
+        }
+
+        return std::exp(logstep);
+    }
+
+
+    // #endregion privateメンバ関数
+}
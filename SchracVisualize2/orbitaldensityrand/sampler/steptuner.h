@@ -0,0 +1,178 @@
+﻿/*! \file steptuner.h
+    \brief 磁気量子数ごとにマルコフ連鎖の提案分布の標準偏差を調整して残すクラスの宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _STEPTUNER_H_
+#define _STEPTUNER_H_
+
+#pragma once
+
+#include "../getdata/getdata.h"
+#include <cstdint>  // for std::int32_t, std::uint64_t
+#include <limits>   // for std::numeric_limits
+#include <map>      // for std::map
+#include <memory>   // for std::shared_ptr
+#include <mutex>    // for std::mutex
+
+namespace sampler {
+    //! A class.
+    /*!
+        メトロポリス・ヘイスティングス法の提案分布の標準偏差とMALAのσを、磁気量子数ごとに調整して残すクラス
+        先読みのスレッドからも使うので、publicメンバ関数は中でロックする
+    */
+    class StepTuner final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param pgd データオブジェクト
+        */
+        explicit StepTuner(std::shared_ptr<getdata::GetData> const & pgd);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~StepTuner() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            磁気量子数mの軌道について調整した提案分布の標準偏差を返す（初めて使うmなら調整して残しておく）
+            \param m 磁気量子数
+            \return 提案分布の標準偏差
+        */
+        double Sigma(std::int32_t m);
+
+        //! A public member function.
+        /*!
+            磁気量子数mの軌道について調整したMALAのσを返す（初めて使うmなら調整して残しておく）
+            \param m 磁気量子数
+            \return MALAのσ
+        */
+        double Step(std::int32_t m);
+
+    private:
+        //! A private member function (template function).
+        /*!
+            提案分布の標準偏差を、採択率がTARGETACCEPTANCEに近づくように調整する（Robbins-Monro法）
+            シードによらない乱数列で、R2rhomaxrの平方根から始めてTUNEROUNDS回調整し、その後は固定する
+            \tparam WF 波動関数のデータかどうか（falseなら電子密度）
+            \param m 磁気量子数
+            \return 調整した提案分布の標準偏差
+        */
+        template <bool WF>
+        double Tune_sigma(std::int32_t m) const;
+
+        //! A private member function (template function).
+        /*!
+            MALAのσを、採択率がMALAACCEPTANCEに近づくようにTune_sigmaと同じ方法で調整する
+            \tparam WF 波動関数のデータかどうか（falseなら電子密度）
+            \param m 磁気量子数
+            \return 調整したσ
+        */
+        template <bool WF>
+        double Tune_step(std::int32_t m) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private static member variable (constant expression).
+        /*!
+            調整に使うマルコフ連鎖の数
+        */
+        static auto constexpr CHAINS = 8;
+
+        //! A private static member variable (constant expression).
+        /*!
+            MALAのσを調整するときの、目標とする採択率（目標の分布が滑らかな場合の最適値）
+        */
+        static auto constexpr MALAACCEPTANCE = 0.574;
+
+        //! A private static member variable (constant expression).
+        /*!
+            提案分布の標準偏差を調整するときの、目標とする採択率
+        */
+        static auto constexpr TARGETACCEPTANCE = 0.3;
+
+        //! A private static member variable (constant expression).
+        /*!
+            提案分布の標準偏差を調整する回数
+        */
+        static auto constexpr TUNEROUNDS = 32;
+
+        //! A private static member variable (constant expression).
+        /*!
+            提案分布の標準偏差を1回調整するまでに進めるステップ数（各チェーンCHAINSステップ）
+        */
+        static auto constexpr TUNESTEPS = 256;
+
+        //! A private static member variable (constant expression).
+        /*!
+            提案分布の標準偏差の調整に使う乱数列の番号（チャンクの番号とは重ならない）
+        */
+        static std::uint64_t constexpr TUNESTREAM = std::numeric_limits<std::uint64_t>::max();
+
+        //! A private member variable.
+        /*!
+            sigmas_とsteps_を保護するミューテックス
+        */
+        std::mutex mtx_;
+
+        //! A private member variable.
+        /*!
+            データオブジェクト
+        */
+        std::shared_ptr<getdata::GetData> const pgd_;
+
+        //! A private member variable.
+        /*!
+            磁気量子数ごとに調整した提案分布の標準偏差
+        */
+        std::map<std::int32_t, double> sigmas_;
+
+        //! A private member variable.
+        /*!
+            磁気量子数ごとに調整したMALAのσ
+        */
+        std::map<std::int32_t, double> steps_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A public constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        StepTuner() = delete;
+
+        //! A public copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        StepTuner(StepTuner const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        StepTuner & operator=(StepTuner const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _STEPTUNER_H_
@@ -0,0 +1,54 @@
+﻿/*! \file chunkscheduler.cpp
+    \brief チャンクをワークスティーリングでスレッドに割り当てるクラスの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "chunkscheduler.h"
+
+namespace utility {
+    // #region コンストラクタ
+
+    ChunkScheduler::ChunkScheduler(std::int32_t chunks, std::int32_t workers)
+        : queues_(workers)
+    {
+        for (auto c = 0; c < chunks; c++) {
+            queues_[c % workers].chunks.push_back(c);
+        }
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    std::optional<std::int32_t> ChunkScheduler::Next(std::int32_t worker)
+    {
+        auto const workers = static_cast<std::int32_t>(queues_.size());
+
+        // 自分のキューの前から取る
+        {
+            auto & q = queues_[worker];
+            std::lock_guard<std::mutex> lock(q.mtx);
+            if (!q.chunks.empty()) {
+                auto const c = q.chunks.front();
+                q.chunks.pop_front();
+                return c;
+            }
+        }
+
+        // 他のスレッドのキューの後ろから盗む
+        for (auto i = 1; i < workers; i++) {
+            auto & q = queues_[(worker + i) % workers];
+            std::lock_guard<std::mutex> lock(q.mtx);
+            if (!q.chunks.empty()) {
+                auto const c = q.chunks.back();
+                q.chunks.pop_back();
+                return c;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    // #endregion メンバ関数
+}
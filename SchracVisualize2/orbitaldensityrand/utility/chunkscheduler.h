@@ -0,0 +1,113 @@
+﻿/*! \file chunkscheduler.h
+    \brief チャンクをワークスティーリングでスレッドに割り当てるクラスの宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _CHUNKSCHEDULER_H_
+#define _CHUNKSCHEDULER_H_
+
+#pragma once
+
+#include <cstdint>  // for std::int32_t
+#include <deque>    // for std::deque
+#include <mutex>    // for std::mutex
+#include <optional> // for std::optional
+#include <vector>   // for std::vector
+
+namespace utility {
+    //! A class.
+    /*!
+        チャンクをワークスティーリングでスレッドに割り当てるクラス
+        最初はチャンクを各スレッドのキューにラウンドロビンで配り、自分のキューが空になったスレッドは他のスレッドのキューの後ろから盗む
+    */
+    class ChunkScheduler final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param chunks チャンクの数
+            \param workers スレッドの数
+        */
+        ChunkScheduler(std::int32_t chunks, std::int32_t workers);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~ChunkScheduler() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            次に処理するチャンクを返す
+            \param worker スレッドの番号
+            \return チャンクの番号（残りのチャンクがなければstd::nullopt）
+        */
+        std::optional<std::int32_t> Next(std::int32_t worker);
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A struct.
+        /*!
+            スレッドごとのチャンクのキュー
+        */
+        struct Queue {
+            //! A public member variable.
+            /*!
+                チャンクの番号
+            */
+            std::deque<std::int32_t> chunks;
+
+            //! A public member variable.
+            /*!
+                キューを保護するミューテックス
+            */
+            std::mutex mtx;
+        };
+
+        //! A private member variable.
+        /*!
+            スレッドごとのキュー
+        */
+        std::vector<Queue> queues_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A public constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        ChunkScheduler() = delete;
+
+        //! A public copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        ChunkScheduler(ChunkScheduler const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        ChunkScheduler & operator=(ChunkScheduler const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _CHUNKSCHEDULER_H_
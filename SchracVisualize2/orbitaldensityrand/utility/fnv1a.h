@@ -0,0 +1,62 @@
+﻿/*! \file fnv1a.h
+    \brief FNV-1a（64ビット）ハッシュ関数の宣言と実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _FNV1A_H_
+#define _FNV1A_H_
+
+#pragma once
+
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint64_t
+
+namespace utility {
+    //! A global variable (constant expression).
+    /*!
+        FNV-1a（64ビット）のハッシュ値の初期値
+    */
+    static std::uint64_t constexpr FNV1A_OFFSET_BASIS = 14695981039346656037ULL;
+
+    //! A global variable (constant expression).
+    /*!
+        FNV-1a（64ビット）の素数
+    */
+    static std::uint64_t constexpr FNV1A_PRIME = 1099511628211ULL;
+
+    //! A function.
+    /*!
+        バイト列のFNV-1a（64ビット）ハッシュ値を求める
+        \param data バイト列の先頭
+        \param bytes バイト列の長さ
+        \param hash これまでのハッシュ値（続けて計算する場合）
+        \return ハッシュ値
+    */
+    inline std::uint64_t Fnv1a(void const * data, std::size_t bytes, std::uint64_t hash = FNV1A_OFFSET_BASIS)
+    {
+        auto const p = static_cast<unsigned char const *>(data);
+        for (std::size_t i = 0; i < bytes; i++) {
+            hash ^= p[i];
+            hash *= FNV1A_PRIME;
+        }
+
+        return hash;
+    }
+
+    //! A function (template function).
+    /*!
+        値のバイト表現のFNV-1a（64ビット）ハッシュ値を求める
+        \tparam T 値の型（パディングを含まない型）
+        \param value 値
+        \param hash これまでのハッシュ値（続けて計算する場合）
+        \return ハッシュ値
+    */
+    template <typename T>
+    std::uint64_t Fnv1a(T const & value, std::uint64_t hash = FNV1A_OFFSET_BASIS)
+    {
+        return Fnv1a(&value, sizeof(T), hash);
+    }
+}
+
+#endif  // _FNV1A_H_
@@ -0,0 +1,35 @@
+﻿/*! \file safedelete.h
+    \brief 確保したメモリを安全に解放するクラスの宣言と実装
+
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _SAFEDELETE_H_
+#define _SAFEDELETE_H_
+
+#pragma once
+
+namespace utility {
+    template <typename T>
+    //! A struct.
+    /*!
+        確保したメモリを安全に解放するクラス
+        \tparam T 確保したメモリの型
+    */
+    struct Safe_Delete {
+        //! A public member function.
+        /*!
+            確保したメモリを安全に解放する
+            \param p 確保したメモリの先頭アドレス
+        */
+        void operator()(T * p) {
+            if (p) {
+                delete p;
+                p = nullptr;
+            }
+        }
+    };
+}
+
+#endif  // _SAFEDELETE_H_
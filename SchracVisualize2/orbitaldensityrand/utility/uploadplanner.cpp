@@ -0,0 +1,71 @@
+﻿/*! \file uploadplanner.cpp
+    \brief 頂点バッファへの転送範囲を決めるクラスの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "uploadplanner.h"
+
+namespace utility {
+    // #region コンストラクタ
+
+    UploadPlanner::UploadPlanner(std::size_t stride, std::size_t segmentsize)
+        :   Frame_bytes([this] { return framebytes_; }, nullptr),
+            Stride([this] { return stride_; }, [this](auto stride) {
+                if (stride != stride_) {
+                    stride_ = stride;
+                    Invalidate();
+                }
+                return stride; }),
+            Total_bytes([this] { return totalbytes_; }, nullptr),
+            Uploaded([this] { return uploaded_; }, nullptr),
+            segmentsize_(segmentsize),
+            stride_(stride)
+    {
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    UploadPlanner::Plan UploadPlanner::operator()(std::uint64_t generation, std::size_t capacity, std::size_t ready)
+    {
+        Plan plan{ false, 0, 0, 0 };
+
+        // 頂点数が変わったときだけ頂点バッファを作り直し、世代が変わったときは先頭から転送し直す
+        if (!valid_ || capacity != capacity_) {
+            plan.recreate = true;
+
+            // 世代が同じなら頂点数が変わっただけなので、大きさの変わらない先頭のセグメントは転送済みの頂点ごと残す
+            plan.firstsegment = valid_ && generation == generation_ ? std::min(capacity, capacity_) / segmentsize_ : 0;
+            capacity_ = capacity;
+            uploaded_ = std::min(uploaded_, plan.firstsegment * segmentsize_);
+            valid_ = true;
+        }
+
+        if (generation != generation_) {
+            generation_ = generation;
+            uploaded_ = 0;
+        }
+
+        ready = std::min(ready, capacity_);
+        if (ready > uploaded_) {
+            plan.begin = uploaded_;
+            plan.end = ready;
+            uploaded_ = ready;
+        }
+
+        framebytes_ = (plan.end - plan.begin) * stride_;
+        totalbytes_ += framebytes_;
+
+        return plan;
+    }
+
+    void UploadPlanner::Invalidate()
+    {
+        valid_ = false;
+        uploaded_ = 0;
+    }
+
+    // #endregion メンバ関数
+}
@@ -0,0 +1,237 @@
+﻿/*! \file uploadplanner.h
+    \brief 頂点バッファへの転送範囲を決めるクラスの宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _UPLOADPLANNER_H_
+#define _UPLOADPLANNER_H_
+
+#pragma once
+
+#include "property.h"
+#include <algorithm>    // for std::min
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t
+
+namespace utility {
+    //! A class.
+    /*!
+        生成済みの頂点のうち、まだ頂点バッファに転送していない範囲を決めるクラス
+        デバイスには依存せず、実際の転送は呼び出し側が行う
+        頂点バッファはsegmentsize個ずつのセグメントに分けて確保するので、1個のバッファのバイト数や描画する頂点数がUINTを超えない
+    */
+    class UploadPlanner final {
+        // #region 型エイリアス・構造体
+
+    public:
+        //! A struct.
+        /*!
+            1フレーム分の転送計画
+        */
+        struct Plan {
+            //! A public member variable.
+            /*!
+                頂点バッファを作り直す必要があるかどうか
+            */
+            bool recreate;
+
+            //! A public member variable.
+            /*!
+                転送する範囲の先頭の頂点のインデックス
+            */
+            std::size_t begin;
+
+            //! A public member variable.
+            /*!
+                転送する範囲の終端（含まない）の頂点のインデックス
+            */
+            std::size_t end;
+
+            //! A public member variable.
+            /*!
+                作り直す最初のセグメントの番号（それより前のセグメントの頂点バッファはそのまま使う）
+            */
+            std::size_t firstsegment;
+        };
+
+        // #endregion 型エイリアス・構造体
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param stride 頂点1個あたりのバイト数
+            \param segmentsize 頂点バッファ1個（セグメント）あたりの頂点数
+        */
+        UploadPlanner(std::size_t stride, std::size_t segmentsize);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~UploadPlanner() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            このフレームの転送計画を立て、転送したものとして記録する
+            \param generation 点群の世代（再生成のたびに変わる値、頂点数だけを変えた場合は変わらない）
+            \param capacity 頂点バッファに必要な頂点数
+            \param ready 生成済みで転送してよい先頭からの頂点数
+            \return このフレームの転送計画
+        */
+        Plan operator()(std::uint64_t generation, std::size_t capacity, std::size_t ready);
+
+        //! A public member function (template function).
+        /*!
+            頂点の範囲[begin, end)をセグメントごとに分けてfuncを呼ぶ
+            \param begin 範囲の先頭の頂点のインデックス
+            \param end 範囲の終端（含まない）の頂点のインデックス
+            \param func セグメントの番号と、セグメント内の範囲の先頭と終端を受け取る関数
+        */
+        template <typename FUNCTYPE>
+        void For_each_segment(std::size_t begin, std::size_t end, FUNCTYPE && func) const
+        {
+            while (begin < end) {
+                auto const segment = begin / segmentsize_;
+                auto const first = segment * segmentsize_;
+                auto const last = std::min(end, first + segmentsize_);
+                func(segment, begin - first, last - first);
+                begin = last;
+            }
+        }
+
+        //! A public member function.
+        /*!
+            次のフレームで頂点バッファを作り直し、先頭から転送し直すようにする
+        */
+        void Invalidate();
+
+        //! A public member function.
+        /*!
+            頂点数に対するセグメントの数を求める
+            \param size 頂点数
+            \return セグメントの数
+        */
+        std::size_t Segments(std::size_t size) const
+        {
+            return (size + segmentsize_ - 1) / segmentsize_;
+        }
+
+        // #endregion メンバ関数
+
+        // #region プロパティ
+
+        //! A property.
+        /*!
+            直前のフレームで転送したバイト数へのプロパティ
+        */
+        Property<std::size_t> const Frame_bytes;
+
+        //! A property.
+        /*!
+            頂点1個あたりのバイト数へのプロパティ（変えると頂点バッファを作り直す）
+        */
+        Property<std::size_t> Stride;
+
+        //! A property.
+        /*!
+            これまでに転送したバイト数の合計へのプロパティ
+        */
+        Property<std::size_t> const Total_bytes;
+
+        //! A property.
+        /*!
+            頂点バッファに転送済みの先頭からの頂点数へのプロパティ
+        */
+        Property<std::size_t> const Uploaded;
+
+        // #endregion プロパティ
+
+        // #region メンバ変数
+
+    private:
+        //! A private member variable.
+        /*!
+            現在の頂点バッファの頂点数
+        */
+        std::size_t capacity_ = 0;
+
+        //! A private member variable.
+        /*!
+            直前のフレームで転送したバイト数
+        */
+        std::size_t framebytes_ = 0;
+
+        //! A private member variable.
+        /*!
+            現在の頂点バッファに転送した点群の世代
+        */
+        std::uint64_t generation_ = 0;
+
+        //! A private member variable (constant).
+        /*!
+            頂点バッファ1個（セグメント）あたりの頂点数
+        */
+        std::size_t const segmentsize_;
+
+        //! A private member variable.
+        /*!
+            頂点1個あたりのバイト数
+        */
+        std::size_t stride_;
+
+        //! A private member variable.
+        /*!
+            これまでに転送したバイト数の合計
+        */
+        std::size_t totalbytes_ = 0;
+
+        //! A private member variable.
+        /*!
+            頂点バッファに転送済みの先頭からの頂点数
+        */
+        std::size_t uploaded_ = 0;
+
+        //! A private member variable.
+        /*!
+            頂点バッファが有効かどうか
+        */
+        bool valid_ = false;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A public constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        UploadPlanner() = delete;
+
+        //! A public copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        UploadPlanner(UploadPlanner const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        UploadPlanner & operator=(UploadPlanner const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _UPLOADPLANNER_H_
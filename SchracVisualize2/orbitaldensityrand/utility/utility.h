@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "safedelete.h"
 #include <array>        // for std::array
 #include <cstdint>      // for std::int32_t
 #include <optional>     // for std::optional
@@ -54,26 +55,6 @@ namespace utility {
         \return ファイル選択ダイアログの戻り値
     */
     BOOL showFileDialog(HWND hWnd, wchar_t * filepath, wchar_t * filename, wchar_t const * title, wchar_t const * defextension);
-
-    template <typename T>
-    //! A struct.
-    /*!
-        確保したメモリを安全に解放するクラス
-        \tparam T 確保したメモリの型
-    */
-    struct Safe_Delete {
-        //! A public member function.
-        /*!
-            確保したメモリを安全に解放する
-            \param p 確保したメモリの先頭アドレス
-        */
-        void operator()(T * p) {
-            if (p) {
-                delete p;
-                p = nullptr;
-            }
-        }
-    };
 }
 
 #endif  // _UTILITY_H_
@@ -0,0 +1,140 @@
+﻿/*! \file vertex.h
+    \brief 頂点構造体と、頂点の配列への読み取り専用のビューの宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _VERTEX_H_
+#define _VERTEX_H_
+
+#pragma once
+
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::int16_t
+
+namespace orbitaldensityrand {
+    //! A struct.
+    /*!
+        3次元ベクトルの構造体（DirectX::XMFLOAT3と同じメモリレイアウト）
+    */
+    struct Float3
+    {
+        float x;
+        float y;
+        float z;
+    };
+
+    //! A struct.
+    /*!
+        4次元ベクトルの構造体（DirectX::XMFLOAT4と同じメモリレイアウト）
+    */
+    struct Float4
+    {
+        float x;
+        float y;
+        float z;
+        float w;
+    };
+
+    //! A struct.
+    /*!
+        頂点構造体
+    */
+    struct SimpleVertex
+    {
+        Float3 Pos;
+        Float4 Color;
+    };
+
+    static_assert(sizeof(SimpleVertex) == 7 * sizeof(float), "SimpleVertexのレイアウトが頂点シェーダーの入力と一致しません");
+
+    //! A struct.
+    /*!
+        圧縮した頂点構造体（DXGI_FORMAT_R16G16B16A16_SNORMと同じメモリレイアウト）
+        x、y、zは座標をRmaxで割って32767倍した固定小数点数、wは波動関数の符号（±32767）
+    */
+    struct PackedVertex
+    {
+        std::int16_t x;
+        std::int16_t y;
+        std::int16_t z;
+        std::int16_t w;
+    };
+
+    static_assert(sizeof(PackedVertex) == 4 * sizeof(std::int16_t), "PackedVertexのレイアウトが頂点シェーダーの入力と一致しません");
+
+    //! A class (template class).
+    /*!
+        頂点の配列への読み取り専用のビュー（std::vectorとメモリマップした領域のどちらも指せる）
+        \tparam T 頂点の型
+    */
+    template <typename T>
+    class VertexView final {
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param data 頂点の配列の先頭
+            \param size 頂点数
+        */
+        VertexView(T const * data, std::size_t size) : data_(data), size_(size) {}
+
+        //! A public member function.
+        /*!
+            先頭の頂点へのポインタを返す
+            \return 先頭の頂点へのポインタ
+        */
+        T const * begin() const noexcept { return data_; }
+
+        //! A public member function.
+        /*!
+            頂点の配列の先頭を返す
+            \return 頂点の配列の先頭
+        */
+        T const * data() const noexcept { return data_; }
+
+        //! A public member function.
+        /*!
+            頂点がないかどうかを返す
+            \return 頂点がないかどうか
+        */
+        bool empty() const noexcept { return !size_; }
+
+        //! A public member function.
+        /*!
+            最後の頂点の次へのポインタを返す
+            \return 最後の頂点の次へのポインタ
+        */
+        T const * end() const noexcept { return data_ + size_; }
+
+        //! A public member function.
+        /*!
+            i番目の頂点を返す
+            \param i 頂点のインデックス
+            \return i番目の頂点
+        */
+        T const & operator[](std::size_t i) const noexcept { return data_[i]; }
+
+        //! A public member function.
+        /*!
+            頂点数を返す
+            \return 頂点数
+        */
+        std::size_t size() const noexcept { return size_; }
+
+    private:
+        //! A private member variable.
+        /*!
+            頂点の配列の先頭
+        */
+        T const * data_;
+
+        //! A private member variable.
+        /*!
+            頂点数
+        */
+        std::size_t size_;
+    };
+}
+
+#endif  // _VERTEX_H_
@@ -0,0 +1,178 @@
+﻿/*! \file angularcdftest.cpp
+    \brief 角度方向の累積分布関数の逆関数（directsampler::AngularCdf）のテストの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "test.h"
+#include "../orbitaldensityrand/directsampler/angularcdf.h"
+#include "../orbitaldensityrand/directsampler/cellutility.h"
+#include "../orbitaldensityrand/realylm/realylm.h"
+#include <algorithm>                            // for std::max, std::min
+#include <cmath>                                // for std::atan2, std::cos, std::fabs, std::sin, std::sqrt
+#include <cstdint>                              // for std::int32_t
+#include <cstdio>                               // for std::printf, std::snprintf
+#include <tuple>                                // for std::make_tuple
+#include <vector>                               // for std::vector
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::two_pi
+
+namespace test {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            ビンのcosθ方向の数
+        */
+        static auto constexpr NUBIN = 16;
+
+        //! A global variable (constant expression).
+        /*!
+            ビンのφ方向の数
+        */
+        static auto constexpr NPHIBIN = 32;
+
+        //! A global variable (constant expression).
+        /*!
+            確率密度を中点則で積分するときの、1つのビンの各方向の分割数
+        */
+        static auto constexpr NSUB = 128;
+
+        //! A global variable (constant expression).
+        /*!
+            逆関数を確かめる一様な座標の格子の、各方向の点の数
+        */
+        static auto constexpr NGRID = 64;
+
+        //! A global variable (constant expression).
+        /*!
+            補間した確率密度と真の確率密度の全変動距離の上限（AngularCdfのコメントに書いた値）
+        */
+        static auto constexpr INTERPOLATIONBOUND = 2.5E-3;
+
+        //! A global variable (constant expression).
+        /*!
+            写した点で補間した確率密度の累積分布関数を求め直したときの、元の一様な座標との差の上限（丸め誤差のみ）
+        */
+        static auto constexpr INVERSIONBOUND = 1.0E-9;
+
+        //! A function.
+        /*!
+            中点則で(cosθ, φ)の各ビンの確率を求める
+            \param density 確率密度（cosθとφの関数）
+            \return 各ビンの確率（cosθ方向のビンの番号 × NPHIBIN + φ方向のビンの番号の順、和が1になるよう正規化する）
+        */
+        template <typename FUNCTYPE>
+        std::vector<double> Bin_probabilities(FUNCTYPE const & density)
+        {
+            using namespace boost::math::constants;
+
+            std::vector<double> prob(NUBIN * NPHIBIN, 0.0);
+            auto total = 0.0;
+            for (auto i = 0; i < NUBIN * NSUB; i++) {
+                auto const u = -1.0 + 2.0 * (i + 0.5) / (NUBIN * NSUB);
+                for (auto j = 0; j < NPHIBIN * NSUB; j++) {
+                    auto const phi = two_pi<double>() * (j + 0.5) / (NPHIBIN * NSUB);
+                    auto const d = density(u, phi);
+                    prob[(i / NSUB) * NPHIBIN + j / NSUB] += d;
+                    total += d;
+                }
+            }
+
+            for (auto & p : prob) {
+                p /= total;
+            }
+
+            return prob;
+        }
+
+        //! A function.
+        /*!
+            2つの確率分布の全変動距離を求める
+            \param p 確率分布
+            \param q 確率分布
+            \return 全変動距離
+        */
+        double Total_variation(std::vector<double> const & p, std::vector<double> const & q)
+        {
+            auto sum = 0.0;
+            for (auto k = 0U; k < p.size(); k++) {
+                sum += std::fabs(p[k] - q[k]);
+            }
+
+            return 0.5 * sum;
+        }
+    }
+
+    bool Angular_cdf_test()
+    {
+        using namespace boost::math::constants;
+
+        auto passed = true;
+        for (auto const & [l, m] : { std::make_tuple(1, 0), std::make_tuple(2, 1), std::make_tuple(3, -2), std::make_tuple(4, 0), std::make_tuple(4, 3) }) {
+            for (auto const rho : { false, true }) {
+                directsampler::AngularCdf const cdf(l, m, rho);
+                realylm::RealYlm const ylm(l, m);
+
+                // 真の確率密度と、補間した確率密度のビンの確率
+                auto const exact = Bin_probabilities([&ylm, rho](double u, double phi) {
+                    auto const s = std::sqrt(1.0 - u * u);
+                    return directsampler::Weight(ylm(s * std::cos(phi), s * std::sin(phi), u), rho);
+                });
+                auto const interpolated = Bin_probabilities([&cdf](double u, double phi) { return cdf.Density(u, phi); });
+
+                // 補間した確率密度は格子のセルの中で双1次式なので、セルをまたがない中点則で厳密に積分できる
+                auto const hu = 2.0 / directsampler::AngularCdf::NCOSTHETA;
+                auto const hphi = two_pi<double>() / directsampler::AngularCdf::NPHI;
+                auto const cumphi = [&cdf, hphi](double u, double phi) {
+                    auto const j = std::min(static_cast<std::int32_t>(phi / hphi), directsampler::AngularCdf::NPHI - 1);
+                    auto sum = (phi - j * hphi) * cdf.Density(u, 0.5 * (j * hphi + phi));
+                    for (auto k = 0; k < j; k++) {
+                        sum += hphi * cdf.Density(u, (k + 0.5) * hphi);
+                    }
+
+                    return sum;
+                };
+
+                std::vector<double> cumu(directsampler::AngularCdf::NCOSTHETA + 1, 0.0);
+                for (auto i = 0; i < directsampler::AngularCdf::NCOSTHETA; i++) {
+                    cumu[i + 1] = cumu[i] + hu * cumphi(-1.0 + (i + 0.5) * hu, two_pi<double>());
+                }
+
+                // 一様な座標の格子を写し、写した点での周辺分布と条件付き分布の累積分布関数が元の座標に戻るかを確かめる
+                std::vector<double> u0(NGRID), u1(NGRID), x(NGRID), y(NGRID), z(NGRID), val(NGRID);
+                auto inversion = 0.0;
+                for (auto i = 0; i < NGRID; i++) {
+                    for (auto j = 0; j < NGRID; j++) {
+                        u0[j] = (i + 0.5) / NGRID;
+                        u1[j] = (j + 0.5) / NGRID;
+                    }
+
+                    cdf(u0.data(), u1.data(), x.data(), y.data(), z.data(), val.data(), NGRID);
+                    for (auto j = 0; j < NGRID; j++) {
+                        auto const u = z[j];
+                        auto const iu = std::min(static_cast<std::int32_t>((u + 1.0) / hu), directsampler::AngularCdf::NCOSTHETA - 1);
+                        auto const ul = -1.0 + iu * hu;
+                        auto const marginal = cumu[iu] + (u - ul) * cumphi(0.5 * (ul + u), two_pi<double>());
+
+                        auto phi = std::atan2(y[j], x[j]);
+                        phi = phi < 0.0 ? phi + two_pi<double>() : phi;
+                        auto const conditional = cumphi(u, phi) / cumphi(u, two_pi<double>());
+
+                        inversion = std::max(inversion, std::max(std::fabs(marginal / cumu.back() - u0[j]), std::fabs(conditional - u1[j])));
+                    }
+                }
+
+                auto const bias = Total_variation(exact, interpolated);
+                std::printf("  l = %d, m = %2d, %3s: TV(interpolated, exact) = %.2e, max |F(mapped) - uniform| = %.2e\n",
+                    l, m, rho ? "rho" : "wf", bias, inversion);
+
+                char what[128];
+                std::snprintf(what, sizeof(what), "l = %d, m = %d, %s: interpolation bias within %.0e", l, m, rho ? "rho" : "wf", INTERPOLATIONBOUND);
+                passed = Check(bias <= INTERPOLATIONBOUND, what) && passed;
+                std::snprintf(what, sizeof(what), "l = %d, m = %d, %s: mapped point inverts the interpolated cdf within %.0e", l, m, rho ? "rho" : "wf", INVERSIONBOUND);
+                passed = Check(inversion <= INVERSIONBOUND, what) && passed;
+            }
+        }
+
+        return passed;
+    }
+}
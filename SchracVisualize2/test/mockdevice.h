@@ -0,0 +1,171 @@
+﻿/*! \file mockdevice.h
+    \brief 頂点バッファの作成と部分転送だけを真似するデバイスのクラスの宣言と実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _MOCKDEVICE_H_
+#define _MOCKDEVICE_H_
+
+#pragma once
+
+#include "../orbitaldensityrand/utility/uploadplanner.h"
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::int32_t, std::uint64_t
+#include <cstring>  // for std::memcpy
+#include <vector>   // for std::vector
+
+namespace test {
+    //! A class.
+    /*!
+        セグメントごとの頂点バッファの作成と部分転送だけを真似するデバイス
+        GUIのRenderPointと同じ手順でutility::UploadPlannerの転送計画を実行する
+    */
+    class MockDevice final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param stride 頂点1個あたりのバイト数
+            \param segmentsize 頂点バッファ1個（セグメント）あたりの頂点数
+        */
+        MockDevice(std::size_t stride, std::size_t segmentsize)
+            : segmentsize_(segmentsize), stride_(stride)
+        {
+        }
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~MockDevice() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            頂点バッファを作る
+            \param segment セグメントの番号
+            \param bytes 頂点バッファのバイト数
+        */
+        void CreateBuffer(std::size_t segment, std::size_t bytes)
+        {
+            if (buffers.size() <= segment) {
+                buffers.resize(segment + 1);
+            }
+            buffers[segment].assign(bytes, 0);
+            creations++;
+        }
+
+        //! A public member function.
+        /*!
+            1フレーム分の転送計画を立て、GUIのRenderPointと同じく頂点バッファを作り直して転送する
+            \param planner 転送計画を立てるオブジェクト
+            \param generation 点群の世代
+            \param data 頂点の配列の先頭
+            \param capacity 頂点バッファに必要な頂点数
+            \param ready 生成済みで転送してよい先頭からの頂点数
+            \return このフレームの転送計画
+        */
+        utility::UploadPlanner::Plan Upload(utility::UploadPlanner & planner, std::uint64_t generation, void const * data, std::size_t capacity, std::size_t ready)
+        {
+            auto const plan = planner(generation, capacity, ready);
+            if (plan.recreate) {
+                buffers.resize(planner.Segments(capacity));
+                planner.For_each_segment(plan.firstsegment * segmentsize_, capacity, [&](std::size_t segment, std::size_t begin, std::size_t end) {
+                    CreateBuffer(segment, stride_ * (end - begin));
+                });
+            }
+
+            framebytes = 0;
+            planner.For_each_segment(plan.begin, plan.end, [&](std::size_t segment, std::size_t begin, std::size_t end) {
+                UpdateSubresource(segment, stride_ * begin, static_cast<unsigned char const *>(data) + stride_ * (segment * segmentsize_ + begin), stride_ * (end - begin));
+            });
+
+            return plan;
+        }
+
+        //! A public member function.
+        /*!
+            頂点バッファの一部を書き換える
+            \param segment セグメントの番号
+            \param offset 書き換える先頭のバイト位置
+            \param src 転送元
+            \param bytes 転送するバイト数
+        */
+        void UpdateSubresource(std::size_t segment, std::size_t offset, void const * src, std::size_t bytes)
+        {
+            std::memcpy(buffers[segment].data() + offset, src, bytes);
+            framebytes += bytes;
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A public member variable.
+        /*!
+            セグメントごとの頂点バッファの中身
+        */
+        std::vector<std::vector<unsigned char>> buffers;
+
+        //! A public member variable.
+        /*!
+            これまでに作った頂点バッファの数
+        */
+        std::int32_t creations = 0;
+
+        //! A public member variable.
+        /*!
+            直前のUpload()で実際に転送したバイト数
+        */
+        std::size_t framebytes = 0;
+
+    private:
+        //! A private member variable (constant).
+        /*!
+            頂点バッファ1個（セグメント）あたりの頂点数
+        */
+        std::size_t const segmentsize_;
+
+        //! A private member variable (constant).
+        /*!
+            頂点1個あたりのバイト数
+        */
+        std::size_t const stride_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A public constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        MockDevice() = delete;
+
+        //! A public copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        MockDevice(MockDevice const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        MockDevice & operator=(MockDevice const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _MOCKDEVICE_H_
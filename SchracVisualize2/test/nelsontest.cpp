@@ -0,0 +1,77 @@
+﻿/*! \file nelsontest.cpp
+    \brief Nelsonの確率力学による点群生成のテストの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "test.h"
+#include "../benchmark/benchmark.h"
+#include "../orbitaldensityrand/orbitaldensityrand.h"
+#include <chrono>   // for std::chrono
+#include <cmath>    // for std::isfinite
+#include <cstdint>  // for std::int32_t
+#include <cstdio>   // for std::printf
+#include <memory>   // for std::make_shared
+#include <thread>   // for std::this_thread
+#include <tuple>    // for std::make_tuple
+
+namespace test {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            生成する頂点数
+        */
+        static auto constexpr NVERTEX = 20000;
+
+        //! A global variable (constant expression).
+        /*!
+            生成が終わるまで待つ時間の上限（秒）
+        */
+        static auto constexpr TIMEOUT = 30.0;
+    }
+
+    bool Nelson_test()
+    {
+        using namespace orbitaldensityrand;
+
+        auto passed = true;
+
+        // 2pzや3dxzでは初期座標(1, 1, 0)がz = 0の節の上にあるので、そこから抜け出せずに止まらないことを確かめる
+        for (auto const & [n, l, m] : { std::make_tuple(2, 1, 0), std::make_tuple(3, 2, 0), std::make_tuple(3, 2, 1) }) {
+            for (auto const rho : { false, true }) {
+                OrbitalDensityRand odr(std::make_shared<getdata::GetData>(benchmark::Hydrogen_data_file(n, l, rho)));
+                odr.Vertexsize(NVERTEX);
+                odr.Seed(1U);
+
+                auto const start = std::chrono::steady_clock::now();
+                odr(m, OrbitalDensityRand::Normal_Nelson_type::NELSON);
+                while (!odr.Complete && std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < TIMEOUT) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+
+                auto const complete = static_cast<bool>(odr.Complete);
+                odr.Thread_end(true);
+                odr.Pth()->join();
+
+                std::printf("  %d%c %3s (m = %d): %s\n", n, "spdf"[l], rho ? "rho" : "wf", m, complete ? "completed" : "timed out");
+                passed = Check(complete, "NELSON finishes when it starts on a node") && passed;
+                if (!complete) {
+                    continue;
+                }
+
+                auto finite = true;
+                auto offnode = 0;
+                for (auto const & v : odr.Vertex()) {
+                    finite = finite && std::isfinite(v.Pos.x) && std::isfinite(v.Pos.y) && std::isfinite(v.Pos.z);
+                    offnode += v.Pos.z != 0.0f ? 1 : 0;
+                }
+
+                passed = Check(odr.Vertex().size() == NVERTEX, "NELSON fills every vertex") && passed;
+                passed = Check(finite, "NELSON vertices are finite") && passed;
+                passed = Check(offnode > NVERTEX / 2, "NELSON walker leaves the z = 0 nodal plane") && passed;
+            }
+        }
+
+        return passed;
+    }
+}
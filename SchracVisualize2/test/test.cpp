@@ -0,0 +1,53 @@
+﻿/*! \file test.cpp
+    \brief テストプログラムのメイン関数
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "test.h"
+#include <cstdio>       // for std::printf
+#include <cstdlib>      // for EXIT_FAILURE, EXIT_SUCCESS
+#include <functional>   // for std::function
+#include <iostream>     // for std::cerr
+#include <map>          // for std::map
+#include <string>       // for std::string
+
+namespace test {
+    bool Check(bool condition, char const * what)
+    {
+        if (!condition) {
+            std::printf("  FAILED: %s\n", what);
+        }
+
+        return condition;
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    std::map<std::string, std::function<bool()>> const tests = {
+        { "angularcdf", test::Angular_cdf_test },
+        { "nelson", test::Nelson_test },
+        { "uploadplanner", test::Upload_planner_test }
+    };
+
+    if (argc > 2 || (argc == 2 && tests.find(argv[1]) == tests.end() && std::string(argv[1]) != "all")) {
+        std::cerr << "Usage: " << argv[0] << " [all";
+        for (auto const & [name, func] : tests) {
+            std::cerr << '|' << name;
+        }
+        std::cerr << "]\n";
+        return EXIT_FAILURE;
+    }
+
+    auto failed = 0;
+    for (auto const & [name, func] : tests) {
+        if (argc == 1 || std::string(argv[1]) == "all" || name == argv[1]) {
+            auto const passed = func();
+            std::printf("%s: %s\n", name.c_str(), passed ? "passed" : "FAILED");
+            failed += passed ? 0 : 1;
+        }
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
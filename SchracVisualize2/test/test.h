@@ -0,0 +1,44 @@
+﻿/*! \file test.h
+    \brief テスト関数の宣言
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _TEST_H_
+#define _TEST_H_
+
+#pragma once
+
+namespace test {
+    //! A function.
+    /*!
+        角度方向の累積分布関数の逆関数（directsampler::AngularCdf）の、補間による偏りと逆関数の正しさのテスト
+        \return すべての確認に成功したかどうか
+    */
+    bool Angular_cdf_test();
+
+    //! A function.
+    /*!
+        条件が成り立たなければ、失敗したことを表示する
+        \param condition 確認する条件
+        \param what 確認している内容
+        \return 条件が成り立ったかどうか
+    */
+    bool Check(bool condition, char const * what);
+
+    //! A function.
+    /*!
+        Nelsonの確率力学による点群生成（初期座標が節の上にある場合）のテスト
+        \return すべての確認に成功したかどうか
+    */
+    bool Nelson_test();
+
+    //! A function.
+    /*!
+        頂点バッファへの転送計画（utility::UploadPlanner）のテスト
+        \return すべての確認に成功したかどうか
+    */
+    bool Upload_planner_test();
+}
+
+#endif  // _TEST_H_
@@ -0,0 +1,146 @@
+﻿/*! \file uploadplannertest.cpp
+    \brief 頂点バッファへの転送計画（utility::UploadPlanner）のテストの実装
+
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "mockdevice.h"
+#include "test.h"
+#include "../orbitaldensityrand/utility/uploadplanner.h"
+#include <algorithm>    // for std::min
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t, std::uint64_t
+#include <cstring>      // for std::memcmp
+#include <vector>       // for std::vector
+
+namespace test {
+    namespace {
+        //! A global variable (constant expression).
+        /*!
+            頂点バッファ1個（セグメント）あたりの頂点数（境界をまたぐ場合を少ない頂点数で試せるように小さくする）
+        */
+        static std::size_t constexpr SEGMENTSIZE = 4;
+
+        //! A global variable (constant expression).
+        /*!
+            頂点1個あたりのバイト数
+        */
+        static std::size_t constexpr STRIDE = sizeof(std::uint32_t);
+
+        //! A function.
+        /*!
+            世代と番号から値の決まる頂点の配列を作る
+            \param generation 点群の世代
+            \param size 頂点数
+            \return 頂点の配列
+        */
+        std::vector<std::uint32_t> Make_vertices(std::uint64_t generation, std::size_t size)
+        {
+            std::vector<std::uint32_t> vertices(size);
+            for (auto i = 0U; i < size; i++) {
+                vertices[i] = static_cast<std::uint32_t>(generation * 1000 + i);
+            }
+
+            return vertices;
+        }
+
+        //! A function.
+        /*!
+            セグメントの大きさが頂点数に合っていて、セグメントをつなげた先頭のready個の頂点が配列と一致するかどうか
+            \param device デバイス
+            \param vertices 頂点の配列
+            \param ready 転送済みのはずの頂点数
+            \return 一致するかどうか
+        */
+        bool Matches(MockDevice const & device, std::vector<std::uint32_t> const & vertices, std::size_t ready)
+        {
+            std::vector<unsigned char> concatenated;
+            for (auto i = 0U; i < device.buffers.size(); i++) {
+                auto const expected = STRIDE * (std::min(vertices.size(), (i + 1) * SEGMENTSIZE) - i * SEGMENTSIZE);
+                if (device.buffers[i].size() != expected) {
+                    return false;
+                }
+                concatenated.insert(concatenated.end(), device.buffers[i].begin(), device.buffers[i].end());
+            }
+
+            return concatenated.size() == STRIDE * vertices.size() && !std::memcmp(concatenated.data(), vertices.data(), STRIDE * ready);
+        }
+    }
+
+    bool Upload_planner_test()
+    {
+        MockDevice device(STRIDE, SEGMENTSIZE);
+        utility::UploadPlanner planner(STRIDE, SEGMENTSIZE);
+
+        auto passed = true;
+        std::size_t totalbytes = 0;
+
+        // 1フレーム分の転送を行い、計画どおりのバイト数だけ転送されたことを確かめる
+        auto const frame = [&](std::uint64_t generation, std::size_t capacity, std::size_t ready) {
+            auto const vertices = Make_vertices(generation, capacity);
+            auto const plan = device.Upload(planner, generation, vertices.data(), capacity, ready);
+            totalbytes += device.framebytes;
+            passed = Check(planner.Frame_bytes == device.framebytes, "Frame_bytes equals the bytes sent to the device") && passed;
+            passed = Check(planner.Total_bytes == totalbytes, "Total_bytes equals the sum of the bytes sent to the device") && passed;
+            passed = Check(planner.Uploaded == std::min(ready, capacity), "Uploaded equals the ready vertex count") && passed;
+            passed = Check(Matches(device, vertices, planner.Uploaded), "segments hold the uploaded vertices") && passed;
+            return plan;
+        };
+
+        // 最初のフレームでは全セグメントを作り、生成済みの範囲だけを転送する
+        auto plan = frame(1, 10, 5);
+        passed = Check(plan.recreate && plan.firstsegment == 0, "first frame creates every segment") && passed;
+        passed = Check(device.creations == 3 && device.buffers.size() == 3, "10 vertices take 3 segments") && passed;
+        passed = Check(plan.begin == 0 && plan.end == 5 && planner.Frame_bytes == 5 * STRIDE, "first frame uploads the ready prefix") && passed;
+
+        // 生成が進んだ分だけを、セグメントの境界をまたいで転送する
+        plan = frame(1, 10, 9);
+        passed = Check(!plan.recreate && device.creations == 3, "growing ready count only updates") && passed;
+        passed = Check(plan.begin == 5 && plan.end == 9 && planner.Frame_bytes == 4 * STRIDE, "only newly ready vertices are uploaded") && passed;
+
+        // 新しい頂点がなければ何も転送しない
+        plan = frame(1, 10, 9);
+        passed = Check(!plan.recreate && plan.begin == plan.end && planner.Frame_bytes == 0, "idle frame uploads nothing") && passed;
+
+        frame(1, 10, 10);
+
+        // 世代が変わったら、頂点バッファは作り直さずに先頭から転送し直す
+        plan = frame(2, 10, 3);
+        passed = Check(!plan.recreate && device.creations == 3, "new generation keeps the buffers") && passed;
+        passed = Check(plan.begin == 0 && plan.end == 3 && planner.Frame_bytes == 3 * STRIDE, "new generation uploads from the start") && passed;
+
+        frame(2, 10, 10);
+
+        // 頂点数だけを増やした場合は、大きさの変わらない先頭のセグメントと転送済みの頂点を残す
+        plan = frame(2, 14, 10);
+        passed = Check(plan.recreate && plan.firstsegment == 2, "growing recreates only the segments from the old last one") && passed;
+        passed = Check(device.creations == 5 && device.buffers.size() == 4, "growing to 14 vertices creates segments 2 and 3") && passed;
+        passed = Check(plan.begin == 8 && plan.end == 10 && planner.Frame_bytes == 2 * STRIDE, "growing re-uploads only the recreated segment") && passed;
+
+        frame(2, 14, 14);
+
+        // 頂点数を減らした場合は、途中で切れるセグメントだけを作り直す
+        plan = frame(2, 6, 6);
+        passed = Check(plan.recreate && plan.firstsegment == 1, "shrinking recreates the segment cut in the middle") && passed;
+        passed = Check(device.creations == 6 && device.buffers.size() == 2, "shrinking to 6 vertices leaves 2 segments") && passed;
+        passed = Check(plan.begin == 4 && plan.end == 6 && planner.Frame_bytes == 2 * STRIDE, "shrinking re-uploads only the recreated segment") && passed;
+
+        // 頂点数と世代が同時に変わったら、すべて作り直して先頭から転送する
+        plan = frame(3, 9, 9);
+        passed = Check(plan.recreate && plan.firstsegment == 0 && device.creations == 9, "new generation with a new size recreates every segment") && passed;
+        passed = Check(plan.begin == 0 && plan.end == 9, "new generation with a new size uploads everything") && passed;
+
+        // Invalidate()の後は、同じ世代と頂点数でもすべて作り直して転送し直す
+        planner.Invalidate();
+        plan = frame(3, 9, 9);
+        passed = Check(plan.recreate && plan.firstsegment == 0 && device.creations == 12, "Invalidate() recreates every segment") && passed;
+        passed = Check(plan.begin == 0 && plan.end == 9 && planner.Frame_bytes == 9 * STRIDE, "Invalidate() uploads everything again") && passed;
+
+        // 頂点の形式を同じ値に設定し直しても作り直さない（GUIは毎フレーム設定する）
+        planner.Stride = STRIDE;
+        plan = frame(3, 9, 9);
+        passed = Check(!plan.recreate && planner.Frame_bytes == 0, "setting the same stride keeps the buffers") && passed;
+
+        return passed;
+    }
+}